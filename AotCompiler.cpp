@@ -0,0 +1,430 @@
+/**
+ * @brief  CHIP8 EMULATOR PROJECT
+ * @Author esantiago
+ * @date   October, 2026
+ *
+ * @description: Ahead-of-time ROM compiler source file
+ *
+ * Every statement is the C++ form of the interpreter handler for the
+ * same opcode (see Chip8::op8xy4 and friends), in the same order, so VF
+ * being one of the operands behaves exactly the same.
+ */
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <ctype.h>
+#include "AotCompiler.h"
+#include "Disasm.h"
+
+using namespace std;
+
+
+static const char *const REG_NAMES[16] =
+{
+  "v0", "v1", "v2", "v3", "v4", "v5", "v6", "v7",
+  "v8", "v9", "va", "vb", "vc", "vd", "ve", "vf"
+};
+
+
+// opcodes the interpreter runs without stalling (see Chip8::decodeOpcode)
+static bool compilable( unsigned short opcode)
+{
+  unsigned int n = opcode & 0x000F;
+  unsigned int kk = opcode & 0x00FF;
+
+  switch(opcode & 0xF000)
+  {
+    case 0x0000: return n == 0x0 || n == 0xE;
+    case 0x8000: return n <= 0x7 || n == 0xE;
+    case 0xE000: return kk == 0x9E || kk == 0xA1;
+    case 0xF000:
+      switch(kk)
+      {
+        case 0x07: case 0x15: case 0x18: case 0x1E:
+        case 0x29: case 0x33: case 0x55: case 0x65: return true;
+      }
+      return false; // Fx0A waits for a key in the interpreter
+  }
+  return true;
+}
+
+
+// the instruction does not simply continue at pc + 2 without a store
+static bool endsBlock( unsigned short opcode)
+{
+  switch(opcode & 0xF000)
+  {
+    case 0x0000: return (opcode & 0x000F) == 0xE;
+    case 0x1000:
+    case 0x2000:
+    case 0x3000:
+    case 0x4000:
+    case 0x5000:
+    case 0x9000:
+    case 0xB000:
+    case 0xE000: return true;
+    case 0xF000: return (opcode & 0x00FF) == 0x33 || (opcode & 0x00FF) == 0x55;
+  }
+  return false;
+}
+
+
+static bool isSkip( unsigned short opcode)
+{
+  switch(opcode & 0xF000)
+  {
+    case 0x3000:
+    case 0x4000:
+    case 0x5000:
+    case 0x9000:
+    case 0xE000: return true;
+  }
+  return false;
+}
+
+
+AotCompiler::AotCompiler()
+  : max_length(8), block_count(0), instruction_count(0), image(NULL), size(0),
+    read_regs(0), written_regs(0), uses_i(false), writes_i(false), uses_memory(false)
+{
+}
+
+
+void AotCompiler::append( string &out, const char *format, ...)
+{
+  char line[256];
+  va_list args;
+  va_start( args, format);
+  int length = vsnprintf( line, sizeof(line), format, args);
+  va_end( args);
+  if (length > 0)
+    out.append( line, (size_t)length < sizeof(line) ? length : sizeof(line) - 1);
+}
+
+
+unsigned short AotCompiler::opcodeAt( unsigned int address) const
+{
+  return image[address - 0x200] << 8 | image[address - 0x200 + 1];
+}
+
+
+bool AotCompiler::compiled( unsigned int address) const
+{
+  return cfg.instructionAt( address) && address + 1 < 0x200 + size && compilable( opcodeAt( address));
+}
+
+
+// a block starts wherever control can arrive other than by falling
+// through from the instruction before it
+void AotCompiler::findLeaders()
+{
+  leader.assign( size, false);
+
+  for (unsigned int address = 0x200; address < 0x200 + size; ++address)
+  {
+    if (!compiled( address))
+      continue;
+
+    bool fallen_into = address >= 0x202 && cfg.instructionAt( address - 2) &&
+                       compiled( address - 2) && !endsBlock( opcodeAt( address - 2));
+    bool skipped_to = address >= 0x204 && cfg.instructionAt( address - 4) &&
+                      isSkip( opcodeAt( address - 4));
+
+    leader[address - 0x200] = address == 0x200 || cfg.branchTarget( address) || !fallen_into || skipped_to;
+  }
+}
+
+
+const char *AotCompiler::reg( unsigned int index, bool write)
+{
+  read_regs |= 1u << index;
+  if (write)
+    written_regs |= 1u << index;
+  return REG_NAMES[index];
+}
+
+
+void AotCompiler::useI( bool write)
+{
+  uses_i = true;
+  writes_i = writes_i || write;
+}
+
+
+// appends the statements of one instruction to 'body'; terminators set
+// 'next_pc' to the expression pc ends up with
+void AotCompiler::emitInstruction( unsigned int address, unsigned short opcode, string &next_pc)
+{
+  unsigned int x = (opcode & 0x0F00) >> 8;
+  unsigned int y = (opcode & 0x00F0) >> 4;
+  unsigned int kk = opcode & 0x00FF;
+  unsigned int nnn = opcode & 0x0FFF;
+  unsigned int n = opcode & 0x000F;
+  char mnemonic[32];
+  char skip[64];
+
+  append( body, "  // 0x%03X  %04X  %s\n", address, opcode, disassemble( opcode, mnemonic, sizeof(mnemonic)));
+
+  skip[0] = '\0';
+  switch(opcode & 0xF000)
+  {
+    case 0x0000:
+      if (n == 0x0)
+        append( body, "  Chip8Aot::clear( c);\n");
+      else
+        next_pc = "Chip8Aot::ret( c) + 2";
+    break;
+
+    case 0x1000:
+      append( next_pc, "0x%03X", nnn);
+    break;
+
+    case 0x2000:
+      append( body, "  Chip8Aot::call( c, 0x%03X);\n", address);
+      append( next_pc, "0x%03X", nnn);
+    break;
+
+    case 0x3000: snprintf( skip, sizeof(skip), "%s == 0x%02X", reg( x, false), kk); break;
+    case 0x4000: snprintf( skip, sizeof(skip), "%s != 0x%02X", reg( x, false), kk); break;
+    case 0x5000: snprintf( skip, sizeof(skip), "%s == %s", reg( x, false), reg( y, false)); break;
+    case 0x9000: snprintf( skip, sizeof(skip), "%s != %s", reg( x, false), reg( y, false)); break;
+
+    case 0x6000: append( body, "  %s = 0x%02X;\n", reg( x, true), kk); break;
+    case 0x7000: append( body, "  %s += 0x%02X;\n", reg( x, true), kk); break;
+
+    case 0x8000:
+      switch(n)
+      {
+        case 0x0: append( body, "  %s = %s;\n", reg( x, true), reg( y, false)); break;
+        case 0x1: append( body, "  %s |= %s;\n", reg( x, true), reg( y, false)); break;
+        case 0x2: append( body, "  %s &= %s;\n", reg( x, true), reg( y, false)); break;
+        case 0x3: append( body, "  %s ^= %s;\n", reg( x, true), reg( y, false)); break;
+
+        case 0x4:
+        case 0x5:
+        case 0x7:
+        {
+          const char *vx = reg( x, true);
+          const char *vy = reg( y, false);
+          const char *vf = reg( 0xF, true);
+          if (n == 0x4)
+            append( body, "  %s = (%s > (0xFF - %s)) ? 1 : 0;\n  %s += %s;\n", vf, vy, vx, vx, vy);
+          else if (n == 0x5)
+            append( body, "  %s = (%s > %s) ? 0 : 1;\n  %s -= %s;\n", vf, vy, vx, vx, vy);
+          else
+            append( body, "  %s = (%s > %s) ? 0 : 1;\n  %s = %s - %s;\n", vf, vx, vy, vx, vy, vx);
+        }
+        break;
+
+        case 0x6:
+        case 0xE:
+        {
+          const char *vx = reg( x, true);
+          const char *vf = reg( 0xF, true);
+          if (n == 0x6)
+            append( body, "  %s = %s & 0x1;\n  %s >>= 1;\n", vf, vx, vx);
+          else
+            append( body, "  %s = %s >> 7;\n  %s <<= 1;\n", vf, vx, vx);
+        }
+        break;
+      }
+    break;
+
+    case 0xA000:
+      useI( true);
+      append( body, "  i = 0x%03X;\n", nnn);
+    break;
+
+    case 0xB000:
+      append( next_pc, "0x%03X + %s", nnn, reg( 0, false));
+    break;
+
+    case 0xC000:
+      append( body, "  %s = Chip8Aot::random( c) & 0x%02X;\n", reg( x, true), kk);
+    break;
+
+    case 0xD000:
+      useI( false);
+      append( body, "  %s = Chip8Aot::draw( c, i, %s, %s, %u);\n", reg( 0xF, true), reg( x, false), reg( y, false), n);
+    break;
+
+    case 0xE000:
+      snprintf( skip, sizeof(skip), kk == 0x9E ? "%s < 16 && c.key[%s] != 0" : "%s >= 16 || c.key[%s] == 0",
+                reg( x, false), reg( x, false));
+    break;
+
+    case 0xF000:
+      switch(kk)
+      {
+        case 0x07: append( body, "  %s = Chip8Aot::delayTimer( c);\n", reg( x, true)); break;
+        case 0x15: append( body, "  Chip8Aot::delayTimer( c) = %s;\n", reg( x, false)); break;
+        case 0x18: append( body, "  Chip8Aot::soundTimer( c) = %s;\n", reg( x, false)); break;
+
+        case 0x1E:
+        {
+          useI( true);
+          const char *vx = reg( x, false);
+          append( body, "  %s = (i + %s > 0xFFF) ? 1 : 0;\n", reg( 0xF, true), vx);
+          append( body, "  i += %s;\n", vx);
+        }
+        break;
+
+        case 0x29:
+          useI( true);
+          append( body, "  i = %s * 0x5 + 0x50;\n", reg( x, false));
+        break;
+
+        case 0x33:
+        {
+          useI( false);
+          const char *vx = reg( x, false);
+          append( body, "  Chip8Aot::store( c, i, %s / 100);\n", vx);
+          append( body, "  Chip8Aot::store( c, i + 1, (%s %% 100) / 10);\n", vx);
+          append( body, "  Chip8Aot::store( c, i + 2, %s %% 10);\n", vx);
+          append( next_pc, "0x%03X", address + 2);
+        }
+        break;
+
+        case 0x55:
+          useI( true);
+          for (unsigned int r = 0; r <= x; ++r)
+            append( body, "  Chip8Aot::store( c, i + %u, %s);\n", r, reg( r, false));
+          append( body, "  i += %u;\n", x + 1);
+          append( next_pc, "0x%03X", address + 2);
+        break;
+
+        case 0x65:
+          useI( true);
+          uses_memory = true;
+          for (unsigned int r = 0; r <= x; ++r)
+            append( body, "  %s = memory[(i + %u) & 0xFFF];\n", reg( r, true), r);
+          append( body, "  i += %u;\n", x + 1);
+        break;
+      }
+    break;
+  }
+
+  if (skip[0] != '\0')
+    append( next_pc, "(%s) ? 0x%03X : 0x%03X", skip, address + 4, address + 2);
+}
+
+
+// translates the block at 'start' into one function, returns its
+// length in instructions
+size_t AotCompiler::emitBlock( unsigned int start)
+{
+  body.clear();
+  read_regs = written_regs = 0;
+  uses_i = writes_i = uses_memory = false;
+
+  string next_pc;
+  unsigned int address = start;
+  size_t length = 0;
+  while (true)
+  {
+    unsigned short opcode = opcodeAt( address);
+    emitInstruction( address, opcode, next_pc);
+    ++length;
+    address += 2;
+
+    if (!next_pc.empty())
+      break;
+
+    // falls through into code that is a block of its own or is not compiled
+    if (!compiled( address) || leader[address - 0x200] || length == max_length)
+    {
+      if (compiled( address))
+        leader[address - 0x200] = true;
+      append( next_pc, "0x%03X", address);
+      break;
+    }
+  }
+
+  append( text, "\nvoid block_%03X( Chip8 &c)\n{\n", start);
+  if (read_regs != 0)
+  {
+    append( text, "  unsigned char *V = Chip8Aot::V( c);\n");
+    for (unsigned int r = 0; r < 16; ++r)
+    {
+      if (read_regs & (1u << r))
+        append( text, "  unsigned char %s = V[0x%X];\n", REG_NAMES[r], r);
+    }
+  }
+  if (uses_i)
+    append( text, "  unsigned short i = Chip8Aot::I( c);\n");
+  if (uses_memory)
+    append( text, "  const unsigned char *memory = Chip8Aot::memory( c);\n");
+
+  if (read_regs != 0 || uses_i)
+    text += "\n";
+  text += body;
+  text += "\n";
+
+  for (unsigned int r = 0; r < 16; ++r)
+  {
+    if (written_regs & (1u << r))
+      append( text, "  V[0x%X] = %s;\n", r, REG_NAMES[r]);
+  }
+  if (writes_i)
+    append( text, "  Chip8Aot::I( c) = i;\n");
+  append( text, "  Chip8Aot::pc( c) = %s;\n}\n", next_pc.c_str());
+
+  return length;
+}
+
+
+const string &AotCompiler::compile( const char *name, const unsigned char *program, size_t program_size)
+{
+  // the name ends up in a string literal and a comment
+  string safe_name = name;
+  for (size_t i = 0; i < safe_name.size(); ++i)
+  {
+    char ch = safe_name[i];
+    if (!isalnum( (unsigned char)ch) && ch != '.' && ch != '-' && ch != '_')
+      safe_name[i] = '_';
+  }
+  name = safe_name.c_str();
+
+  image = program;
+  size = program_size;
+  cfg.analyze( program, program_size);
+  findLeaders();
+
+  text.clear();
+  append( text, "/**\n * %s, compiled ahead of time by aot_Chip8 - do not edit\n */\n\n", name);
+  text += "#include \"Chip8Aot.h\"\n\n\nnamespace\n{\n\n";
+
+  append( text, "const unsigned char image[%zu] =\n{", size > 0 ? size : 1);
+  for (size_t i = 0; i < size; ++i)
+    append( text, "%s0x%02X%s", i % 12 == 0 ? "\n  " : "", image[i], i + 1 < size ? ", " : "");
+  if (size == 0)
+    text += "\n  0";
+  text += "\n};\n";
+
+  // leaders only ever get added ahead of the address being translated
+  vector<unsigned short> starts;
+  vector<size_t> lengths;
+  instruction_count = 0;
+  for (unsigned int address = 0x200; address < 0x200 + size; ++address)
+  {
+    if (leader[address - 0x200])
+    {
+      starts.push_back( address);
+      lengths.push_back( emitBlock( address));
+      instruction_count += lengths.back();
+    }
+  }
+  block_count = starts.size();
+
+  text += "\nconst AotBlock blocks[] =\n{\n";
+  for (size_t b = 0; b < starts.size(); ++b)
+    append( text, "  { 0x%03X, %zu, block_%03X },\n", starts[b], lengths[b], starts[b]);
+  if (starts.empty())
+    text += "  { 0, 0, 0 }\n";
+  text += "};\n\n";
+
+  append( text, "const AotProgram program = { \"%s\", image, %zu, blocks, %zu };\n", name, size, block_count);
+  text += "const bool registered = Chip8Aot::add( &program);\n\n}\n";
+
+  return text;
+}
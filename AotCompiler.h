@@ -0,0 +1,73 @@
+/**
+ * @brief  CHIP8 EMULATOR PROJECT
+ * @Author esantiago
+ * @date   October, 2026
+ *
+ * @description: Header file for the ahead-of-time ROM compiler
+ *
+ * Translates a ROM into a C++ unit for Chip8Aot.h. The control-flow
+ * graph comes from the Disassembler: only reachable instructions are
+ * compiled, split into basic blocks at every branch target, skip, call,
+ * return point and store. Every block becomes one function that keeps
+ * the registers it touches (and I) in locals, calls into the runtime for
+ * drawing, timers, RND and stores, and ends by setting pc.
+ *
+ * Fx0A, unknown and ignored opcodes are not compiled, neither is the
+ * code a JP V0 may reach other than nnn itself; the runtime interprets
+ * them. Stores end a block, so a program that overwrites its own code
+ * only ever loses the blocks covering the bytes it wrote.
+ */
+
+#ifndef AOTCOMPILER_H_
+#define AOTCOMPILER_H_
+
+#include <stddef.h>
+#include <string>
+#include <vector>
+#include "Disassembler.h"
+
+
+class AotCompiler{
+
+  public:
+
+    AotCompiler();
+
+    // longest block in instructions; the runtime only runs a block when
+    // the rest of the cycle budget covers all of it
+    void setMaxBlockLength( size_t length) { max_length = length > 0 ? length : 1; }
+
+    // translates a program image loaded at 0x200 into the source of a
+    // unit registered under 'name', valid until the next call
+    const std::string &compile( const char *name, const unsigned char *program, size_t size);
+
+    size_t blocks() const { return block_count; }
+    size_t instructions() const { return instruction_count; }
+
+  private:
+
+    Disassembler cfg;
+    size_t max_length;
+    size_t block_count;
+    size_t instruction_count;
+
+    const unsigned char *image;
+    size_t size;
+    std::vector<bool> leader;
+    std::string text;
+    std::string body; // statements of the block being translated
+    unsigned int read_regs, written_regs;
+    bool uses_i, writes_i, uses_memory;
+
+    unsigned short opcodeAt( unsigned int address) const;
+    bool compiled( unsigned int address) const;
+    void findLeaders();
+    size_t emitBlock( unsigned int start);
+    void emitInstruction( unsigned int address, unsigned short opcode, std::string &next_pc);
+    const char *reg( unsigned int index, bool write);
+    void useI( bool write);
+    void append( std::string &out, const char *format, ...);
+
+};
+
+#endif // AOTCOMPILER_H_
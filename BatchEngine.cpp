@@ -0,0 +1,767 @@
+/**
+ * @brief  CHIP8 EMULATOR PROJECT
+ * @Author esantiago
+ * @date   October, 2026
+ *
+ * @description: Structure-of-arrays batch engine source file
+ */
+
+#include <string.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#include "BatchEngine.h"
+#include "Chip8.h"
+
+using namespace std;
+
+
+BatchEngine::BatchEngine( size_t lanes)
+  : count(lanes), stride((lanes + 15) & ~(size_t)15),
+    regs(16 * stride, 0), I(stride, 0), pc(stride, 0x200), sp(stride, 0),
+    delay_timer(stride, 0), sound_timer(stride, 0), waiting_key(stride, 0),
+    rng_state(stride, 1), written(stride, 0), unknown_opcodes(stride, 0),
+    draw_flag(stride, 0), lane_data(lanes), image(4096, 0), ops(stride, 0xFFFF),
+    lane_group(stride, 0), order(lanes), group_of(65536, 0),
+    vector_count(0), scalar_count(0)
+{
+}
+
+
+bool BatchEngine::loadProgram( const unsigned char *program, size_t size)
+{
+  // a reference machine provides the reset state, font included
+  Chip8 *machine = new Chip8;
+  machine->initialize();
+  bool fits = machine->loadProgram( program, size);
+
+  if (fits)
+  {
+    memcpy( &image[0], machine->memory, 4096);
+    for (size_t l = 0; l < count; ++l)
+    {
+      importLane( l, *machine);
+      seedRandom( l, l + 1);
+    }
+  }
+
+  delete machine;
+  return fits;
+
+}
+
+
+void BatchEngine::seedRandom( size_t lane, uint32_t seed)
+{
+  rng_state[lane] = seed != 0 ? seed : 0x2545F491;
+}
+
+
+void BatchEngine::exportLane( size_t lane, Chip8 &out) const
+{
+  const Lane &data = lane_data[lane];
+
+  memcpy( out.memory, data.memory, sizeof(out.memory));
+  out.touchPages();
+  memcpy( out.gfx, data.gfx, sizeof(out.gfx));
+  memcpy( out.stack, data.stack, sizeof(out.stack));
+  memcpy( out.key, data.key, sizeof(out.key));
+  for (unsigned int r = 0; r < 16; ++r)
+    out.V[r] = regs[r * stride + lane];
+
+  out.I = I[lane];
+  out.pc = pc[lane];
+  out.sp = sp[lane];
+  out.delay_timer = delay_timer[lane];
+  out.sound_timer = sound_timer[lane];
+  out.waiting_key = waiting_key[lane] != 0;
+  out.rng_state = rng_state[lane];
+  out.unknown_opcodes = unknown_opcodes[lane];
+  out.draw_flag = draw_flag[lane] != 0;
+
+  // the whole memory changed under the caches
+  out.flushBlocks();
+  out.attachAot();
+
+}
+
+
+void BatchEngine::importLane( size_t lane, const Chip8 &in)
+{
+  Lane &data = lane_data[lane];
+
+  memcpy( data.memory, in.memory, sizeof(data.memory));
+  markWritten( lane);
+  memcpy( data.gfx, in.gfx, sizeof(data.gfx));
+  memcpy( data.stack, in.stack, sizeof(data.stack));
+  memcpy( data.key, in.key, sizeof(data.key));
+  for (unsigned int r = 0; r < 16; ++r)
+    regs[r * stride + lane] = in.V[r];
+
+  I[lane] = in.I;
+  pc[lane] = in.pc;
+  sp[lane] = in.sp;
+  delay_timer[lane] = in.delay_timer;
+  sound_timer[lane] = in.sound_timer;
+  waiting_key[lane] = in.waiting_key;
+  rng_state[lane] = in.rng_state;
+  unknown_opcodes[lane] = in.unknown_opcodes;
+  draw_flag[lane] = in.draw_flag;
+
+}
+
+
+// a lane's memory is always complete, 'written' only says where the
+// shared image can no longer stand in for it
+void BatchEngine::storeByte( size_t lane, unsigned int address, unsigned char value)
+{
+  address &= 0xFFF;
+  lane_data[lane].memory[address] = value;
+  if (value != image[address])
+    written[lane] |= 1ULL << (address >> 6);
+
+}
+
+
+void BatchEngine::markWritten( size_t lane)
+{
+  const unsigned char *memory = lane_data[lane].memory;
+  uint64_t chunks = 0;
+
+  for (size_t chunk = 0; chunk < 64; ++chunk)
+  {
+    if (memcmp( memory + chunk * 64, &image[chunk * 64], 64) != 0)
+      chunks |= 1ULL << chunk;
+  }
+  written[lane] = chunks;
+
+}
+
+
+// Opcodes with an SSE2 pass. Flag-setting ops that read or write VF as
+// an operand are left to the scalar path, the pass computes VF and the
+// result from the registers as they were before the instruction.
+bool BatchEngine::vectorizable( unsigned short opcode)
+{
+#if defined(__SSE2__)
+  unsigned int x = (opcode & 0x0F00) >> 8;
+  unsigned int y = (opcode & 0x00F0) >> 4;
+
+  switch(opcode & 0xF000)
+  {
+    case 0x1000:
+    case 0x3000:
+    case 0x4000:
+    case 0x5000:
+    case 0x6000:
+    case 0x7000:
+    case 0x9000:
+    case 0xA000: return true;
+    case 0x8000:
+      switch(opcode & 0x000F)
+      {
+        case 0x0: case 0x1: case 0x2: case 0x3: return true;
+        case 0x4: case 0x5: case 0x7: return x != 0xF && y != 0xF;
+        case 0x6: case 0xE: return x != 0xF;
+      }
+      return false;
+    case 0xF000:
+      switch(opcode & 0x00FF)
+      {
+        case 0x07: case 0x15: case 0x18: case 0x29: return true;
+        case 0x1E: return x != 0xF;
+      }
+      return false;
+  }
+#endif
+  return false;
+
+}
+
+
+// Lanes running the same opcode make a group. A group runs as one SSE2
+// pass over all lanes when it holds at least 1/16 of them, so the pass
+// costs no more than stepping its lanes one by one. The other groups are
+// stepped one after the other, so the scalar dispatch sees the same
+// opcode many times in a row instead of a different one per lane.
+void BatchEngine::step()
+{
+  if (count == 0)
+    return;
+  groups.clear();
+
+  // fetch and group
+  for (size_t l = 0; l < count; ++l)
+  {
+    unsigned int address = pc[l] & 0xFFF;
+    unsigned int next = (pc[l] + 1) & 0xFFF;
+    const unsigned char *memory = (written[l] >> (address >> 6) | written[l] >> (next >> 6)) & 1 ?
+                                  lane_data[l].memory : &image[0];
+    unsigned short opcode = memory[address] << 8 | memory[next];
+
+    uint32_t group = group_of[opcode];
+    if (group == 0)
+    {
+      Group added = { opcode, false, 0, 0 };
+      groups.push_back( added);
+      group = groups.size();
+      group_of[opcode] = group;
+    }
+    ops[l] = opcode;
+    lane_group[l] = group - 1;
+    ++groups[group - 1].lanes;
+  }
+
+  size_t vector_lanes = 0;
+  size_t scalar_lanes = 0;
+  for (size_t g = 0; g < groups.size(); ++g)
+  {
+    Group &group = groups[g];
+    if (group.lanes >= 2 && group.lanes * 16 >= stride && vectorizable( group.opcode))
+    {
+      group.vector = true;
+      vectorPass( group.opcode);
+      vector_lanes += group.lanes;
+    }
+    else
+    {
+      group.first = scalar_lanes;
+      scalar_lanes += group.lanes;
+    }
+  }
+  vector_count += vector_lanes;
+  scalar_count += scalar_lanes;
+
+  for (size_t g = 0; g < groups.size(); ++g)
+    group_of[groups[g].opcode] = 0;
+
+  if (scalar_lanes == 0)
+    return;
+
+  // counting sort of the scalar lanes by group
+  for (size_t l = 0; l < count; ++l)
+  {
+    Group &group = groups[lane_group[l]];
+    if (!group.vector)
+      order[group.first++] = l;
+  }
+
+  for (size_t i = 0; i < scalar_lanes; ++i)
+    execute( order[i], ops[order[i]]);
+
+}
+
+
+void BatchEngine::runCycles( unsigned long long cycles)
+{
+  for (unsigned long long i = 0; i < cycles; ++i)
+    step();
+
+}
+
+
+void BatchEngine::tickTimers()
+{
+  size_t l = 0;
+
+#if defined(__SSE2__)
+  const __m128i one = _mm_set1_epi8( 1);
+  for (; l < stride; l += 16)
+  {
+    __m128i *delay = (__m128i *)&delay_timer[l];
+    __m128i *sound = (__m128i *)&sound_timer[l];
+    _mm_storeu_si128( delay, _mm_subs_epu8( _mm_loadu_si128( delay), one));
+    _mm_storeu_si128( sound, _mm_subs_epu8( _mm_loadu_si128( sound), one));
+  }
+#endif
+
+  for (; l < count; ++l)
+  {
+    if (delay_timer[l] > 0)
+      --delay_timer[l];
+    if (sound_timer[l] > 0)
+      --sound_timer[l];
+  }
+
+}
+
+
+void BatchEngine::runFrame( unsigned int cycles)
+{
+  runCycles( cycles);
+  tickTimers();
+
+}
+
+
+#if defined(__SSE2__)
+
+static inline __m128i load( const void *p)
+{
+  return _mm_loadu_si128( (const __m128i *)p);
+}
+
+static inline void store( void *p, __m128i v)
+{
+  _mm_storeu_si128( (__m128i *)p, v);
+}
+
+static inline __m128i blend( __m128i mask, __m128i yes, __m128i no)
+{
+  return _mm_or_si128( _mm_and_si128( mask, yes), _mm_andnot_si128( mask, no));
+}
+
+// 16 lanes of a 16-bit field: 'mask' holds one byte per lane, 'lo' and
+// 'hi' the new values of lanes 0-7 and 8-15
+static inline void blend16( unsigned short *field, __m128i mask, __m128i lo, __m128i hi)
+{
+  store( field, blend( _mm_unpacklo_epi8( mask, mask), lo, load( field)));
+  store( field + 8, blend( _mm_unpackhi_epi8( mask, mask), hi, load( field + 8)));
+}
+
+// adds one zero-extended byte per lane to 16 lanes of a 16-bit field
+static inline void add16( unsigned short *field, __m128i bytes)
+{
+  const __m128i zero = _mm_setzero_si128();
+  store( field, _mm_add_epi16( load( field), _mm_unpacklo_epi8( bytes, zero)));
+  store( field + 8, _mm_add_epi16( load( field + 8), _mm_unpackhi_epi8( bytes, zero)));
+}
+
+#endif
+
+
+// Runs 'opcode' on every lane that fetched it, 16 lanes per iteration.
+// Blocks without such a lane are skipped after the compare.
+void BatchEngine::vectorPass( unsigned short opcode)
+{
+#if defined(__SSE2__)
+  const unsigned int n   = opcode & 0x000F;
+  const unsigned int kk  = opcode & 0x00FF;
+  const unsigned int nnn = opcode & 0x0FFF;
+  unsigned char *vx = V( (opcode & 0x0F00) >> 8);
+  const unsigned char *vy = V( (opcode & 0x00F0) >> 4);
+  unsigned char *vf = V( 0xF);
+
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i ones = _mm_set1_epi8( -1);
+  const __m128i one  = _mm_set1_epi8( 1);
+  const __m128i two  = _mm_set1_epi8( 2);
+  const __m128i wanted = _mm_set1_epi16( (short)opcode);
+
+  for (size_t l = 0; l < stride; l += 16)
+  {
+    __m128i m = _mm_packs_epi16( _mm_cmpeq_epi16( load( &ops[l]), wanted),
+                                 _mm_cmpeq_epi16( load( &ops[l + 8]), wanted));
+    if (_mm_movemask_epi8( m) == 0)
+      continue;
+
+    __m128i skip = zero; // lanes that skip the next instruction
+    __m128i a = load( vx + l);
+    __m128i b = load( vy + l);
+
+    switch(opcode & 0xF000)
+    {
+      case 0x1000:  // 1nnn - JP addr
+        blend16( &pc[l], m, _mm_set1_epi16( nnn), _mm_set1_epi16( nnn));
+        continue;
+
+      case 0x3000:  // 3xkk - SE Vx, byte
+        skip = _mm_cmpeq_epi8( a, _mm_set1_epi8( kk));
+      break;
+
+      case 0x4000:  // 4xkk - SNE Vx, byte
+        skip = _mm_xor_si128( _mm_cmpeq_epi8( a, _mm_set1_epi8( kk)), ones);
+      break;
+
+      case 0x5000:  // 5xy0 - SE Vx, Vy
+        skip = _mm_cmpeq_epi8( a, b);
+      break;
+
+      case 0x9000:  // 9xy0 - SNE Vx, Vy
+        skip = _mm_xor_si128( _mm_cmpeq_epi8( a, b), ones);
+      break;
+
+      case 0x6000:  // 6xkk - LD Vx, byte
+        store( vx + l, blend( m, _mm_set1_epi8( kk), a));
+      break;
+
+      case 0x7000:  // 7xkk - ADD Vx, byte
+        store( vx + l, _mm_add_epi8( a, _mm_and_si128( m, _mm_set1_epi8( kk))));
+      break;
+
+      case 0x8000:
+      {
+        __m128i result, flag;
+        bool sets_vf = true;
+        switch(n)
+        {
+          case 0x0: result = b; sets_vf = false; break;                  // 8xy0 - LD Vx, Vy
+          case 0x1: result = _mm_or_si128( a, b); sets_vf = false; break;  // 8xy1 - OR Vx, Vy
+          case 0x2: result = _mm_and_si128( a, b); sets_vf = false; break; // 8xy2 - AND Vx, Vy
+          case 0x3: result = _mm_xor_si128( a, b); sets_vf = false; break; // 8xy3 - XOR Vx, Vy
+
+          case 0x4:  // 8xy4 - ADD Vx, Vy: the saturated sum differs from the wrapped one on carry
+            result = _mm_add_epi8( a, b);
+            flag = _mm_andnot_si128( _mm_cmpeq_epi8( _mm_adds_epu8( a, b), result), one);
+          break;
+
+          case 0x5:  // 8xy5 - SUB Vx, Vy: VF = Vx >= Vy
+            result = _mm_sub_epi8( a, b);
+            flag = _mm_and_si128( _mm_cmpeq_epi8( _mm_max_epu8( a, b), a), one);
+          break;
+
+          case 0x6:  // 8xy6 - SHR Vx: no byte shift in SSE2, the word shift leaks bit 0 of the next byte into bit 7
+            result = _mm_and_si128( _mm_srli_epi16( a, 1), _mm_set1_epi8( 0x7F));
+            flag = _mm_and_si128( a, one);
+          break;
+
+          case 0x7:  // 8xy7 - SUBN Vx, Vy: VF = Vy >= Vx
+            result = _mm_sub_epi8( b, a);
+            flag = _mm_and_si128( _mm_cmpeq_epi8( _mm_max_epu8( a, b), b), one);
+          break;
+
+          default:   // 8xyE - SHL Vx
+            result = _mm_add_epi8( a, a);
+            flag = _mm_and_si128( _mm_srli_epi16( a, 7), one);
+          break;
+        }
+        store( vx + l, blend( m, result, a));
+        if (sets_vf)
+          store( vf + l, blend( m, flag, load( vf + l)));
+      }
+      break;
+
+      case 0xA000:  // Annn - LD I, addr
+        blend16( &I[l], m, _mm_set1_epi16( nnn), _mm_set1_epi16( nnn));
+      break;
+
+      case 0xF000:
+        switch(kk)
+        {
+          case 0x07:  // Fx07 - LD Vx, DT
+            store( vx + l, blend( m, load( &delay_timer[l]), a));
+          break;
+
+          case 0x15:  // Fx15 - LD DT, Vx
+            store( &delay_timer[l], blend( m, a, load( &delay_timer[l])));
+          break;
+
+          case 0x18:  // Fx18 - LD ST, Vx
+            store( &sound_timer[l], blend( m, a, load( &sound_timer[l])));
+          break;
+
+          case 0x1E:  // Fx1E - ADD I, Vx: VF = I + Vx > 0xFFF, the saturated sum cannot wrap below it
+          {
+            __m128i added = _mm_and_si128( a, m);
+            __m128i limit = _mm_set1_epi16( 0x0FFF);
+            __m128i lo = load( &I[l]);
+            __m128i hi = load( &I[l + 8]);
+            __m128i fits_lo = _mm_cmpeq_epi16( _mm_subs_epu16( _mm_adds_epu16( lo, _mm_unpacklo_epi8( added, zero)), limit), zero);
+            __m128i fits_hi = _mm_cmpeq_epi16( _mm_subs_epu16( _mm_adds_epu16( hi, _mm_unpackhi_epi8( added, zero)), limit), zero);
+            __m128i flag = _mm_andnot_si128( _mm_packs_epi16( fits_lo, fits_hi), one);
+            store( vf + l, blend( m, flag, load( vf + l)));
+            add16( &I[l], added);
+          }
+          break;
+
+          case 0x29:  // Fx29 - LD F, Vx: I = Vx * 5 + 0x50
+          {
+            __m128i five = _mm_set1_epi16( 5);
+            __m128i font = _mm_set1_epi16( 0x50);
+            __m128i lo = _mm_add_epi16( _mm_mullo_epi16( _mm_unpacklo_epi8( a, zero), five), font);
+            __m128i hi = _mm_add_epi16( _mm_mullo_epi16( _mm_unpackhi_epi8( a, zero), five), font);
+            blend16( &I[l], m, lo, hi);
+          }
+          break;
+        }
+      break;
+    }
+
+    // pc += 2, or 4 for the lanes that skip
+    add16( &pc[l], _mm_and_si128( m, _mm_add_epi8( two, _mm_and_si128( skip, two))));
+  }
+#endif
+
+}
+
+
+// One instruction on one lane, the reference switch of Chip8::emulateCycle
+void BatchEngine::execute( size_t lane, unsigned short opcode)
+{
+  const size_t l = lane;
+  Lane &data = lane_data[l];
+  unsigned char &vx = regs[((opcode & 0x0F00) >> 8) * stride + l];
+  unsigned char &vy = regs[((opcode & 0x00F0) >> 4) * stride + l];
+  unsigned char &vf = regs[0xF * stride + l];
+
+  switch(opcode & 0xF000)
+  {
+    case 0x0000:
+      switch(opcode & 0x000F)
+      {
+        case 0x0000:  // 00E0 - CLS
+          clearScreen( l);
+          pc[l] += 2;
+        break;
+
+        case 0x000E:  // 00EE - RET
+          sp[l] = (sp[l] - 1) & 0xF;
+          pc[l] = data.stack[sp[l]] + 2;
+        break;
+
+        default:
+          ++unknown_opcodes[l];
+        break;
+      }
+    break;
+
+    case 0x1000:  // 1nnn - JP addr
+      pc[l] = opcode & 0x0FFF;
+    break;
+
+    case 0x2000:  // 2nnn - CALL addr
+      data.stack[sp[l]] = pc[l];
+      sp[l] = (sp[l] + 1) & 0xF;
+      pc[l] = opcode & 0x0FFF;
+    break;
+
+    case 0x3000:  // 3xkk - SE Vx, byte
+      pc[l] += vx == (opcode & 0x00FF) ? 4 : 2;
+    break;
+
+    case 0x4000:  // 4xkk - SNE Vx, byte
+      pc[l] += vx != (opcode & 0x00FF) ? 4 : 2;
+    break;
+
+    case 0x5000:  // 5xy0 - SE Vx, Vy
+      pc[l] += vx == vy ? 4 : 2;
+    break;
+
+    case 0x6000:  // 6xkk - LD Vx, byte
+      vx = opcode & 0x00FF;
+      pc[l] += 2;
+    break;
+
+    case 0x7000:  // 7xkk - ADD Vx, byte
+      vx += opcode & 0x00FF;
+      pc[l] += 2;
+    break;
+
+    case 0x8000:
+      switch(opcode & 0x000F)
+      {
+        case 0x0000: vx = vy; pc[l] += 2; break;  // 8xy0 - LD Vx, Vy
+        case 0x0001: vx |= vy; pc[l] += 2; break; // 8xy1 - OR Vx, Vy
+        case 0x0002: vx &= vy; pc[l] += 2; break; // 8xy2 - AND Vx, Vy
+        case 0x0003: vx ^= vy; pc[l] += 2; break; // 8xy3 - XOR Vx, Vy
+
+        case 0x0004:  // 8xy4 - ADD Vx, Vy
+          vf = vy > 0xFF - vx ? 1 : 0;
+          vx += vy;
+          pc[l] += 2;
+        break;
+
+        case 0x0005:  // 8xy5 - SUB Vx, Vy
+          vf = vy > vx ? 0 : 1;
+          vx -= vy;
+          pc[l] += 2;
+        break;
+
+        case 0x0006:  // 8xy6 - SHR Vx
+          vf = vx & 0x1;
+          vx >>= 1;
+          pc[l] += 2;
+        break;
+
+        case 0x0007:  // 8xy7 - SUBN Vx, Vy
+          vf = vx > vy ? 0 : 1;
+          vx = vy - vx;
+          pc[l] += 2;
+        break;
+
+        case 0x000E:  // 8xyE - SHL Vx
+          vf = vx >> 7;
+          vx <<= 1;
+          pc[l] += 2;
+        break;
+
+        default:
+          ++unknown_opcodes[l];
+        break;
+      }
+    break;
+
+    case 0x9000:  // 9xy0 - SNE Vx, Vy
+      pc[l] += vx != vy ? 4 : 2;
+    break;
+
+    case 0xA000:  // Annn - LD I, addr
+      I[l] = opcode & 0x0FFF;
+      pc[l] += 2;
+    break;
+
+    case 0xB000:  // Bnnn - JP V0, addr
+      pc[l] = (opcode & 0x0FFF) + regs[l];
+    break;
+
+    case 0xC000:  // Cxkk - RND Vx, byte
+      vx = nextRandom( l) & (opcode & 0x00FF);
+      pc[l] += 2;
+    break;
+
+    case 0xD000:  // Dxyn - DRW Vx, Vy, nibble
+      drawSprite( l, vx, vy, opcode & 0x000F);
+      pc[l] += 2;
+    break;
+
+    case 0xE000:
+      switch(opcode & 0x000F)
+      {
+        case 0x000E:  // Ex9E - SKP Vx
+          pc[l] += vx < 16 && data.key[vx] != 0 ? 4 : 2;
+        break;
+
+        case 0x0001:  // ExA1 - SKNP Vx
+          pc[l] += vx < 16 && data.key[vx] != 0 ? 2 : 4;
+        break;
+      }
+    break;
+
+    case 0xF000:
+      switch(opcode & 0x00FF)
+      {
+        case 0x0007:  // Fx07 - LD Vx, DT
+          vx = delay_timer[l];
+          pc[l] += 2;
+        break;
+
+        case 0x000A:  // Fx0A - LD Vx, K: the highest key held wins, as in emulateCycle
+        {
+          bool key_press = false;
+          for (size_t i = 0; i < 16; ++i)
+          {
+            if (data.key[i] != 0)
+            {
+              vx = i;
+              key_press = true;
+            }
+          }
+          waiting_key[l] = !key_press;
+          if (key_press)
+            pc[l] += 2;
+        }
+        break;
+
+        case 0x0015:  // Fx15 - LD DT, Vx
+          delay_timer[l] = vx;
+          pc[l] += 2;
+        break;
+
+        case 0x0018:  // Fx18 - LD ST, Vx
+          sound_timer[l] = vx;
+          pc[l] += 2;
+        break;
+
+        case 0x001E:  // Fx1E - ADD I, Vx
+          vf = I[l] + vx > 0xFFF ? 1 : 0;
+          I[l] += vx;
+          pc[l] += 2;
+        break;
+
+        case 0x0029:  // Fx29 - LD F, Vx
+          I[l] = vx * 0x5 + 0x50;
+          pc[l] += 2;
+        break;
+
+        case 0x0033:  // Fx33 - LD B, Vx
+          storeByte( l, I[l], vx / 100);
+          storeByte( l, I[l] + 1, (vx % 100) / 10);
+          storeByte( l, I[l] + 2, vx % 10);
+          pc[l] += 2;
+        break;
+
+        case 0x0055:  // Fx55 - LD [I], Vx
+        {
+          size_t last = (opcode & 0x0F00) >> 8;
+          for (size_t i = 0; i <= last; ++i)
+            storeByte( l, I[l] + i, regs[i * stride + l]);
+          I[l] += last + 1;
+          pc[l] += 2;
+        }
+        break;
+
+        case 0x0065:  // Fx65 - LD Vx, [I]
+        {
+          size_t last = (opcode & 0x0F00) >> 8;
+          for (size_t i = 0; i <= last; ++i)
+            regs[i * stride + l] = readByte( l, I[l] + i);
+          I[l] += last + 1;
+          pc[l] += 2;
+        }
+        break;
+      }
+    break;
+  }
+
+}
+
+
+// Chip8::drawSprite without the SSE2 row pairs, one lane at a time
+void BatchEngine::drawSprite( size_t lane, unsigned char x, unsigned char y, unsigned char height)
+{
+  Lane &data = lane_data[lane];
+  unsigned int left = x % 64;
+  unsigned int top  = y % 32;
+  unsigned int rows = height;
+
+  if (rows > 32 - top)
+    rows = 32 - top;
+
+  uint32_t changed = 0;
+  uint64_t hit = 0;
+  for (size_t i = 0; i < rows; ++i)
+  {
+    uint64_t line = ((uint64_t)readByte( lane, I[lane] + i) << 56) >> left;
+    if (line != 0)
+      changed |= 1u << (top + i);
+    hit |= data.gfx[top + i] & line;
+    data.gfx[top + i] ^= line;
+  }
+
+  regs[0xF * stride + lane] = hit != 0 ? 1 : 0;
+
+  if (changed != 0)
+    draw_flag[lane] = 1;
+
+}
+
+
+void BatchEngine::clearScreen( size_t lane)
+{
+  uint64_t *gfx = lane_data[lane].gfx;
+  uint32_t changed = 0;
+
+  for (size_t i = 0; i < 32; ++i)
+  {
+    if (gfx[i] != 0)
+      changed |= 1u << i;
+    gfx[i] = 0;
+  }
+
+  if (changed != 0)
+    draw_flag[lane] = 1;
+
+}
+
+
+// xorshift32, same sequence as Chip8::nextRandom
+unsigned char BatchEngine::nextRandom( size_t lane)
+{
+  uint32_t x = rng_state[lane];
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  rng_state[lane] = x;
+  return x >> 24;
+
+}
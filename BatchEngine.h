@@ -0,0 +1,142 @@
+/**
+ * @brief  CHIP8 EMULATOR PROJECT
+ * @Author esantiago
+ * @date   October, 2026
+ *
+ * @description: Header file for the structure-of-arrays batch engine
+ *
+ * Runs N machines ("lanes") in lockstep, one instruction per lane per
+ * step, for workloads that want thousands of instances of one ROM.
+ * Registers, I, pc, sp and timers live in one array per field across
+ * all lanes; memory, display, stack and keypad stay per lane, with code
+ * and sprites read from one shared image until a lane writes over them.
+ *
+ * Every step fetches each lane's opcode and groups the lanes by it.
+ * Groups big enough to pay for a pass over all lanes run as SSE2
+ * operations on 16 lanes at a time (ALU ops, skips, jumps, I and timer
+ * loads), masked to the lanes in the group. Everything else, and every
+ * lane of a small group, goes through a scalar copy of the reference
+ * switch in Chip8::emulateCycle. The result is exactly what N separate
+ * Chip8 instances produce; 'soa_Chip8 -v' checks that.
+ */
+
+#ifndef BATCHENGINE_H_
+#define BATCHENGINE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+class Chip8;
+
+
+class BatchEngine{
+
+  public:
+
+    explicit BatchEngine( size_t lanes);
+
+    size_t lanes() const { return count; }
+
+    // resets every lane like Chip8::initialize() plus loadProgram(), lane
+    // i seeded with i + 1; false when the program does not fit
+    bool loadProgram( const unsigned char *program, size_t size);
+    void seedRandom( size_t lane, uint32_t seed);
+
+    // keypad of one lane, same meaning as Chip8::key. Ex9E and ExA1 treat
+    // a key number above 0xF as not pressed.
+    unsigned char *keys( size_t lane) { return lane_data[lane].key; }
+
+    // one instruction on every lane
+    void step();
+    void runCycles( unsigned long long cycles);
+    void tickTimers();
+    void runFrame( unsigned int cycles);
+
+    const uint64_t *gfxRows( size_t lane) const { return lane_data[lane].gfx; }
+    bool drawFlag( size_t lane) const { return draw_flag[lane] != 0; }
+    void clearDrawFlag( size_t lane) { draw_flag[lane] = 0; }
+    unsigned long long unknownOpcodes( size_t lane) const { return unknown_opcodes[lane]; }
+
+    // copies one lane to or from a regular machine, host bookkeeping
+    // (draw flag, unknown opcode count) included
+    void exportLane( size_t lane, Chip8 &out) const;
+    void importLane( size_t lane, const Chip8 &in);
+
+    // lane-instructions run by the SSE2 passes and by the scalar fallback
+    unsigned long long vectorInstructions() const { return vector_count; }
+    unsigned long long scalarInstructions() const { return scalar_count; }
+
+  private:
+
+    // the per-lane state that is not touched across lanes
+    struct Lane
+    {
+      unsigned char memory[4096];
+      uint64_t gfx[32];
+      unsigned short stack[16];
+      unsigned char key[16];
+    };
+
+    size_t count;
+    size_t stride; // count rounded up to 16, padding lanes never run
+
+    std::vector<unsigned char> regs; // V0..VF, register r of lane l at r * stride + l
+    std::vector<unsigned short> I;
+    std::vector<unsigned short> pc;
+    std::vector<unsigned short> sp;
+    std::vector<unsigned char> delay_timer;
+    std::vector<unsigned char> sound_timer;
+    std::vector<unsigned char> waiting_key;
+    std::vector<uint32_t> rng_state;
+    std::vector<uint64_t> written; // 64-byte chunks of memory that differ from 'image', bit n = chunk n
+    std::vector<unsigned long long> unknown_opcodes;
+    std::vector<unsigned char> draw_flag;
+    std::vector<Lane> lane_data;
+
+    // memory as loadProgram leaves it, shared by every lane. Code and
+    // sprites are read from here unless the lane wrote over them, so the
+    // fetch of a step touches one 4K image instead of a page per lane.
+    std::vector<unsigned char> image;
+
+    // lanes running the same opcode this step
+    struct Group
+    {
+      unsigned short opcode;
+      bool vector;
+      size_t lanes;
+      size_t first; // of its lanes in 'order'
+    };
+
+    std::vector<unsigned short> ops;   // fetched opcode per lane, padding holds 0xFFFF
+    std::vector<uint32_t> lane_group;  // group index per lane
+    std::vector<uint32_t> order;       // scalar lanes sorted by group
+    std::vector<uint32_t> group_of;    // by opcode, group index + 1 during a step, 0 otherwise
+    std::vector<Group> groups;
+
+    unsigned long long vector_count;
+    unsigned long long scalar_count;
+
+    unsigned char *V( unsigned int r) { return &regs[r * stride]; }
+
+    unsigned char readByte( size_t lane, unsigned int address) const
+    {
+      address &= 0xFFF;
+      return (written[lane] >> (address >> 6) & 1) ? lane_data[lane].memory[address] : image[address];
+    }
+    void storeByte( size_t lane, unsigned int address, unsigned char value);
+    void markWritten( size_t lane);
+
+    static bool vectorizable( unsigned short opcode);
+    void vectorPass( unsigned short opcode);
+    void execute( size_t lane, unsigned short opcode);
+    void drawSprite( size_t lane, unsigned char x, unsigned char y, unsigned char height);
+    void clearScreen( size_t lane);
+    unsigned char nextRandom( size_t lane);
+
+    BatchEngine( const BatchEngine &);
+    BatchEngine &operator=( const BatchEngine &);
+
+};
+
+#endif // BATCHENGINE_H_
@@ -0,0 +1,159 @@
+/**
+ * @brief  CHIP8 EMULATOR PROJECT
+ * @Author esantiago
+ * @date   October, 2026
+ *
+ * @description: Sound timer beeper source file
+ */
+
+#include <SDL2/SDL.h>
+#include <string.h>
+#include "Beeper.h"
+#include "Scheduler.h"
+
+using namespace std;
+
+
+// peak amplitude, well below full scale, and how many samples an edge
+// takes to ramp the tone in or out (about 2 ms at 48 kHz)
+static const int AMPLITUDE = 6000;
+static const int MAX_GAIN = 96;
+
+
+Beeper::Beeper()
+  : head(0), tail(0), device(0), sample_rate(0), buffer_samples(0), posted(false),
+    clock(0), level(false), phase(0), step(0), gain(0)
+{
+}
+
+
+Beeper::~Beeper()
+{
+  close();
+}
+
+
+bool Beeper::open( int rate, int buffer)
+{
+  if (device != 0)
+    return true;
+
+  if (SDL_InitSubSystem( SDL_INIT_AUDIO ) < 0)
+  {
+    printf( "Audio could not initialize! SDL Error: %s\n", SDL_GetError() );
+    return false;
+  }
+
+  SDL_AudioSpec want, have;
+  memset( &want, 0, sizeof(want));
+  want.freq = rate;
+  want.format = AUDIO_S16SYS;
+  want.channels = 1;
+  want.samples = buffer;
+  want.callback = callback;
+  want.userdata = this;
+
+  // the callback synthesizes whatever rate and buffer size the device
+  // settles on, only the sample format is fixed
+  device = SDL_OpenAudioDevice( NULL, 0, &want, &have,
+                                SDL_AUDIO_ALLOW_FREQUENCY_CHANGE | SDL_AUDIO_ALLOW_SAMPLES_CHANGE);
+  if (device == 0)
+  {
+    printf( "Audio device could not be opened! SDL Error: %s\n", SDL_GetError() );
+    SDL_QuitSubSystem( SDL_INIT_AUDIO );
+    return false;
+  }
+
+  // set up before the device starts pulling samples, nothing below is
+  // shared with the callback except the ring
+  sample_rate = have.freq;
+  buffer_samples = have.samples;
+  step = (uint32_t)(((uint64_t)TONE_HZ << 32) / sample_rate);
+  head.store( 0, memory_order_relaxed);
+  tail.store( 0, memory_order_relaxed);
+  posted = false;
+  clock = 0;
+  level = false;
+  phase = 0;
+  gain = 0;
+
+  SDL_PauseAudioDevice( device, 0 );
+  return true;
+
+}
+
+
+void Beeper::close()
+{
+  if (device == 0)
+    return;
+
+  SDL_CloseAudioDevice( device );
+  SDL_QuitSubSystem( SDL_INIT_AUDIO );
+  device = 0;
+
+}
+
+
+void Beeper::update( unsigned long long frame, bool on)
+{
+  if (device == 0 || on == posted)
+    return;
+
+  size_t h = head.load( memory_order_relaxed);
+  if (h - tail.load( memory_order_acquire) == RING_SIZE)
+    return;
+
+  ring[h & (RING_SIZE - 1)].time = frame * sample_rate / Scheduler::FRAME_RATE;
+  ring[h & (RING_SIZE - 1)].on = on;
+  head.store( h + 1, memory_order_release);
+  posted = on;
+
+}
+
+
+void Beeper::callback( void *user, unsigned char *stream, int len)
+{
+  static_cast<Beeper *>( user)->render( reinterpret_cast<int16_t *>( stream), len / sizeof(int16_t));
+}
+
+
+// Runs on the SDL audio thread
+void Beeper::render( int16_t *out, size_t count)
+{
+  size_t t = tail.load( memory_order_relaxed);
+  size_t h = head.load( memory_order_acquire);
+
+  // the emulation got ahead (audio started late, or underran): catch the
+  // audio clock up so the edge plays one buffer from now, not seconds
+  // later. Only while silent, a jump in the middle of a beep would cut it.
+  if (t != h && !level)
+  {
+    uint64_t next = ring[t & (RING_SIZE - 1)].time;
+    if (next > clock + 2 * buffer_samples)
+      clock = next - buffer_samples;
+  }
+
+  for (size_t i = 0; i < count; ++i)
+  {
+    // edges already in the past apply at once
+    while (t != h && ring[t & (RING_SIZE - 1)].time <= clock + i)
+    {
+      level = ring[t & (RING_SIZE - 1)].on;
+      ++t;
+    }
+
+    if (level && gain < MAX_GAIN)
+      ++gain;
+    else if (!level && gain > 0)
+      --gain;
+
+    int sample = (phase & 0x80000000u) ? AMPLITUDE : -AMPLITUDE;
+    out[i] = (int16_t)(sample * gain / MAX_GAIN);
+    phase += step;
+  }
+
+  clock += count;
+  tail.store( t, memory_order_release);
+
+}
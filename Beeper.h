@@ -0,0 +1,84 @@
+/**
+ * @brief  CHIP8 EMULATOR PROJECT
+ * @Author esantiago
+ * @date   October, 2026
+ *
+ * @description: Header file for the sound timer beeper
+ *
+ * The Chip8 buzzer sounds while sound_timer is non-zero. The emulation
+ * side posts the on/off edges, stamped with the emulated frame they
+ * happened in, into a fixed single-producer single-consumer ring; the
+ * SDL audio callback drains the ring and synthesizes a square wave,
+ * switching at the sample the edge maps to. The callback neither
+ * allocates nor locks: the ring is two atomic indices over a plain
+ * array, and everything else it touches is owned by the audio thread.
+ *
+ * Emulated frames are converted to samples at 60 Hz. When the audio
+ * clock falls behind the emulation by more than a couple of buffers it
+ * jumps forward, when it runs ahead edges play as soon as they arrive,
+ * so latency stays around one device buffer either way.
+ */
+
+#ifndef BEEPER_H_
+#define BEEPER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+
+
+class Beeper{
+
+  public:
+
+    Beeper();
+    ~Beeper();
+
+    // starts the SDL audio subsystem and a mono 16-bit device; 'buffer'
+    // samples per callback (256 at 48 kHz is about 5 ms). Prints why and
+    // returns false when there is no audio, the beeper stays silent then.
+    bool open( int rate = 48000, int buffer = 256);
+    void close();
+    bool isOpen() const { return device != 0; }
+
+    // emulation side, once per emulated frame: the buzzer state after
+    // frame 'frame'. Only changes are posted; a full ring drops the edge
+    // and it is posted again on the next call.
+    void update( unsigned long long frame, bool on);
+
+    static const unsigned int TONE_HZ = 440;
+
+  private:
+
+    struct Edge
+    {
+      uint64_t time; // in samples
+      bool on;
+    };
+
+    static const size_t RING_SIZE = 64; // power of two
+    Edge ring[RING_SIZE];
+    std::atomic<size_t> head; // next slot to write, only the producer stores it
+    std::atomic<size_t> tail; // next slot to read, only the callback stores it
+
+    uint32_t device;  // SDL_AudioDeviceID, 0 when closed
+    int sample_rate;
+    int buffer_samples;
+    bool posted;      // last state put in the ring
+
+    // audio thread only
+    uint64_t clock;   // samples rendered so far
+    bool level;       // buzzer state at 'clock'
+    uint32_t phase;   // square wave phase, one period per 2^32
+    uint32_t step;    // phase increment per sample
+    int gain;         // ramps between 0 and MAX_GAIN so edges do not click
+
+    static void callback( void *user, unsigned char *stream, int len);
+    void render( int16_t *out, size_t count);
+
+    Beeper( const Beeper &);
+    Beeper &operator=( const Beeper &);
+
+};
+
+#endif // BEEPER_H_
@@ -1,19 +1,136 @@
-#include <iostream>
-#include <fstream>
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <string.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 #include "Chip8.h"
+#include "Chip8Jit.h"
+#include "Chip8Aot.h"
+#include "RomCache.h"
+#ifdef CHIP8_PROFILE
+#include "Profiler.h"
+#endif
 
 using namespace std;
 
 
-Chip8::Chip8() : m_buffer(NULL), draw_flag(false)
+// blocks are translated once they have been dispatched this many times
+static const unsigned int JIT_THRESHOLD = 8;
+
+
+struct Chip8::BlockCache
+{
+  Block *blocks[4096];          // by start address, NULL when not cached
+  unsigned char code_refs[4096]; // number of cached blocks covering each byte
+  std::vector<Block *> free_list;
+  Chip8Jit *jit;                // created on the first translation
+
+  BlockCache() : jit(NULL)
+  {
+    for (size_t i = 0; i < 4096; ++i)
+    {
+      blocks[i] = NULL;
+      code_refs[i] = 0;
+    }
+  }
+
+  ~BlockCache()
+  {
+    for (size_t i = 0; i < 4096; ++i)
+      delete blocks[i];
+    for (size_t i = 0; i < free_list.size(); ++i)
+      delete free_list[i];
+    delete jit;
+  }
+
+  void drop( unsigned short start)
+  {
+    Block *block = blocks[start];
+    for (size_t i = 0; i < block->length * 2u; ++i)
+      --code_refs[(start + i) & 0xFFF];
+    blocks[start] = NULL;
+    free_list.push_back( block);
+  }
+};
+
+
+struct Chip8::AotCache
+{
+  const AotProgram *program;    // NULL when no compiled program matches
+  const AotBlock *entry[4096];   // by start address, NULL once overwritten
+  unsigned char code_refs[4096]; // number of live blocks covering each byte
+  unsigned short longest;        // in bytes, bounds the invalidation scan
+
+  AotCache() : program(NULL), longest(0)
+  {
+    for (size_t i = 0; i < 4096; ++i)
+    {
+      entry[i] = NULL;
+      code_refs[i] = 0;
+    }
+  }
+};
+
+
+static bool endsBlock( unsigned short opcode)
+{
+  switch(opcode & 0xF000)
+  {
+    case 0x0000: return (opcode & 0x000F) != 0x0000; // only 00E0 falls through
+    case 0x1000:
+    case 0x2000:
+    case 0x3000:
+    case 0x4000:
+    case 0x5000:
+    case 0x9000:
+    case 0xB000:
+    case 0xE000: return true;
+    case 0x8000:
+      switch(opcode & 0x000F)
+      {
+        case 0x0: case 0x1: case 0x2: case 0x3: case 0x4:
+        case 0x5: case 0x6: case 0x7: case 0xE: return false;
+      }
+      return true; // unknown, pc does not advance
+    case 0xF000:
+      switch(opcode & 0x00FF)
+      {
+        case 0x07: case 0x15: case 0x18: case 0x1E:
+        case 0x29: case 0x65: return false;
+      }
+      return true; // Fx0A, stores (Fx33, Fx55) and unknown
+  }
+  return false;
+}
+
+
+// Each machine's write clock starts 2^40 past the previous machine's, so
+// a Chip8Fork holding the clock of a destroyed machine never takes a new
+// one at the same address for its source with pages already in sync.
+static uint64_t nextClockEpoch()
+{
+  static atomic<uint64_t> epoch( 0);
+  return (epoch.fetch_add( 1, memory_order_relaxed) + 1) << 40;
+}
+
+
+Chip8::Chip8()
+  : write_clock(nextClockEpoch()), waiting_key(false), rng_state(1), unknown_opcodes(0), idle_skip(true), idle_cycles(0),
+#ifdef CHIP8_PROFILE
+    profiler(NULL),
+#endif
+    cycle_hook(NULL), exec_mode(EXEC_SWITCH), quirk_set(0), switch_path(true), decode_table(decodeTable( 0)),
+    block_cache(NULL), aot_cache(NULL), draw_flag(false)
 {
   // Chip-8 Fontset:
   // Programs may refer to group of sprites representing 
   // the hexadecimal digits 0 through F
-  unsigned char Chip8_fontset[80] =
+  static const unsigned char fontset[80] =
     { 
       0xF0, 0x90, 0x90, 0x90, 0xF0, // 0
       0x20, 0x60, 0x20, 0x20, 0x70, // 1
@@ -33,13 +150,18 @@ Chip8::Chip8() : m_buffer(NULL), draw_flag(false)
       0xF0, 0x80, 0xF0, 0x80, 0x80  // F
     };
 
+  memcpy( Chip8_fontset, fontset, sizeof(Chip8_fontset));
+  touchPages();
+
 }
 
 
 Chip8::~Chip8()
 {
-  delete[] m_buffer;
-  m_buffer = NULL;
+  delete block_cache;
+  block_cache = NULL;
+  delete aot_cache;
+  aot_cache = NULL;
 }
 
 
@@ -50,9 +172,12 @@ void Chip8::initialize()
   opcode = 0;     // Reset current opcode
   I      = 0;     // Reset index register
   sp     = 0;     // Reset stack pointer
+  waiting_key = false;
+  unknown_opcodes = 0;
+  idle_cycles = 0;
 
   // Clear display
-  for (size_t i = 0; i < 2048; ++i)
+  for (size_t i = 0; i < 32; ++i)
     gfx[i] = 0;
 
   // Clear stack, registers V0 - VF and keypad  
@@ -69,43 +194,66 @@ void Chip8::initialize()
   // Load fontset
   for (size_t i = 0; i < 80; ++i)
     memory[i + 80] = Chip8_fontset[i];
+  touchPages();
+
+  flushBlocks();
+  attachAot();
 
   // Reset timers
   delay_timer = 0;
   sound_timer = 0;
 
   // Seeding rng
-  srand(time(NULL));
+  seedRandom( time(NULL));
 
 }
 
 
-bool Chip8::loadGame(const char *hexFile)
+// The file is mapped and shared through the ROM cache, so loading a ROM
+// that was loaded before costs one fstat and the copy into memory
+bool Chip8::loadGame( const char *hexFile)
 {
-  // initialization flag
-  bool success = true;
+  const RomImage *rom = RomCache::instance().load( hexFile);
+  if (rom == NULL)
+    return false;
 
-  if ( readIntoBuffer( hexFile) )
-  {
-    for (size_t i = 0; i < m_size; ++i)
-      memory[i + 512] = m_buffer[i];
-  }
+  return loadProgram( rom->data, rom->size);
 
-  else
-  { 
-    printf( "\nFailed to read into buffer!\n" );
-    success = false;
-  }
+}
+
+
+// Copies a program image to 0x200, for programs that do not come from a file
+bool Chip8::loadProgram( const unsigned char *program, size_t size)
+{
+  if (size > 4096 - 512)
+    return false;
 
-  return success;
+  for (size_t i = 0; i < size; ++i)
+    memory[i + 512] = program[i];
+  touchPages();
+  flushBlocks();
+  attachAot();
+
+  return true;
 
 }
 
 
 void Chip8::emulateCycle()
 {
+#ifdef CHIP8_PROFILE
+  if (profiler != NULL)
+    profiler->instruction( pc, memory[pc & 0xFFF] << 8 | memory[(pc+1) & 0xFFF]);
+#endif
+
+  if (!switch_path)
+  {
+    emulateCycleTable();
+    return;
+  }
+
   // fetch opcode
-  opcode = (memory[pc] << 8 | memory[pc+1]);
+  opcode = (memory[pc & 0xFFF] << 8 | memory[(pc+1) & 0xFFF]);
 
   // decode and exucute opcode
   switch(opcode & 0xF000)
@@ -114,20 +262,18 @@ void Chip8::emulateCycle()
       switch(opcode & 0x000F)
       {
         case 0x0000:  // 00E0 - CLS: Clear the display
-          for (size_t i = 0; i < 2048; ++i)
-            gfx[i] = 0;
-          draw_flag = true; 
+          clearScreen();
           pc += 2;
         break;
 
         case 0x000E:  // 00EE - RET: Return from a subroutine; Interpreter sets pc to the address at the top of the stack, then subtracks 1 from sp
-          --sp;
+          sp = (sp - 1) & 0xF;
           pc = stack[sp];
           pc += 2;
         break;
 
         default: 
-          printf("Unknown opcode..."); 
+          ++unknown_opcodes;
         break;
       }
     break;
@@ -138,7 +284,7 @@ void Chip8::emulateCycle()
 
     case 0x2000:  // 2nnn - CALL addr: call subroutine at nnn; The interpreter increments the sp, then puts the current pc on the top of the stack. The pc is then set to nnn
       stack[sp] = pc;
-      ++sp;
+      sp = (sp + 1) & 0xF;
       pc = (opcode & 0x0FFF);
     break;
 
@@ -237,7 +383,7 @@ void Chip8::emulateCycle()
         break;
 
         default:  
-          printf("Unknown opcode..."); 
+          ++unknown_opcodes;
         break;
       }
     break;
@@ -259,35 +405,14 @@ void Chip8::emulateCycle()
     break;
 
     case 0xC000:  // Cxkk - RND Vx, byte: Set Vx = random byte AND kk; The interpreter generates a random number from 0 - 255, which is then ANDed with the value kk. The result is stored in Vx
-      V[(opcode & 0x0F00) >> 8] = (rand() % (0xFF + 1)) & (opcode & 0x00FF);
+      V[(opcode & 0x0F00) >> 8] = nextRandom() & (opcode & 0x00FF);
       pc += 2;
     break;
 
     case 0xD000:  // Dxyn - DRW Vx, Vy, nibble: The interpreter reads and displays n-byte sprite starting at memory location I at (Vx,Vy), set VF = collision
     {             // Sprites are XORed onto the existing screen. If this causes any pixels to be erased, VF is set to 1, otherwise it is set to 0 
-      unsigned char x = V[(opcode & 0x0F00) >> 8];
-      unsigned char y = V[(opcode & 0x00F0) >> 4];
-      unsigned char height  = (opcode & 0x000F);
-      unsigned char pixel;
-
-      V[0xF] = 0;
-      for (size_t yline = 0; yline < height; yline++)
-      {
-        pixel = memory[I + yline];
-        for(size_t xline = 0; xline < 8; xline++)
-        {
-          if((pixel & (0x80 >> xline)) != 0)
-          {
-            if(gfx[(x + xline + ((y + yline) * 64))] == 1) // The '64' is to be able to land on the correct row on the 64x32 original display
-              V[0xF] = 1;                                 
-            gfx[x + xline + ((y + yline) * 64)] ^= 1;
-          }
-        }
-      }
- 
-      draw_flag = true;
+      drawSprite( V[(opcode & 0x0F00) >> 8], V[(opcode & 0x00F0) >> 4], (opcode & 0x000F));
       pc += 2;
-
     }  
     break;
 
@@ -295,14 +420,14 @@ void Chip8::emulateCycle()
       switch(opcode & 0x000F)
       {
         case 0x000E:  // Ex9E - SKP Vx: Skips the next instruction if the key stored in Vx is pressed (checks keyboard), pc is increased by 2
-          if (key[V[(opcode & 0x0F00) >> 8]] != 0)
+          if (V[(opcode & 0x0F00) >> 8] < 16 && key[V[(opcode & 0x0F00) >> 8]] != 0)
             pc += 4;
           else
             pc += 2; 
         break;
 
         case 0x0001:  // ExA1 - SKNP Vx: Skips the next instruction if the key stored in Vx isn't pressed (checks keyboard), pc is increased by 2
-          if (key[V[(opcode & 0x0F00) >> 8]] == 0)
+          if (V[(opcode & 0x0F00) >> 8] >= 16 || key[V[(opcode & 0x0F00) >> 8]] == 0)
             pc += 4;
           else
             pc += 2;
@@ -329,6 +454,7 @@ void Chip8::emulateCycle()
               key_press = true;
             }
           }
+          waiting_key = !key_press;
           if(!key_press)
             return;
           pc += 2; 
@@ -360,226 +486,1169 @@ void Chip8::emulateCycle()
         break;
 
         case 0x0033:  // Fx33 - LD [I], Vx: Interpreter takes the decimal value of Vx, and places the hundreds digit in memory at location in I, tens digit at location I+1, ones digit I+2 
-          memory[I] = V[(opcode & 0x0F00) >> 8] / 100;
-          memory[I+1] = (V[(opcode & 0x0F00) >> 8] %100) / 10;
-          memory[I+2] =  V[(opcode & 0x0F00) >> 8] %10;
+          storeByte( I, V[(opcode & 0x0F00) >> 8] / 100);
+          storeByte( I+1, (V[(opcode & 0x0F00) >> 8] %100) / 10);
+          storeByte( I+2, V[(opcode & 0x0F00) >> 8] %10);
           pc += 2;
         break;
 
         case 0x0055:  // Fx55 - LD [I], Vx: The interpreter copies the values of registers V0 through Vx into memory, starting at address in I. I is set to I + X + 1 afer operation.
           for (size_t i = 0; i <= ((opcode & 0x0F00) >> 8); ++i)
-            memory[I+i] = V[i];
+            storeByte( I+i, V[i]);
           I += ( (opcode & 0x0F00) >> 8 ) + 1;
           pc += 2;
         break;
 
         case 0x0065:  // Fx65 - LD Vx, [I]: The interpreter fills V0 to Vx with values from memory starting at address I. I is set to I + X + 1 afer operation.
           for (size_t i = 0; i <= ((opcode & 0x0F00) >> 8); ++i)
-            V[i] = memory[I+i];
+            V[i] = memory[(I+i) & 0xFFF];
           I += ( (opcode & 0x0F00) >> 8 ) + 1;
           pc += 2;
         break;
       }
     break;
 
-    default: printf("Unknown opcode..."); break;
+    default: ++unknown_opcodes; break;
 
   }
 
-  // update timers
-  if(delay_timer > 0)
-    --delay_timer;
-  if(sound_timer > 0)
+}
+
+
+// Table-driven path: one lookup resolves the handler and all operands
+void Chip8::emulateCycleTable()
+{
+  // fetch opcode
+  opcode = (memory[pc & 0xFFF] << 8 | memory[(pc+1) & 0xFFF]);
+
+  // decode and execute opcode
+  const Instruction &in = decode_table[opcode];
+  in.exec( *this, in);
+
+}
+
+
+void Chip8::setExecMode( ExecMode mode)
+{
+  exec_mode = mode;
+  switch_path = exec_mode == EXEC_SWITCH && quirk_set == 0;
+
+  if ((exec_mode == EXEC_BLOCK || exec_mode == EXEC_JIT) && block_cache == NULL)
+    block_cache = new BlockCache;
+
+  if (exec_mode == EXEC_AOT && aot_cache == NULL)
   {
-    if(sound_timer == 1)
-    {
-      //printf("Beep!\n");
-    }
-    --sound_timer;    
+    aot_cache = new AotCache;
+    attachAot();
+  }
+}
+
+
+void Chip8::setQuirks( unsigned int quirks)
+{
+  quirk_set = quirks & QUIRK_ALL;
+  switch_path = exec_mode == EXEC_SWITCH && quirk_set == 0;
+  decode_table = decodeTable( quirk_set);
 
+  // cached blocks hold copies of the old handlers, compiled ROMs assume none
+  flushBlocks();
+  attachAot();
+
+}
+
+
+// Runs exactly 'cycles' instructions. In EXEC_BLOCK, EXEC_JIT and
+// EXEC_AOT modes whole blocks are executed per dispatch, otherwise this
+// is emulateCycle in a loop. Passes of idle loops count as run without
+// being executed.
+void Chip8::runCycles( unsigned long long cycles)
+{
+  // a debugger with breakpoints or watches armed, or a trace: every
+  // instruction is looked at
+  if (cycle_hook != NULL)
+  {
+    cycle_hook->run( cycles);
+    return;
+  }
+
+#ifdef CHIP8_PROFILE
+  // the profiler wants to see every instruction, whatever the exec mode
+  if (profiler != NULL)
+  {
+    for (unsigned long long i = 0; i < cycles; ++i)
+      emulateCycle();
+    return;
+  }
+#endif
+
+  if (exec_mode == EXEC_BLOCK || exec_mode == EXEC_JIT)
+  {
+    runBlocks( cycles);
+    return;
+  }
+  else if (exec_mode == EXEC_AOT)
+  {
+    runAot( cycles);
+    return;
+  }
+
+  if (!idle_skip)
+  {
+    for (unsigned long long i = 0; i < cycles; ++i)
+      emulateCycle();
+    return;
+  }
+
+  while (cycles > 0)
+  {
+    unsigned short from = pc;
+    emulateCycle();
+    --cycles;
+
+    // idle loops close with a jump back, or stall in place
+    if (pc <= from && cycles > 0)
+      cycles -= skipIdle( cycles);
   }
 
 }
 
 
-void Chip8::disassembler( const char *hexFile)
+// An idle loop leaves the machine exactly as it found it after every
+// pass, until a timer tick or the host changes a key, and neither happens
+// inside runCycles. So once pc is at its head, whole passes can be taken
+// off the budget without running them:
+//   1nnn to itself                     one instruction per pass
+//   Fx0A with no key down              one instruction per pass
+//   Fx07 / SE or SNE Vx, kk / JP back  while the test falls through
+// Returns the cycles skipped, the machine left as if they had run.
+unsigned long long Chip8::skipIdle( unsigned long long cycles)
 {
+  if (pc > 0xFFA)
+    return 0;
+
+  unsigned short op = memory[pc] << 8 | memory[pc + 1];
 
-  if ( readIntoBuffer( hexFile) )
+  if (op == (0x1000 | pc))
   {
-    pos = 0;
+    opcode = op;
+    idle_cycles += cycles;
+    return cycles;
+  }
 
-    while (pos < m_size)
+  if ((op & 0xF0FF) == 0xF00A)
+  {
+    for (size_t i = 0; i < 16; ++i)
     {
-      decoder( pos);
-      pos += 2;
-      printf ("\n");
+      if (key[i] != 0)
+        return 0;
     }
+    opcode = op;
+    waiting_key = true;
+    idle_cycles += cycles;
+    return cycles;
+  }
 
-    buffer_deallocate();
+  if ((op & 0xF0FF) == 0xF007 && cycles >= 3)
+  {
+    unsigned short test = memory[pc + 2] << 8 | memory[pc + 3];
+    unsigned short jump = memory[pc + 4] << 8 | memory[pc + 5];
+    if (jump != (0x1000 | pc) || (test & 0x0F00) != (op & 0x0F00))
+      return 0;
+
+    bool loops;
+    if ((test & 0xF000) == 0x3000)
+      loops = delay_timer != (test & 0x00FF);
+    else if ((test & 0xF000) == 0x4000)
+      loops = delay_timer == (test & 0x00FF);
+    else
+      return 0;
+    if (!loops)
+      return 0;
+
+    unsigned long long skipped = cycles - cycles % 3;
+    V[(op & 0x0F00) >> 8] = delay_timer;
+    opcode = jump;
+    idle_cycles += skipped;
+    return skipped;
   }
 
-  else 
-    printf( "\nFailed to read into buffer!\n" );
+  return 0;
 
 }
 
 
-bool Chip8::readIntoBuffer( const char *strFileName) 
+void Chip8::runBlocks( unsigned long long cycles)
 {
-  // initialization flag
-  bool success = true;
+  while (cycles > 0)
+  {
+    if (idle_skip)
+    {
+      cycles -= skipIdle( cycles);
+      if (cycles == 0)
+        break;
+    }
+
+    Block *block = lookupBlock( pc);
+
+    // not enough budget left for the whole block, finish one at a time
+    if (block->length > cycles)
+    {
+      emulateCycleTable();
+      --cycles;
+      continue;
+    }
+
+    if (exec_mode == EXEC_JIT && block->native == NULL && ++block->hits == JIT_THRESHOLD)
+    {
+      if (block_cache->jit == NULL)
+        block_cache->jit = new Chip8Jit;
+
+      // a full code buffer starts over from an empty cache
+      if (!block_cache->jit->compile( *this, *block) && block_cache->jit->full())
+      {
+        flushBlocks();
+        block_cache->jit->reset();
+        continue;
+      }
+    }
+
+    if (block->native != NULL)
+    {
+      unsigned short length = block->length;
+      block->native( this);
+      cycles -= length;
+      continue;
+    }
 
-  streampos size;
+    for (size_t i = 0; i < block->length; ++i)
+    {
+      const Instruction &in = block->ops[i];
+      opcode = in.opcode;
+      in.exec( *this, in);
+    }
+
+    cycles -= block->length;
+  }
 
-  ifstream file(strFileName, ios::in|ios::binary|ios::ate);
-  if (file.is_open())
+}
+
+
+// Compiled blocks run whole, like cached ones; pc values without a live
+// block (Fx0A, unknown opcodes, JP V0 and RET landing elsewhere, code
+// that was overwritten) and block tails that do not fit the budget are
+// interpreted one instruction at a time
+void Chip8::runAot( unsigned long long cycles)
+{
+  while (cycles > 0)
   {
-    if (m_buffer)
-      buffer_deallocate();
-    size = file.tellg();
-    m_size = size;
-    m_buffer = new unsigned char[size];
-    if (m_buffer)
+    if (idle_skip)
     {
-      cout << "Allocation successful!" << endl;
-      file.seekg(0,ios::beg);
-      file.read((char *)m_buffer, size);
-      file.close();
-      cout << "\nThe file content is now in memory..." << endl;
+      cycles -= skipIdle( cycles);
+      if (cycles == 0)
+        break;
     }
 
+    const AotBlock *block = pc < 4096 ? aot_cache->entry[pc] : NULL;
+
+    if (block != NULL && block->length <= cycles)
+    {
+      block->run( *this);
+      cycles -= block->length;
+    }
     else
     {
-      cout << "\nAllocation failed!" << endl;
-      success = false;
+      emulateCycleTable();
+      --cycles;
     }
   }
 
-  else
+}
+
+
+// Looks up the compiled program for the image now in memory; blocks
+// killed by stores come back only when a program is loaded again
+void Chip8::attachAot()
+{
+  if (aot_cache == NULL)
+    return;
+
+  AotCache *cache = aot_cache;
+  for (size_t i = 0; i < 4096; ++i)
   {
-    cout << "\nUnable to open file..." << endl;
-    success = false;
+    cache->entry[i] = NULL;
+    cache->code_refs[i] = 0;
   }
+  cache->longest = 0;
+  cache->program = quirk_set == 0 ? Chip8Aot::find( memory) : NULL;
+  if (cache->program == NULL)
+    return;
 
-  return success;
+  for (size_t b = 0; b < cache->program->count; ++b)
+  {
+    const AotBlock *block = &cache->program->blocks[b];
+    cache->entry[block->start & 0xFFF] = block;
+    for (size_t i = 0; i < block->length * 2u; ++i)
+      ++cache->code_refs[(block->start + i) & 0xFFF];
+    if (block->length * 2u > cache->longest)
+      cache->longest = block->length * 2u;
+  }
 
 }
 
 
-// Used as debugger and to study any ROM that's written in the Chip-8 language
-void Chip8::decoder( size_t pc) 
+const char *Chip8::diffState( const Chip8 &other) const
 {
-  opcode = (m_buffer[pc] << 8 | m_buffer[pc+1]);
+  if (memcmp( memory, other.memory, sizeof(memory)) != 0) return "memory";
+  if (memcmp( V, other.V, sizeof(V)) != 0) return "V";
+  if (I != other.I) return "I";
+  if (pc != other.pc) return "pc";
+  if (memcmp( gfx, other.gfx, sizeof(gfx)) != 0) return "gfx";
+  if (delay_timer != other.delay_timer) return "delay_timer";
+  if (sound_timer != other.sound_timer) return "sound_timer";
+  if (memcmp( stack, other.stack, sizeof(stack)) != 0) return "stack";
+  if (sp != other.sp) return "sp";
+  if (waiting_key != other.waiting_key) return "waiting_key";
+  if (rng_state != other.rng_state) return "rng_state";
+  if (unknown_opcodes != other.unknown_opcodes) return "unknown_opcodes";
+  if (draw_flag != other.draw_flag) return "draw_flag";
+  return NULL;
 
-  printf("%03lu %X ", pc, opcode);
-  switch(opcode & 0xF000)
+}
+
+
+// snapshot layout, offsets in bytes
+static const unsigned char STATE_MAGIC[4] = { 'C', '8', 'S', 'T' };
+static const size_t STATE_VERSION_AT = 4;  // u16
+static const size_t STATE_PC_AT      = 6;  // u16
+static const size_t STATE_I_AT       = 8;  // u16
+static const size_t STATE_SP_AT      = 10; // u16
+static const size_t STATE_TIMERS_AT  = 12; // delay, sound, waiting_key, 0
+static const size_t STATE_STACK_AT   = 16; // 16 x u16
+static const size_t STATE_V_AT       = 48; // 16 bytes
+static const size_t STATE_KEY_AT     = 64; // 16 bytes
+static const size_t STATE_GFX_AT     = 80; // 32 x u64
+static const size_t STATE_MEMORY_AT  = 336; // 4096 bytes
+static const size_t STATE_RNG_AT     = 4432; // u32, ends at STATE_SIZE
+
+static void put16( unsigned char *p, unsigned short v)
+{
+  p[0] = v & 0xFF;
+  p[1] = v >> 8;
+}
+
+static unsigned short get16( const unsigned char *p)
+{
+  return p[0] | (p[1] << 8);
+}
+
+static void put32( unsigned char *p, uint32_t v)
+{
+  put16( p, v & 0xFFFF);
+  put16( p + 2, v >> 16);
+}
+
+static uint32_t get32( const unsigned char *p)
+{
+  return get16( p) | ((uint32_t)get16( p + 2) << 16);
+}
+
+
+void Chip8::saveState( unsigned char *state) const
+{
+  memcpy( state, STATE_MAGIC, 4);
+  put16( state + STATE_VERSION_AT, STATE_VERSION);
+  put16( state + STATE_PC_AT, pc);
+  put16( state + STATE_I_AT, I);
+  put16( state + STATE_SP_AT, sp);
+  state[STATE_TIMERS_AT]     = delay_timer;
+  state[STATE_TIMERS_AT + 1] = sound_timer;
+  state[STATE_TIMERS_AT + 2] = waiting_key;
+  state[STATE_TIMERS_AT + 3] = 0;
+
+  for (size_t i = 0; i < 16; ++i)
+    put16( state + STATE_STACK_AT + i * 2, stack[i]);
+  memcpy( state + STATE_V_AT, V, 16);
+  memcpy( state + STATE_KEY_AT, key, 16);
+
+  for (size_t row = 0; row < 32; ++row)
   {
-    case 0x0000:
-      switch(opcode & 0x000F)
-      {
-        case 0x0000: printf("00E0 - CLS: Clear the display"); break;
+    for (size_t b = 0; b < 8; ++b)
+      state[STATE_GFX_AT + row * 8 + b] = (unsigned char)(gfx[row] >> (b * 8));
+  }
 
-        case 0x000E: printf("00EE - RET: Return from a subroutine; Interpreter sets pc to the address at the top of the stack, then subtracks 1 from sp."); break;
+  memcpy( state + STATE_MEMORY_AT, memory, 4096);
+  put32( state + STATE_RNG_AT, rng_state);
 
-        default: printf("Unknown opcode..."); break;
-      }
-    break;
+}
 
-    case 0x1000: printf("1nnn - JP addr: Jump to location nnn; The interpreter sets the pc to nnn."); break;
 
-    case 0x2000: printf("2nnn - CALL addr: call subroutine at nnn; The interpreter increments the sp, then puts the current pc on the top of the stack. The pc is then set to nnn."); break;
+bool Chip8::loadState( const unsigned char *state, size_t size)
+{
+  if (size != STATE_SIZE || memcmp( state, STATE_MAGIC, 4) != 0 ||
+      get16( state + STATE_VERSION_AT) != STATE_VERSION)
+    return false;
+
+  pc = get16( state + STATE_PC_AT);
+  I  = get16( state + STATE_I_AT);
+  sp = get16( state + STATE_SP_AT) & 0xF;
+  delay_timer = state[STATE_TIMERS_AT];
+  sound_timer = state[STATE_TIMERS_AT + 1];
+  waiting_key = state[STATE_TIMERS_AT + 2] != 0;
+  seedRandom( get32( state + STATE_RNG_AT));
+
+  for (size_t i = 0; i < 16; ++i)
+    stack[i] = get16( state + STATE_STACK_AT + i * 2);
+  memcpy( V, state + STATE_V_AT, 16);
+  memcpy( key, state + STATE_KEY_AT, 16);
+
+  uint32_t changed = 0;
+  for (size_t row = 0; row < 32; ++row)
+  {
+    uint64_t bits = 0;
+    for (size_t b = 0; b < 8; ++b)
+      bits |= (uint64_t)state[STATE_GFX_AT + row * 8 + b] << (b * 8);
+    if (bits != gfx[row])
+      changed |= 1u << row;
+    gfx[row] = bits;
+  }
+  if (changed != 0)
+    draw_flag = true;
 
-    case 0x3000: printf("3xkk - SE Vx, byte: Skip next instruction if Vx = kk (increments pc by 2)"); break;
+  // only bytes that actually differ go through storeByte, so cached
+  // blocks survive a load that leaves the code alone (rewind)
+  const unsigned char *src = state + STATE_MEMORY_AT;
+  for (size_t page = 0; page < 4096; page += 64)
+  {
+    if (memcmp( memory + page, src + page, 64) == 0)
+      continue;
+    for (size_t i = page; i < page + 64; ++i)
+    {
+      if (memory[i] != src[i])
+        storeByte( i, src[i]);
+    }
+  }
 
-    case 0x4000: printf("4xkk - SNE Vx, byte: Skip next instruction if Vx != kk (increments pc by 2)"); break;
+  return true;
 
-    case 0x5000: printf("5xy0 - SE Vx, Vy: Skip next instruction if Vx = Vy (increments pc by 2)"); break;
+}
 
-    case 0x6000: printf("6xkk - LD Vx, byte: Set Vx = kk; The interprester puts the value kk into register Vx."); break;
 
-    case 0x7000: printf("7xkk - ADD Vx, byte: Set Vx = Vx + kk; Adds the value kk to the value of register Vx, then stores the result in Vx."); break;
+static inline uint64_t fnv( uint64_t hash, uint64_t value)
+{
+  return (hash ^ value) * 0x100000001B3ULL;
+}
 
-    case 0x8000:
-      switch(opcode & 0x000F)
-      {
-        case 0x0000: printf("8xy0 - LD Vx, Vy: Set Vx = Vy; Stores the value of register Vy in register Vx"); break;
 
-        case 0x0001: printf("8xy1 - OR Vx, Vy: Set Vx = Vx OR Vy; Performs a bitwise OR on the values of Vx and Vy, then stores the result in Vx."); break;
+// hashes whole words rather than bytes, ~600 multiplies per call
+uint64_t Chip8::hashState( uint64_t seed) const
+{
+  uint64_t hash = seed;
+  hash = fnv( hash, pc | (uint64_t)I << 16 | (uint64_t)sp << 32 | (uint64_t)delay_timer << 48 |
+                    (uint64_t)sound_timer << 56);
+  hash = fnv( hash, rng_state | (uint64_t)waiting_key << 32);
 
-        case 0x0002: printf("8xy2 - AND Vx, Vy: Set Vx = Vx AND Vy; Performs a bitwise AND on the values of Vx and Vy, then stores the result in Vx."); break;
+  uint64_t word;
+  for (size_t i = 0; i < 16; i += 4)
+  {
+    word = stack[i] | (uint64_t)stack[i+1] << 16 | (uint64_t)stack[i+2] << 32 | (uint64_t)stack[i+3] << 48;
+    hash = fnv( hash, word);
+  }
+  for (size_t i = 0; i < 16; i += 8)
+  {
+    memcpy( &word, V + i, 8);
+    hash = fnv( hash, word);
+    memcpy( &word, key + i, 8);
+    hash = fnv( hash, word);
+  }
+  for (size_t row = 0; row < 32; ++row)
+    hash = fnv( hash, gfx[row]);
+  for (size_t i = 0; i < 4096; i += 8)
+  {
+    memcpy( &word, memory + i, 8);
+    hash = fnv( hash, word);
+  }
 
-        case 0x0003: printf("8xy3 - XOR Vx, Vy: Set Vx = Vx XOR Vy; Performs a bitwise exclusive OR on the values of Vx and Vy, then stores the result in Vx."); break;
+  return hash;
 
-        case 0x0004: printf("8xy4 - Add Vx, Vy: Set Vx = Vx + Vy, set VF = carry; The values of Vx and Vy are added together. ");
-                     printf("\nIf the result is greater than 8 bits (i.e., > 255) VF is set to 1, otherwise 0. Only lowest 8 bits of result are kept, and stored in Vx."); break;
+}
 
-        case 0x0005: printf("8xy5 - SUB Vx, Vy: Set Vx = Vx - Vy, set VF = NOT borrow; If Vx > Vy, then VF is set to 1, otherwise 0. Then Vy is subtracted from Vx, and result stored in Vx."); break;
 
-        case 0x0006: printf("8xy6 - Vx = Vy >> 1: Shifts Vy right by one and stores result in Vx (Vy remains unchanged). VF is set to value of least significant bit of Vy before the shift."); break;
+void Chip8::seedRandom( uint32_t seed)
+{
+  rng_state = seed != 0 ? seed : 0x2545F491;
+}
 
-        case 0x0007: printf("8xy7 - SUBN Vx, Vy: Set Vx = Vy - Vx, set VF = NOT borrow; If Vy > Vx, then VF is set 1, otherwise 0. Then Vx is subtracted from Vy, and result stored in Vx."); break;
 
-        case 0x000E: printf("8xyE - SHL Vx {, Vy}: Set Vx = Vx SHL 1; If the most-signigicant bit of Vx is 1, then VF is set to 1, otherwise 0. Then Vx is multiplied by 2."); break;
-      }
-    break;
+// xorshift32, the top byte of each step is the random byte
+unsigned char Chip8::nextRandom()
+{
+  uint32_t x = rng_state;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  rng_state = x;
+  return x >> 24;
+}
 
-    case 0x9000: printf("9xy0 - SNE Vx, Vy: Skip next instruction if Vx !=  Vy (increments pc by 2)"); break;
 
-    case 0xA000: printf("Annn - LD I, addr: Set I = nnn; The value of register I is set to nnn."); break;
+// One emulated frame: the CPU budget for 1/60 s followed by the timer tick
+void Chip8::runFrame( unsigned int cycles)
+{
+  runCycles( cycles);
+  tickTimers();
 
-    case 0xB000: printf("Bnnn - JP V0, addr: Jump to location nnn + V0; The pc is set to nnn plus the value of V0."); break;
+}
 
-    case 0xC000: printf("Cxkk - RND Vx, byte: Set Vx = random byte AND kk; The interpreter generates a random number from 0 - 255, which is then ANDed with the value kk. The result is stored in Vx."); break;
 
-    case 0xD000: printf("Dxyn - DRW Vx, Vy, nibble: The interpreter reads and displays n-byte sprite starting at memory location I at (Vx,Vy), set VF = collision.");
-                 printf("\nSprites are XORed onto the existing screen. If this causes any pixels to be erased, VF is set to 1, otherwise it is set to 0."); break;
+// Delay and sound timers count down at 60 Hz, independent of the CPU rate
+void Chip8::tickTimers()
+{
+  if(delay_timer > 0)
+    --delay_timer;
+  // the host sounds the buzzer while sound_timer is non-zero
+  if(sound_timer > 0)
+    --sound_timer;
 
-    case 0xE000:
+}
+
+
+// Decodes one opcode exactly the way the nested switch in emulateCycle does,
+// including its catch-all cases, so both paths stay interchangeable
+template <unsigned int Q>
+Chip8::Instruction Chip8::decodeOpcode( unsigned short opcode)
+{
+  Instruction in;
+  in.opcode = opcode;
+  in.nnn = (opcode & 0x0FFF);
+  in.x   = (opcode & 0x0F00) >> 8;
+  in.y   = (opcode & 0x00F0) >> 4;
+  in.kk  = (opcode & 0x00FF);
+  in.n   = (opcode & 0x000F);
+  in.exec = &Chip8::opUnknown;
+
+  switch(opcode & 0xF000)
+  {
+    case 0x0000:
       switch(opcode & 0x000F)
       {
-        case 0x000E: printf("Ex9E - SKP Vx: Skip next instruction if key with the value of Vx is pressed (checks keyboard), pc is increased by 2."); break;
+        case 0x0000: in.exec = &Chip8::op00E0; break;
+        case 0x000E: in.exec = &Chip8::op00EE; break;
+      }
+    break;
 
-        case 0x0001: printf("ExA1 - SKNP Vx: Skip next instruction if key with the value of Vx is not pressed (checks keyboard), pc is increased by 2."); break;
+    case 0x1000: in.exec = &Chip8::op1nnn; break;
+    case 0x2000: in.exec = &Chip8::op2nnn; break;
+    case 0x3000: in.exec = &Chip8::op3xkk; break;
+    case 0x4000: in.exec = &Chip8::op4xkk; break;
+    case 0x5000: in.exec = &Chip8::op5xy0; break;
+    case 0x6000: in.exec = &Chip8::op6xkk; break;
+    case 0x7000: in.exec = &Chip8::op7xkk; break;
+
+    case 0x8000:
+      switch(opcode & 0x000F)
+      {
+        case 0x0000: in.exec = &Chip8::op8xy0; break;
+        case 0x0001: in.exec = &Chip8::op8xy1<Q & QUIRK_VF_RESET>; break;
+        case 0x0002: in.exec = &Chip8::op8xy2<Q & QUIRK_VF_RESET>; break;
+        case 0x0003: in.exec = &Chip8::op8xy3<Q & QUIRK_VF_RESET>; break;
+        case 0x0004: in.exec = &Chip8::op8xy4; break;
+        case 0x0005: in.exec = &Chip8::op8xy5; break;
+        case 0x0006: in.exec = &Chip8::op8xy6<Q & QUIRK_SHIFT_VY>; break;
+        case 0x0007: in.exec = &Chip8::op8xy7; break;
+        case 0x000E: in.exec = &Chip8::op8xyE<Q & QUIRK_SHIFT_VY>; break;
+      }
+    break;
+
+    case 0x9000: in.exec = &Chip8::op9xy0; break;
+    case 0xA000: in.exec = &Chip8::opAnnn; break;
+    case 0xB000: in.exec = &Chip8::opBnnn; break;
+    case 0xC000: in.exec = &Chip8::opCxkk; break;
+    case 0xD000: in.exec = &Chip8::opDxyn<Q & QUIRK_WRAP>; break;
+
+    case 0xE000:
+      in.exec = &Chip8::opIgnored;
+      switch(opcode & 0x000F)
+      {
+        case 0x000E: in.exec = &Chip8::opEx9E; break;
+        case 0x0001: in.exec = &Chip8::opExA1; break;
       }
     break;
 
     case 0xF000:
+      in.exec = &Chip8::opIgnored;
       switch(opcode & 0x00FF)
       {
-        case 0x0007: printf("Fx07 - LD Vx, DT: Set Vx = delay timer value. The value of DT is placed into Vx."); break;
+        case 0x0007: in.exec = &Chip8::opFx07; break;
+        case 0x000A: in.exec = &Chip8::opFx0A; break;
+        case 0x0015: in.exec = &Chip8::opFx15; break;
+        case 0x0018: in.exec = &Chip8::opFx18; break;
+        case 0x001E: in.exec = &Chip8::opFx1E<Q & QUIRK_NO_ADD_VF>; break;
+        case 0x0029: in.exec = &Chip8::opFx29; break;
+        case 0x0033: in.exec = &Chip8::opFx33; break;
+        case 0x0055: in.exec = &Chip8::opFx55<Q & QUIRK_KEEP_I>; break;
+        case 0x0065: in.exec = &Chip8::opFx65<Q & QUIRK_KEEP_I>; break;
+      }
+    break;
+  }
 
-        case 0x000A: printf("Fx0A - LD Vx, K: Wait for a key press, store value of the key in Vx; All execution stops until a key is pressed, then value of that key is stored in Vx."); break;
+  return in;
+
+}
 
-        case 0x0015: printf("Fx15 - LD DT, Vx: Set delay timer = Vx; DT is set equal to value of Vx."); break;
 
-        case 0x0018: printf("Fx18 - LD ST, Vx: Set sound timer = Vx; ST is set equal to value of Vx."); break;
+template <unsigned int Q>
+const Chip8::Instruction *Chip8::buildTable()
+{
+  // 64K entries * 16 bytes, only the opcodes a ROM actually uses get touched
+  static Instruction table[0x10000];
+  static bool built = false;
+  static mutex build_lock;
 
-        case 0x001E: printf("Fx1E - ADD I, Vx: Set I = I + Vx; The value of I and Vx are added, and result is stored in I."); break;
+  lock_guard<mutex> guard(build_lock);
+  if (!built)
+  {
+    for (size_t i = 0; i < 0x10000; ++i)
+      table[i] = decodeOpcode<Q>( i);
+    built = true;
+  }
 
-        case 0x0029: printf("Fx29 - LD I, Vx: Set I = location of sprite for digit Vx; The value of I is set to location for hexadecimal sprite corresponding to the value of Vx."); break;
+  return table;
 
-        case 0x0033: printf("Fx33 - LD B, Vx: Interpreter takes the decimal value of Vx, and places the hundreds digit in memory at location in I, tens digit at location I+1, ones digit I+2."); break;
+}
 
-        case 0x0055: printf("Fx55 - LD [I], Vx: The interpreter copies the values of registers V0 through Vx into memory, starting at address in I."); break;
 
-        case 0x0065: printf("Fx65 - LD Vx, [I]: The interpreter fills V0 to Vx with values from memory starting at address I."); break;
-      }
-    break;
+// The factory over every quirk set: one instantiation per combination
+const Chip8::Instruction *Chip8::decodeTable( unsigned int quirks)
+{
+  typedef const Instruction *(*Builder)();
+  static const Builder builders[QUIRK_ALL + 1] =
+    {
+      &buildTable<0>,  &buildTable<1>,  &buildTable<2>,  &buildTable<3>,
+      &buildTable<4>,  &buildTable<5>,  &buildTable<6>,  &buildTable<7>,
+      &buildTable<8>,  &buildTable<9>,  &buildTable<10>, &buildTable<11>,
+      &buildTable<12>, &buildTable<13>, &buildTable<14>, &buildTable<15>,
+      &buildTable<16>, &buildTable<17>, &buildTable<18>, &buildTable<19>,
+      &buildTable<20>, &buildTable<21>, &buildTable<22>, &buildTable<23>,
+      &buildTable<24>, &buildTable<25>, &buildTable<26>, &buildTable<27>,
+      &buildTable<28>, &buildTable<29>, &buildTable<30>, &buildTable<31>
+    };
+
+  return builders[quirks & QUIRK_ALL]();
+
+}
+
+
+Chip8::Block *Chip8::lookupBlock( unsigned short address)
+{
+  address &= 0xFFF;
+  Block *block = block_cache->blocks[address];
+  if (block != NULL)
+    return block;
+
+  if (block_cache->free_list.empty())
+    block = new Block;
+  else
+  {
+    block = block_cache->free_list.back();
+    block_cache->free_list.pop_back();
+  }
+
+  block->start = address;
+  block->length = 0;
+  block->hits = 0;
+  block->native = NULL;
+
+  unsigned short at = address;
+  while (block->length < MAX_BLOCK_LENGTH)
+  {
+    unsigned short op = (memory[at & 0xFFF] << 8 | memory[(at+1) & 0xFFF]);
+    block->ops[block->length++] = decode_table[op];
+    at += 2;
+    if (endsBlock( op))
+      break;
+  }
+
+  for (size_t i = 0; i < block->length * 2u; ++i)
+    ++block_cache->code_refs[(address + i) & 0xFFF];
+
+  block_cache->blocks[address] = block;
+  return block;
+
+}
+
 
-    default: printf("Unknown opcode..."); break;
+void Chip8::flushBlocks()
+{
+  if (block_cache == NULL)
+    return;
+
+  for (size_t i = 0; i < 4096; ++i)
+  {
+    if (block_cache->blocks[i] != NULL)
+      block_cache->drop( i);
+  }
+}
+
+
+void Chip8::storeByte( unsigned short address, unsigned char value)
+{
+  address &= 0xFFF;
+  memory[address] = value;
+  page_clock[address >> 8] = write_clock;
+
+  if (block_cache != NULL && block_cache->code_refs[address] != 0)
+    invalidateCode( address);
+  if (aot_cache != NULL && aot_cache->code_refs[address] != 0)
+    invalidateAot( address);
+}
+
+
+void Chip8::touchPages()
+{
+  for (size_t i = 0; i < 16; ++i)
+    page_clock[i] = write_clock;
+}
+
+
+// drops every cached block whose bytes include 'address'
+void Chip8::invalidateCode( unsigned short address)
+{
+  for (size_t back = 0; back < MAX_BLOCK_LENGTH * 2; ++back)
+  {
+    unsigned short start = (address - back) & 0xFFF;
+    Block *block = block_cache->blocks[start];
+    if (block != NULL && back < block->length * 2u)
+      block_cache->drop( start);
+  }
+}
 
+
+// kills every compiled block whose bytes include 'address'
+void Chip8::invalidateAot( unsigned short address)
+{
+  for (size_t back = 0; back < aot_cache->longest; ++back)
+  {
+    unsigned short start = (address - back) & 0xFFF;
+    const AotBlock *block = aot_cache->entry[start];
+    if (block != NULL && back < block->length * 2u)
+    {
+      aot_cache->entry[start] = NULL;
+      for (size_t i = 0; i < block->length * 2u; ++i)
+        --aot_cache->code_refs[(start + i) & 0xFFF];
+    }
   }
+}
 
+
+void Chip8::op00E0( Chip8 &c, const Instruction &)
+{
+  c.clearScreen();
+  c.pc += 2;
 }
 
 
-void Chip8::buffer_deallocate()
+void Chip8::op00EE( Chip8 &c, const Instruction &)
 {
-  delete [] m_buffer;
-  m_buffer = NULL;
+  c.sp = (c.sp - 1) & 0xF;
+  c.pc = c.stack[c.sp] + 2;
+}
+
 
+void Chip8::op1nnn( Chip8 &c, const Instruction &in)
+{
+  c.pc = in.nnn;
 }
 
 
+void Chip8::op2nnn( Chip8 &c, const Instruction &in)
+{
+  c.stack[c.sp] = c.pc;
+  c.sp = (c.sp + 1) & 0xF;
+  c.pc = in.nnn;
+}
+
+
+void Chip8::op3xkk( Chip8 &c, const Instruction &in)
+{
+  c.pc += (c.V[in.x] == in.kk) ? 4 : 2;
+}
+
+
+void Chip8::op4xkk( Chip8 &c, const Instruction &in)
+{
+  c.pc += (c.V[in.x] != in.kk) ? 4 : 2;
+}
+
+
+void Chip8::op5xy0( Chip8 &c, const Instruction &in)
+{
+  c.pc += (c.V[in.x] == c.V[in.y]) ? 4 : 2;
+}
+
+
+void Chip8::op6xkk( Chip8 &c, const Instruction &in)
+{
+  c.V[in.x] = in.kk;
+  c.pc += 2;
+}
+
+
+void Chip8::op7xkk( Chip8 &c, const Instruction &in)
+{
+  c.V[in.x] += in.kk;
+  c.pc += 2;
+}
+
+
+void Chip8::op8xy0( Chip8 &c, const Instruction &in)
+{
+  c.V[in.x] = c.V[in.y];
+  c.pc += 2;
+}
+
+
+template <unsigned int Q>
+void Chip8::op8xy1( Chip8 &c, const Instruction &in)
+{
+  c.V[in.x] |= c.V[in.y];
+  if (Q & QUIRK_VF_RESET)
+    c.V[0xF] = 0;
+  c.pc += 2;
+}
+
+
+template <unsigned int Q>
+void Chip8::op8xy2( Chip8 &c, const Instruction &in)
+{
+  c.V[in.x] &= c.V[in.y];
+  if (Q & QUIRK_VF_RESET)
+    c.V[0xF] = 0;
+  c.pc += 2;
+}
+
+
+template <unsigned int Q>
+void Chip8::op8xy3( Chip8 &c, const Instruction &in)
+{
+  c.V[in.x] ^= c.V[in.y];
+  if (Q & QUIRK_VF_RESET)
+    c.V[0xF] = 0;
+  c.pc += 2;
+}
+
+
+void Chip8::op8xy4( Chip8 &c, const Instruction &in)
+{
+  // VF is written first, exactly like the switch (matters when x or y is F)
+  c.V[0xF] = (c.V[in.y] > (0xFF - c.V[in.x])) ? 1 : 0; // carry
+  c.V[in.x] += c.V[in.y];
+  c.pc += 2;
+}
+
+
+void Chip8::op8xy5( Chip8 &c, const Instruction &in)
+{
+  c.V[0xF] = (c.V[in.y] > c.V[in.x]) ? 0 : 1; // NOT borrow
+  c.V[in.x] -= c.V[in.y];
+  c.pc += 2;
+}
+
+
+// VF is written first, like the switch, also when shifting Vy
+template <unsigned int Q>
+void Chip8::op8xy6( Chip8 &c, const Instruction &in)
+{
+  unsigned char source = (Q & QUIRK_SHIFT_VY) ? in.y : in.x;
+  c.V[0xF] = (c.V[source] & 0x1);
+  c.V[in.x] = c.V[source] >> 1;
+  c.pc += 2;
+}
+
+
+void Chip8::op8xy7( Chip8 &c, const Instruction &in)
+{
+  c.V[0xF] = (c.V[in.x] > c.V[in.y]) ? 0 : 1; // NOT borrow
+  c.V[in.x] = c.V[in.y] - c.V[in.x];
+  c.pc += 2;
+}
+
+
+template <unsigned int Q>
+void Chip8::op8xyE( Chip8 &c, const Instruction &in)
+{
+  unsigned char source = (Q & QUIRK_SHIFT_VY) ? in.y : in.x;
+  c.V[0xF] = c.V[source] >> 7;
+  c.V[in.x] = c.V[source] << 1;
+  c.pc += 2;
+}
+
 
+void Chip8::op9xy0( Chip8 &c, const Instruction &in)
+{
+  c.pc += (c.V[in.x] != c.V[in.y]) ? 4 : 2;
+}
+
+
+void Chip8::opAnnn( Chip8 &c, const Instruction &in)
+{
+  c.I = in.nnn;
+  c.pc += 2;
+}
+
+
+void Chip8::opBnnn( Chip8 &c, const Instruction &in)
+{
+  c.pc = in.nnn + c.V[0];
+}
+
+
+void Chip8::opCxkk( Chip8 &c, const Instruction &in)
+{
+  c.V[in.x] = c.nextRandom() & in.kk;
+  c.pc += 2;
+}
+
+
+template <unsigned int Q>
+void Chip8::opDxyn( Chip8 &c, const Instruction &in)
+{
+  if (Q & QUIRK_WRAP)
+    c.drawSpriteWrapped( c.V[in.x], c.V[in.y], in.n);
+  else
+    c.drawSprite( c.V[in.x], c.V[in.y], in.n);
+  c.pc += 2;
+}
+
+
+void Chip8::opEx9E( Chip8 &c, const Instruction &in)
+{
+  // a key number above 0xF is never pressed
+  c.pc += (c.V[in.x] < 16 && c.key[c.V[in.x]] != 0) ? 4 : 2;
+}
+
+
+void Chip8::opExA1( Chip8 &c, const Instruction &in)
+{
+  c.pc += (c.V[in.x] >= 16 || c.key[c.V[in.x]] == 0) ? 4 : 2;
+}
+
+
+void Chip8::opFx07( Chip8 &c, const Instruction &in)
+{
+  c.V[in.x] = c.delay_timer;
+  c.pc += 2;
+}
+
+
+void Chip8::opFx0A( Chip8 &c, const Instruction &in)
+{
+  bool key_press = false;
+  for(size_t i = 0; i < 16; ++i)
+  {
+    if(c.key[i] != 0)
+    {
+      c.V[in.x] = i;
+      key_press = true;
+    }
+  }
+  c.waiting_key = !key_press;
+  if(key_press)
+    c.pc += 2;
+}
+
+
+void Chip8::opFx15( Chip8 &c, const Instruction &in)
+{
+  c.delay_timer = c.V[in.x];
+  c.pc += 2;
+}
+
+
+void Chip8::opFx18( Chip8 &c, const Instruction &in)
+{
+  c.sound_timer = c.V[in.x];
+  c.pc += 2;
+}
+
+
+template <unsigned int Q>
+void Chip8::opFx1E( Chip8 &c, const Instruction &in)
+{
+  if (!(Q & QUIRK_NO_ADD_VF))
+    c.V[0xF] = (c.I + c.V[in.x] > 0xFFF) ? 1 : 0;
+  c.I += c.V[in.x];
+  c.pc += 2;
+}
+
+
+void Chip8::opFx29( Chip8 &c, const Instruction &in)
+{
+  c.I = c.V[in.x] * 0x5 + 0x50;
+  c.pc += 2;
+}
+
+
+void Chip8::opFx33( Chip8 &c, const Instruction &in)
+{
+  unsigned char vx = c.V[in.x];
+  c.storeByte( c.I, vx / 100);
+  c.storeByte( c.I+1, (vx % 100) / 10);
+  c.storeByte( c.I+2, vx % 10);
+  c.pc += 2;
+}
+
+
+template <unsigned int Q>
+void Chip8::opFx55( Chip8 &c, const Instruction &in)
+{
+  for (size_t i = 0; i <= in.x; ++i)
+    c.storeByte( c.I+i, c.V[i]);
+  if (!(Q & QUIRK_KEEP_I))
+    c.I += in.x + 1;
+  c.pc += 2;
+}
+
+
+template <unsigned int Q>
+void Chip8::opFx65( Chip8 &c, const Instruction &in)
+{
+  for (size_t i = 0; i <= in.x; ++i)
+    c.V[i] = c.memory[(c.I+i) & 0xFFF];
+  if (!(Q & QUIRK_KEEP_I))
+    c.I += in.x + 1;
+  c.pc += 2;
+}
+
+
+// the handlers Chip8Jit compares against (see Chip8.h)
+template void Chip8::op8xy1<0>( Chip8 &, const Instruction &);
+template void Chip8::op8xy2<0>( Chip8 &, const Instruction &);
+template void Chip8::op8xy3<0>( Chip8 &, const Instruction &);
+template void Chip8::op8xy6<0>( Chip8 &, const Instruction &);
+template void Chip8::op8xyE<0>( Chip8 &, const Instruction &);
+template void Chip8::opFx1E<0>( Chip8 &, const Instruction &);
+
+
+void Chip8::opUnknown( Chip8 &c, const Instruction &)
+{
+  ++c.unknown_opcodes;
+}
+
+
+// unmatched Exxx / Fxxx opcodes are silently ignored by the switch,
+// pc is not advanced
+void Chip8::opIgnored( Chip8 &, const Instruction &)
+{
+}
+
+
+// Draws an 8 x height sprite from memory[I] at (x, y) and sets VF on
+// collision. The start position wraps around the display, the parts of
+// the sprite that run past the right or bottom edge are clipped.
+// Every sprite line becomes a 64-bit row mask with a single shift, then
+// the XOR and the collision AND are done two rows per SSE2 operation.
+void Chip8::drawSprite( unsigned char x, unsigned char y, unsigned char height)
+{
+#ifdef CHIP8_PROFILE
+  Profiler::Timer timer( profiler != NULL ? &profiler->draw : NULL);
+#endif
+
+  uint64_t lines[16];
+  unsigned int left = x % 64;
+  unsigned int top  = y % 32;
+  unsigned int rows = height;
+
+  uint32_t changed = 0;
+
+  if (rows > 32 - top)
+    rows = 32 - top;
+
+  // XOR with a non-empty line always changes the row
+  for (size_t i = 0; i < rows; ++i)
+  {
+    lines[i] = ((uint64_t)memory[(I + i) & 0xFFF] << 56) >> left;
+    if (lines[i] != 0)
+      changed |= 1u << (top + i);
+  }
+
+  uint64_t *screen = &gfx[top];
+  uint64_t hit = 0;
+  size_t i = 0;
+
+#if defined(__SSE2__)
+  __m128i overlap = _mm_setzero_si128();
+  for (; i + 2 <= rows; i += 2)
+  {
+    __m128i old_rows = _mm_loadu_si128( (const __m128i *)&screen[i]);
+    __m128i sprite   = _mm_loadu_si128( (const __m128i *)&lines[i]);
+    overlap = _mm_or_si128( overlap, _mm_and_si128( old_rows, sprite));
+    _mm_storeu_si128( (__m128i *)&screen[i], _mm_xor_si128( old_rows, sprite));
+  }
+  overlap = _mm_or_si128( overlap, _mm_unpackhi_epi64( overlap, overlap));
+  hit = (uint64_t)_mm_cvtsi128_si64( overlap);
+#endif
+
+  for (; i < rows; ++i)
+  {
+    hit |= screen[i] & lines[i];
+    screen[i] ^= lines[i];
+  }
+
+  V[0xF] = (hit != 0) ? 1 : 0;
+
+  if (changed != 0)
+    draw_flag = true;
+
+}
+
+
+// Dxyn with QUIRK_WRAP: pixels past the right edge come back on the
+// left, rows past the bottom at the top
+void Chip8::drawSpriteWrapped( unsigned char x, unsigned char y, unsigned char height)
+{
+#ifdef CHIP8_PROFILE
+  Profiler::Timer timer( profiler != NULL ? &profiler->draw : NULL);
+#endif
+
+  unsigned int left = x % 64;
+  unsigned int top  = y % 32;
+  uint32_t changed = 0;
+  uint64_t hit = 0;
+
+  for (size_t i = 0; i < height; ++i)
+  {
+    uint64_t line = (uint64_t)memory[(I + i) & 0xFFF] << 56;
+    if (left != 0)
+      line = (line >> left) | (line << (64 - left));
+    if (line == 0)
+      continue;
+
+    unsigned int row = (top + i) % 32;
+    hit |= gfx[row] & line;
+    gfx[row] ^= line;
+    changed |= 1u << row;
+  }
+
+  V[0xF] = (hit != 0) ? 1 : 0;
+
+  if (changed != 0)
+    draw_flag = true;
+
+}
+
+
+void Chip8::clearScreen()
+{
+  uint32_t changed = 0;
+
+  for (size_t i = 0; i < 32; ++i)
+  {
+    if (gfx[i] != 0)
+      changed |= 1u << i;
+    gfx[i] = 0;
+  }
+
+  if (changed != 0)
+    draw_flag = true;
+
+}
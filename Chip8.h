@@ -14,10 +14,57 @@
 #ifndef CHIP8_H_
 #define CHIP8_H_
 
+#include <stddef.h>
+#include <stdint.h>
+
+class Profiler;
 
 class Chip8{
 
   friend class EmuGfx;
+  friend class Chip8Jit;
+  friend class Profiler;
+  friend class Chip8Aot;
+  friend class BatchEngine;
+  friend class Chip8Fork;
+  friend class Debugger;
+  friend class TraceRecorder;
+
+  public:
+
+    // Selects how emulateCycle decodes instructions, both produce
+    // identical results so they can be A/B'd on the same ROM
+    enum ExecMode
+    {
+      EXEC_SWITCH, // nested switch on the opcode (reference path)
+      EXEC_TABLE,  // 64K table of predecoded instructions
+      EXEC_BLOCK,  // cached straight-line blocks, used by runCycles
+      EXEC_JIT,    // hot blocks translated to x86-64, used by runCycles
+      EXEC_AOT     // ROMs compiled by aot_Chip8 and linked in, used by runCycles
+    };
+
+    // Interpreters disagree on a few instructions. Each bit selects the
+    // other common behaviour; none set is what the reference switch does.
+    enum Quirk
+    {
+      QUIRK_SHIFT_VY  = 1,  // 8xy6/8xyE shift Vy into Vx instead of Vx in place
+      QUIRK_KEEP_I    = 2,  // Fx55/Fx65 leave I alone instead of I += x + 1
+      QUIRK_NO_ADD_VF = 4,  // Fx1E leaves VF alone instead of flagging I > 0xFFF
+      QUIRK_WRAP      = 8,  // sprites wrap around the screen edges instead of clipping
+      QUIRK_VF_RESET  = 16, // 8xy1/8xy2/8xy3 clear VF
+      QUIRK_ALL       = 31
+    };
+
+    // Takes over runCycles while attached, one at a time: the Debugger
+    // and the TraceRecorder implement it. Going through a virtual call
+    // keeps them out of programs that never link one.
+    class CycleHook
+    {
+      public:
+        virtual void run( unsigned long long cycles) = 0;
+      protected:
+        ~CycleHook() {}
+    };
 
   private:
 
@@ -27,21 +74,139 @@ class Chip8{
     unsigned char V[16]; // 16 general purpose 8-bit registers. VF is used as a flag
     unsigned short I; // 16-bit register, generally used to store memory addresses
     unsigned short pc; // program counter
-    unsigned char gfx[64 * 32]; // graphics buffer
+    uint64_t gfx[32]; // graphics buffer, one row per word, bit 63 is x = 0
+    uint64_t write_clock;    // advanced by every Chip8Fork capture
+    uint64_t page_clock[16]; // write_clock at the last store to each 256-byte page of memory
     unsigned char delay_timer;
     unsigned char sound_timer;
     unsigned short stack[16];
     unsigned short sp; // stack pointer
 
     // helper members
-    unsigned char *m_buffer;
-    size_t m_size;
-    size_t pos;
+    bool waiting_key; // Fx0A is stalled waiting for a key press
+    uint32_t rng_state; // xorshift32 behind Cxkk, never zero
+    unsigned long long unknown_opcodes; // executed, the program went astray
+    bool idle_skip; // runCycles skips passes of idle loops
+    unsigned long long idle_cycles; // skipped that way
+#ifdef CHIP8_PROFILE
+    Profiler *profiler; // NULL unless profiling
+#endif
+    CycleHook *cycle_hook; // a Debugger with anything armed, or a TraceRecorder; runCycles goes through it
+    ExecMode exec_mode;
+    unsigned int quirk_set; // QUIRK_* bits
+    bool switch_path;       // emulateCycle runs the reference switch: EXEC_SWITCH and no quirks
+
+    // A fully decoded opcode: the handler plus every operand already
+    // extracted, so the execute stage never masks or shifts the opcode
+    struct Instruction;
+    typedef void (*OpHandler)( Chip8 &, const Instruction &);
+    struct Instruction
+    {
+      OpHandler exec;
+      unsigned short opcode;
+      unsigned short nnn; // lowest 12 bits
+      unsigned char x;    // lower 4 bits of the high byte
+      unsigned char y;    // upper 4 bits of the low byte
+      unsigned char kk;   // lowest 8 bits
+      unsigned char n;    // lowest 4 bits
+    };
+
+    // One table per quirk set, shared by every instance and built on first
+    // use. Handlers affected by a quirk are templates on the quirk bits
+    // that matter to them, so every set runs specialized code with no
+    // per-instruction check, and sets that agree on an instruction share
+    // its handler.
+    const Instruction *decode_table;
+    static const Instruction *decodeTable( unsigned int quirks);
+    template <unsigned int Q> static const Instruction *buildTable();
+    template <unsigned int Q> static Instruction decodeOpcode( unsigned short opcode);
+
+    // A basic block is a run of straight-line instructions ending with the
+    // first one that may not fall through to pc + 2 (jumps, skips, calls,
+    // returns, Fx0A) or that writes memory (so a store into the block
+    // itself is never followed by stale instructions)
+    static const size_t MAX_BLOCK_LENGTH = 32;
+    typedef void (*NativeBlock)( Chip8 *);
+    struct Block
+    {
+      unsigned short start;
+      unsigned short length; // in instructions
+      unsigned int hits;     // dispatches, decides when the JIT kicks in
+      NativeBlock native;    // translated code, NULL until compiled
+      Instruction ops[MAX_BLOCK_LENGTH];
+    };
+
+    // Predecoded basic blocks keyed by start address, only allocated
+    // once EXEC_BLOCK or EXEC_JIT is selected (see Chip8.cpp)
+    struct BlockCache;
+    BlockCache *block_cache;
+    Block *lookupBlock( unsigned short address);
+    void runBlocks( unsigned long long cycles);
+    void flushBlocks();
+
+    // Entry points of the ahead-of-time compiled program matching the
+    // loaded ROM (see Chip8Aot.h), only allocated once EXEC_AOT is selected
+    struct AotCache;
+    AotCache *aot_cache;
+    void attachAot();
+    void runAot( unsigned long long cycles);
+
+    // cycles of the idle loop at pc that can be skipped (see Chip8.cpp)
+    unsigned long long skipIdle( unsigned long long cycles);
+
+    // every write to memory[] made by an instruction goes through here
+    // so that cached and compiled blocks covering the byte get invalidated
+    void storeByte( unsigned short address, unsigned char value);
+    void invalidateCode( unsigned short address);
+
+    // stamps every page as written now, for bulk writes that bypass storeByte
+    void touchPages();
+    void invalidateAot( unsigned short address);
 
     // helper methods
-    bool readIntoBuffer( const char *strFileName);
-    void decoder( size_t pc);
-    void buffer_deallocate();
+    void emulateCycleTable();
+    void drawSprite( unsigned char x, unsigned char y, unsigned char height);
+    void drawSpriteWrapped( unsigned char x, unsigned char y, unsigned char height);
+    void clearScreen();
+    unsigned char nextRandom();
+
+    // execute stage of the table-driven path, one handler per instruction
+    static void op00E0( Chip8 &c, const Instruction &in);
+    static void op00EE( Chip8 &c, const Instruction &in);
+    static void op1nnn( Chip8 &c, const Instruction &in);
+    static void op2nnn( Chip8 &c, const Instruction &in);
+    static void op3xkk( Chip8 &c, const Instruction &in);
+    static void op4xkk( Chip8 &c, const Instruction &in);
+    static void op5xy0( Chip8 &c, const Instruction &in);
+    static void op6xkk( Chip8 &c, const Instruction &in);
+    static void op7xkk( Chip8 &c, const Instruction &in);
+    static void op8xy0( Chip8 &c, const Instruction &in);
+    template <unsigned int Q> static void op8xy1( Chip8 &c, const Instruction &in);
+    template <unsigned int Q> static void op8xy2( Chip8 &c, const Instruction &in);
+    template <unsigned int Q> static void op8xy3( Chip8 &c, const Instruction &in);
+    static void op8xy4( Chip8 &c, const Instruction &in);
+    static void op8xy5( Chip8 &c, const Instruction &in);
+    template <unsigned int Q> static void op8xy6( Chip8 &c, const Instruction &in);
+    static void op8xy7( Chip8 &c, const Instruction &in);
+    template <unsigned int Q> static void op8xyE( Chip8 &c, const Instruction &in);
+    static void op9xy0( Chip8 &c, const Instruction &in);
+    static void opAnnn( Chip8 &c, const Instruction &in);
+    static void opBnnn( Chip8 &c, const Instruction &in);
+    static void opCxkk( Chip8 &c, const Instruction &in);
+    template <unsigned int Q> static void opDxyn( Chip8 &c, const Instruction &in);
+    static void opEx9E( Chip8 &c, const Instruction &in);
+    static void opExA1( Chip8 &c, const Instruction &in);
+    static void opFx07( Chip8 &c, const Instruction &in);
+    static void opFx0A( Chip8 &c, const Instruction &in);
+    static void opFx15( Chip8 &c, const Instruction &in);
+    static void opFx18( Chip8 &c, const Instruction &in);
+    template <unsigned int Q> static void opFx1E( Chip8 &c, const Instruction &in);
+    static void opFx29( Chip8 &c, const Instruction &in);
+    static void opFx33( Chip8 &c, const Instruction &in);
+    template <unsigned int Q> static void opFx55( Chip8 &c, const Instruction &in);
+    template <unsigned int Q> static void opFx65( Chip8 &c, const Instruction &in);
+    static void opUnknown( Chip8 &c, const Instruction &in);
+    static void opIgnored( Chip8 &c, const Instruction &in);
 
 
     // Chip-8 Fontset
@@ -57,13 +222,82 @@ class Chip8{
     bool draw_flag;
     unsigned char key[16]; // simple HEX keypad
 
+    // initialize() seeds the RNG from the clock, seedRandom() after it
+    // makes a run reproducible (Cxkk is the only source of randomness)
     void initialize();
+    void seedRandom( uint32_t seed);
+    // both false when the program does not fit between 0x200 and the end
+    // of memory; loadGame shares the file through RomCache
     bool loadGame( const char *hexFile);
+    bool loadProgram( const unsigned char *program, size_t size);
     void emulateCycle();
-    void disassembler( const char *hexFile);
+    void runCycles( unsigned long long cycles);
+
+    // timers are not touched by the instructions themselves, the host
+    // calls tickTimers() at 60 Hz (runFrame does both)
+    void tickTimers();
+    void runFrame( unsigned int cycles);
+
+    // the buzzer sounds while the sound timer is non-zero
+    bool soundActive() const { return sound_timer > 0; }
+
+    // packed display, 32 rows of 64 pixels, most significant bit leftmost
+    const uint64_t *gfxRows() const { return gfx; }
+
+    // the 4K memory, read-only; writes have to go through the program
+    const unsigned char *ram() const { return memory; }
+
+    // name of the first piece of machine state that differs, NULL if none
+    const char *diffState( const Chip8 &other) const;
+
+    // Versioned snapshot of the machine: registers, timers, stack,
+    // display, keypad and memory in a fixed little-endian layout of
+    // STATE_SIZE bytes (see saveState in Chip8.cpp). Host bookkeeping
+    // (exec mode, caches, draw flag) is not part of it.
+    static const size_t STATE_SIZE = 4436;
+    static const unsigned short STATE_VERSION = 2;
+    void saveState( unsigned char *state) const;
+
+    // false (and nothing changed) when the snapshot is not a valid
+    // STATE_VERSION one; draw_flag is raised when the display changes
+    bool loadState( const unsigned char *state, size_t size);
+
+    // 64-bit FNV-1a over the same machine state, chained onto 'seed' so a
+    // replay can keep one rolling value per frame
+    uint64_t hashState( uint64_t seed = 0xCBF29CE484222325ULL) const;
+    void setExecMode( ExecMode mode);
+    ExecMode getExecMode() const { return exec_mode; }
+
+    // selects the decode table of a quirk set (see Quirk); with any quirk
+    // set EXEC_SWITCH decodes through the table too, and EXEC_AOT runs
+    // everything through the interpreter since compiled ROMs assume none
+    void setQuirks( unsigned int quirks);
+    unsigned int quirks() const { return quirk_set; }
+    unsigned long long unknownOpcodes() const { return unknown_opcodes; }
+
+    // Idle loops (a jump to itself, Fx0A with no key down, polling the
+    // delay timer) change nothing until the next timer tick or key press,
+    // so runCycles skips their remaining passes in the frame instead of
+    // running them. On by default; the result is the same either way.
+    void setIdleSkip( bool on) { idle_skip = on; }
+    unsigned long long idleCycles() const { return idle_cycles; }
+
+#ifdef CHIP8_PROFILE
+    // while a profiler is attached every instruction goes through
+    // emulateCycle, whatever the exec mode
+    void setProfiler( Profiler *p) { profiler = p; }
+#endif
 
 };
 
+// the quirk-free handlers the JIT recognizes and translates inline
+extern template void Chip8::op8xy1<0>( Chip8 &, const Chip8::Instruction &);
+extern template void Chip8::op8xy2<0>( Chip8 &, const Chip8::Instruction &);
+extern template void Chip8::op8xy3<0>( Chip8 &, const Chip8::Instruction &);
+extern template void Chip8::op8xy6<0>( Chip8 &, const Chip8::Instruction &);
+extern template void Chip8::op8xyE<0>( Chip8 &, const Chip8::Instruction &);
+extern template void Chip8::opFx1E<0>( Chip8 &, const Chip8::Instruction &);
+
 #endif // CHIP8_H_
 
 
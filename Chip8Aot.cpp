@@ -0,0 +1,45 @@
+/**
+ * @brief  CHIP8 EMULATOR PROJECT
+ * @Author esantiago
+ * @date   October, 2026
+ *
+ * @description: Registry of ahead-of-time compiled ROMs
+ */
+
+#include <string.h>
+#include <vector>
+#include "Chip8Aot.h"
+
+using namespace std;
+
+
+// filled during static initialization, read-only afterwards
+static vector<const AotProgram *> &registry()
+{
+  static vector<const AotProgram *> programs;
+  return programs;
+}
+
+
+bool Chip8Aot::add( const AotProgram *program)
+{
+  registry().push_back( program);
+  return true;
+}
+
+
+const AotProgram *Chip8Aot::find( const unsigned char *memory)
+{
+  const vector<const AotProgram *> &programs = registry();
+  const AotProgram *best = NULL;
+
+  for (size_t i = 0; i < programs.size(); ++i)
+  {
+    const AotProgram *p = programs[i];
+    if (p->size <= 4096 - 512 && memcmp( memory + 512, p->image, p->size) == 0 &&
+        (best == NULL || p->size > best->size))
+      best = p;
+  }
+
+  return best;
+}
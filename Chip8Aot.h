@@ -0,0 +1,93 @@
+/**
+ * @brief  CHIP8 EMULATOR PROJECT
+ * @Author esantiago
+ * @date   October, 2026
+ *
+ * @description: Header file for the runtime of ahead-of-time compiled ROMs
+ *
+ * aot_Chip8 (see AotCompiler.h) translates a ROM into a C++ unit with one
+ * function per basic block. Linked into a program, the unit registers
+ * itself here at start-up; a Chip8 in EXEC_AOT mode whose memory holds a
+ * registered image at 0x200 then runs those functions instead of
+ * interpreting, and everything else (other ROMs, addresses that are not a
+ * block entry, blocks whose bytes were overwritten) goes through the
+ * table path.
+ *
+ * The generated code only reaches the machine through the static
+ * functions below, the same operations the interpreter handlers perform.
+ */
+
+#ifndef CHIP8AOT_H_
+#define CHIP8AOT_H_
+
+#include <stddef.h>
+#include "Chip8.h"
+
+
+// runs every instruction of one block and leaves pc at the next one
+typedef void (*AotFunction)( Chip8 &c);
+
+struct AotBlock
+{
+  unsigned short start;
+  unsigned short length; // in instructions, all of them at start + 2 * i
+  AotFunction run;
+};
+
+struct AotProgram
+{
+  const char *name;
+  const unsigned char *image; // the ROM the blocks were compiled from
+  size_t size;
+  const AotBlock *blocks;
+  size_t count;
+};
+
+
+class Chip8Aot{
+
+  public:
+
+    // called by the static initializer of every generated unit
+    static bool add( const AotProgram *program);
+
+    // the registered program (the longest, if several) whose image is
+    // what 'memory' holds at 0x200, NULL if none
+    static const AotProgram *find( const unsigned char *memory);
+
+    // runtime interface of the generated code
+    static unsigned char *V( Chip8 &c) { return c.V; }
+    static unsigned short &I( Chip8 &c) { return c.I; }
+    static unsigned short &pc( Chip8 &c) { return c.pc; }
+    static unsigned char &delayTimer( Chip8 &c) { return c.delay_timer; }
+    static unsigned char &soundTimer( Chip8 &c) { return c.sound_timer; }
+    static const unsigned char *memory( Chip8 &c) { return c.memory; }
+
+    static void clear( Chip8 &c) { c.clearScreen(); }
+    static unsigned char random( Chip8 &c) { return c.nextRandom(); }
+    static void store( Chip8 &c, unsigned short address, unsigned char value) { c.storeByte( address, value); }
+
+    // draws with I = 'i' and returns the new VF
+    static unsigned char draw( Chip8 &c, unsigned short i, unsigned char x, unsigned char y, unsigned char n)
+    {
+      c.I = i;
+      c.drawSprite( x, y, n);
+      return c.V[0xF];
+    }
+
+    static void call( Chip8 &c, unsigned short from)
+    {
+      c.stack[c.sp] = from;
+      c.sp = (c.sp + 1) & 0xF;
+    }
+
+    // the address of the CALL being returned from
+    static unsigned short ret( Chip8 &c)
+    {
+      c.sp = (c.sp - 1) & 0xF;
+      return c.stack[c.sp];
+    }
+
+};
+
+#endif // CHIP8AOT_H_
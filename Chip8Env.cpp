@@ -0,0 +1,314 @@
+/**
+ * @brief  CHIP8 EMULATOR PROJECT
+ * @Author esantiago
+ * @date   October, 2026
+ *
+ * @description: Agent environment API source file
+ */
+
+#include <string.h>
+#include "Chip8Env.h"
+#include "RomCache.h"
+#include "ThreadPool.h"
+
+using namespace std;
+
+
+Chip8Env::Chip8Env()
+  : program(NULL), program_size(0), cycles_per_frame(10), max_frames(0), frames_done(0),
+    reward_hook(NULL), done_hook(NULL), hook_user(NULL)
+{
+  chip8.initialize();
+}
+
+
+bool Chip8Env::load( const char *rom)
+{
+  const RomImage *image = RomCache::instance().load( rom);
+  if (image == NULL)
+    return false;
+
+  return load( image->data, image->size);
+
+}
+
+
+bool Chip8Env::load( const unsigned char *program_data, size_t size)
+{
+  if (size > RomCache::MAX_ROM_SIZE)
+    return false;
+
+  program = program_data;
+  program_size = size;
+  reset( 1);
+  return true;
+
+}
+
+
+void Chip8Env::configure( unsigned int cycles, unsigned long long frames)
+{
+  cycles_per_frame = cycles;
+  max_frames = frames;
+}
+
+
+void Chip8Env::setHooks( Chip8RewardHook reward, Chip8DoneHook done, void *user)
+{
+  reward_hook = reward;
+  done_hook = done;
+  hook_user = user;
+}
+
+
+void Chip8Env::reset( uint32_t seed)
+{
+  chip8.initialize();
+  chip8.seedRandom( seed);
+  if (program != NULL)
+    chip8.loadProgram( program, program_size);
+  frames_done = 0;
+
+}
+
+
+float Chip8Env::step( uint16_t action_mask, unsigned int frames, int &flags)
+{
+  float reward = 0;
+  flags = 0;
+
+  for (size_t k = 0; k < 16; ++k)
+    chip8.key[k] = (action_mask >> k) & 1;
+
+  for (unsigned int f = 0; f < frames; ++f)
+  {
+    chip8.runFrame( cycles_per_frame);
+    ++frames_done;
+
+    if (reward_hook != NULL)
+      reward += reward_hook( chip8.ram(), chip8.gfxRows(), hook_user);
+    if (done_hook != NULL && done_hook( chip8.ram(), chip8.gfxRows(), hook_user) != 0)
+      flags |= CHIP8_DONE;
+    if (max_frames != 0 && frames_done >= max_frames)
+      flags |= CHIP8_TRUNCATED;
+    if (flags != 0)
+      break;
+  }
+
+  return reward;
+
+}
+
+
+Chip8EnvBatch::Chip8EnvBatch( size_t count, size_t threads)
+  : envs(count), seeds(count, 0), pool(NULL), auto_reset(false)
+{
+  for (size_t i = 0; i < count; ++i)
+    envs[i] = new Chip8Env;
+  if (threads > 1 && count > 1)
+    pool = new ThreadPool( threads);
+}
+
+
+Chip8EnvBatch::~Chip8EnvBatch()
+{
+  delete pool;
+  for (size_t i = 0; i < envs.size(); ++i)
+    delete envs[i];
+}
+
+
+bool Chip8EnvBatch::load( const char *rom)
+{
+  const RomImage *image = RomCache::instance().load( rom);
+  if (image == NULL)
+    return false;
+
+  for (size_t i = 0; i < envs.size(); ++i)
+  {
+    if (!envs[i]->load( image->data, image->size))
+      return false;
+  }
+  return true;
+
+}
+
+
+void Chip8EnvBatch::configure( unsigned int cycles_per_frame, unsigned long long max_frames, bool reset_done)
+{
+  for (size_t i = 0; i < envs.size(); ++i)
+    envs[i]->configure( cycles_per_frame, max_frames);
+  auto_reset = reset_done;
+}
+
+
+void Chip8EnvBatch::setHooks( Chip8RewardHook reward, Chip8DoneHook done, void *user)
+{
+  for (size_t i = 0; i < envs.size(); ++i)
+    envs[i]->setHooks( reward, done, user);
+}
+
+
+void Chip8EnvBatch::reset( uint32_t seed)
+{
+  for (size_t i = 0; i < envs.size(); ++i)
+  {
+    seeds[i] = seed + i;
+    envs[i]->reset( seeds[i]);
+  }
+}
+
+
+// Environments are split into one contiguous range per thread, each
+// writing only its own slots of the output arrays
+void Chip8EnvBatch::step( const uint16_t *actions, unsigned int frames, uint64_t *observations, float *rewards,
+                          unsigned char *flags)
+{
+  if (pool == NULL)
+  {
+    stepRange( 0, envs.size(), actions, frames, observations, rewards, flags);
+    return;
+  }
+
+  size_t ranges = pool->size();
+  size_t per_range = (envs.size() + ranges - 1) / ranges;
+  for (size_t first = 0; first < envs.size(); first += per_range)
+  {
+    size_t last = first + per_range < envs.size() ? first + per_range : envs.size();
+    pool->submit( [this, first, last, actions, frames, observations, rewards, flags]()
+                  { stepRange( first, last, actions, frames, observations, rewards, flags); });
+  }
+  pool->wait();
+
+}
+
+
+void Chip8EnvBatch::stepRange( size_t first, size_t last, const uint16_t *actions, unsigned int frames,
+                               uint64_t *observations, float *rewards, unsigned char *flags)
+{
+  for (size_t i = first; i < last; ++i)
+  {
+    Chip8Env &env = *envs[i];
+    int done;
+    float reward = env.step( actions[i], frames, done);
+
+    if (done != 0 && auto_reset)
+    {
+      seeds[i] += envs.size();
+      env.reset( seeds[i]);
+    }
+
+    if (observations != NULL)
+      memcpy( observations + i * 32, env.framebuffer(), 32 * sizeof(uint64_t));
+    if (rewards != NULL)
+      rewards[i] = reward;
+    if (flags != NULL)
+      flags[i] = done;
+  }
+
+}
+
+
+// C entry points
+
+Chip8Env *chip8_env_create( const char *rom)
+{
+  Chip8Env *env = new Chip8Env;
+  if (!env->load( rom))
+  {
+    delete env;
+    return NULL;
+  }
+  return env;
+}
+
+void chip8_env_destroy( Chip8Env *env)
+{
+  delete env;
+}
+
+void chip8_env_configure( Chip8Env *env, unsigned int cycles_per_frame, unsigned long long max_frames)
+{
+  env->configure( cycles_per_frame, max_frames);
+}
+
+void chip8_env_set_hooks( Chip8Env *env, Chip8RewardHook reward, Chip8DoneHook done, void *user)
+{
+  env->setHooks( reward, done, user);
+}
+
+void chip8_env_reset( Chip8Env *env, uint32_t seed)
+{
+  env->reset( seed);
+}
+
+float chip8_env_step( Chip8Env *env, uint16_t action_mask, unsigned int frames, int *flags)
+{
+  int done;
+  float reward = env->step( action_mask, frames, done);
+  if (flags != NULL)
+    *flags = done;
+  return reward;
+}
+
+const uint64_t *chip8_env_framebuffer( const Chip8Env *env)
+{
+  return env->framebuffer();
+}
+
+const unsigned char *chip8_env_ram( const Chip8Env *env)
+{
+  return env->ram();
+}
+
+Chip8EnvBatch *chip8_env_batch_create( const char *rom, size_t envs, size_t threads)
+{
+  Chip8EnvBatch *batch = new Chip8EnvBatch( envs, threads);
+  if (!batch->load( rom))
+  {
+    delete batch;
+    return NULL;
+  }
+  return batch;
+}
+
+void chip8_env_batch_destroy( Chip8EnvBatch *batch)
+{
+  delete batch;
+}
+
+Chip8Env *chip8_env_batch_env( Chip8EnvBatch *batch, size_t index)
+{
+  return &batch->env( index);
+}
+
+void chip8_env_batch_configure( Chip8EnvBatch *batch, unsigned int cycles_per_frame, unsigned long long max_frames,
+                                int auto_reset)
+{
+  batch->configure( cycles_per_frame, max_frames, auto_reset != 0);
+}
+
+void chip8_env_batch_set_hooks( Chip8EnvBatch *batch, Chip8RewardHook reward, Chip8DoneHook done, void *user)
+{
+  batch->setHooks( reward, done, user);
+}
+
+void chip8_env_batch_reset( Chip8EnvBatch *batch, uint32_t seed)
+{
+  batch->reset( seed);
+}
+
+void chip8_env_batch_step( Chip8EnvBatch *batch, const uint16_t *actions, unsigned int frames,
+                           uint64_t *observations, float *rewards, unsigned char *flags)
+{
+  batch->step( actions, frames, observations, rewards, flags);
+}
+
+void chip8_env_unpack( const uint64_t *framebuffer, unsigned char *pixels)
+{
+  for (size_t row = 0; row < 32; ++row)
+  {
+    for (size_t x = 0; x < 64; ++x)
+      pixels[row * 64 + x] = (framebuffer[row] >> (63 - x)) & 1;
+  }
+}
@@ -0,0 +1,174 @@
+/**
+ * @brief  CHIP8 EMULATOR PROJECT
+ * @Author esantiago
+ * @date   October, 2026
+ *
+ * @description: Header file for the agent environment API
+ *
+ * A gym-style wrapper around Chip8 for automated agents, no SDL. An
+ * environment is reset with a seed and stepped with a 16-bit action mask
+ * (bit k holds key k down) for a number of frames. Rewards and episode
+ * ends come from caller hooks that read the machine directly: the
+ * framebuffer and RAM pointers are the core's own arrays, valid for the
+ * life of the environment and never copied.
+ *
+ * Chip8EnvBatch steps many environments, optionally on a thread pool,
+ * and writes the packed observations, rewards and done flags straight
+ * into caller-provided contiguous arrays.
+ *
+ * The same API is available from C through the chip8_env_* functions;
+ * the classes are only declared when compiling as C++.
+ */
+
+#ifndef CHIP8ENV_H_
+#define CHIP8ENV_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// called after every emulated frame of a step, 'framebuffer' is 32 rows
+// of 64 pixels with the most significant bit leftmost, 'ram' the 4K
+// memory. The rewards of a step are summed; a step stops at the first
+// frame the done hook returns non-zero for.
+typedef float (*Chip8RewardHook)( const unsigned char *ram, const uint64_t *framebuffer, void *user);
+typedef int (*Chip8DoneHook)( const unsigned char *ram, const uint64_t *framebuffer, void *user);
+
+// bits of a step's done flags
+enum
+{
+  CHIP8_DONE      = 1, // the done hook ended the episode
+  CHIP8_TRUNCATED = 2  // the episode reached its frame limit
+};
+
+typedef struct Chip8Env Chip8Env;
+typedef struct Chip8EnvBatch Chip8EnvBatch;
+
+// NULL when the ROM cannot be loaded
+Chip8Env *chip8_env_create( const char *rom);
+void chip8_env_destroy( Chip8Env *env);
+void chip8_env_configure( Chip8Env *env, unsigned int cycles_per_frame, unsigned long long max_frames);
+void chip8_env_set_hooks( Chip8Env *env, Chip8RewardHook reward, Chip8DoneHook done, void *user);
+void chip8_env_reset( Chip8Env *env, uint32_t seed);
+// returns the summed reward, '*flags' gets the CHIP8_DONE/CHIP8_TRUNCATED bits
+float chip8_env_step( Chip8Env *env, uint16_t action_mask, unsigned int frames, int *flags);
+const uint64_t *chip8_env_framebuffer( const Chip8Env *env);
+const unsigned char *chip8_env_ram( const Chip8Env *env);
+
+// 'threads' 0 or 1 steps on the calling thread
+Chip8EnvBatch *chip8_env_batch_create( const char *rom, size_t envs, size_t threads);
+void chip8_env_batch_destroy( Chip8EnvBatch *batch);
+Chip8Env *chip8_env_batch_env( Chip8EnvBatch *batch, size_t index);
+void chip8_env_batch_configure( Chip8EnvBatch *batch, unsigned int cycles_per_frame, unsigned long long max_frames,
+                                int auto_reset);
+void chip8_env_batch_set_hooks( Chip8EnvBatch *batch, Chip8RewardHook reward, Chip8DoneHook done, void *user);
+void chip8_env_batch_reset( Chip8EnvBatch *batch, uint32_t seed);
+// 'observations' (envs x 32 rows), 'rewards' and 'flags' (envs each)
+// may be NULL when not wanted
+void chip8_env_batch_step( Chip8EnvBatch *batch, const uint16_t *actions, unsigned int frames,
+                           uint64_t *observations, float *rewards, unsigned char *flags);
+
+// one byte per pixel (0 or 1), 64 x 32 row-major, for network inputs
+void chip8_env_unpack( const uint64_t *framebuffer, unsigned char *pixels);
+
+#ifdef __cplusplus
+}
+
+#include <vector>
+#include "Chip8.h"
+
+class ThreadPool;
+
+
+struct Chip8Env{
+
+  public:
+
+    Chip8Env();
+
+    // the program is shared through RomCache, or owned by the caller and
+    // kept alive for as long as the environment; false when it does not fit
+    bool load( const char *rom);
+    bool load( const unsigned char *program, size_t size);
+
+    // 10 instructions per 60 Hz frame and no frame limit by default
+    void configure( unsigned int cycles_per_frame, unsigned long long max_frames);
+    void setHooks( Chip8RewardHook reward, Chip8DoneHook done, void *user);
+    void setExecMode( Chip8::ExecMode mode) { chip8.setExecMode( mode); }
+
+    // a fresh machine with the program loaded and the RNG seeded
+    void reset( uint32_t seed);
+
+    // holds the keys in 'action_mask' for 'frames' frames; returns the
+    // summed reward, 'flags' gets the CHIP8_DONE/CHIP8_TRUNCATED bits
+    float step( uint16_t action_mask, unsigned int frames, int &flags);
+
+    const uint64_t *framebuffer() const { return chip8.gfxRows(); }
+    const unsigned char *ram() const { return chip8.ram(); }
+    unsigned long long frame() const { return frames_done; }
+    const Chip8 &machine() const { return chip8; }
+
+  private:
+
+    Chip8 chip8;
+    const unsigned char *program;
+    size_t program_size;
+    unsigned int cycles_per_frame;
+    unsigned long long max_frames;
+    unsigned long long frames_done;
+    Chip8RewardHook reward_hook;
+    Chip8DoneHook done_hook;
+    void *hook_user;
+
+    Chip8Env( const Chip8Env &);
+    Chip8Env &operator=( const Chip8Env &);
+
+};
+
+
+struct Chip8EnvBatch{
+
+  public:
+
+    // 'threads' 0 or 1 steps on the calling thread
+    Chip8EnvBatch( size_t envs, size_t threads);
+    ~Chip8EnvBatch();
+
+    bool load( const char *rom);
+    size_t size() const { return envs.size(); }
+    Chip8Env &env( size_t index) { return *envs[index]; }
+
+    // with auto_reset an environment that finished a step is reset, its
+    // seed advanced by the number of environments, before the observation
+    // is written, so the observation is the first frame of its next episode
+    void configure( unsigned int cycles_per_frame, unsigned long long max_frames, bool auto_reset);
+    void setHooks( Chip8RewardHook reward, Chip8DoneHook done, void *user);
+
+    // environment i is seeded with seed + i
+    void reset( uint32_t seed);
+
+    // any output may be NULL; observations get 32 rows per environment
+    void step( const uint16_t *actions, unsigned int frames, uint64_t *observations, float *rewards,
+               unsigned char *flags);
+
+  private:
+
+    std::vector<Chip8Env *> envs;
+    std::vector<uint32_t> seeds; // last seed per environment, for auto reset
+    ThreadPool *pool;            // NULL on a single thread
+    bool auto_reset;
+
+    void stepRange( size_t first, size_t last, const uint16_t *actions, unsigned int frames,
+                    uint64_t *observations, float *rewards, unsigned char *flags);
+
+    Chip8EnvBatch( const Chip8EnvBatch &);
+    Chip8EnvBatch &operator=( const Chip8EnvBatch &);
+
+};
+
+#endif // __cplusplus
+
+#endif // CHIP8ENV_H_
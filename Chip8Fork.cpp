@@ -0,0 +1,230 @@
+/**
+ * @brief  CHIP8 EMULATOR PROJECT
+ * @Author esantiago
+ * @date   October, 2026
+ *
+ * @description: Copy-on-write Chip8 state source file
+ */
+
+#include <string.h>
+#include "Chip8Fork.h"
+
+using namespace std;
+
+
+static inline uint64_t fnv( uint64_t hash, uint64_t value)
+{
+  return (hash ^ value) * 0x100000001B3ULL;
+}
+
+
+static uint64_t hashBytes( const unsigned char *bytes, size_t size, uint64_t hash)
+{
+  uint64_t word;
+  for (size_t i = 0; i < size; i += 8)
+  {
+    memcpy( &word, bytes + i, 8);
+    hash = fnv( hash, word);
+  }
+  return hash;
+}
+
+
+Chip8Fork::Page *Chip8Fork::newPage( const void *bytes)
+{
+  Page *page = new Page;
+  page->refs.store( 1, memory_order_relaxed);
+  memcpy( page->bytes, bytes, PAGE_SIZE);
+  page->hash = hashBytes( page->bytes, PAGE_SIZE, 0xCBF29CE484222325ULL);
+  return page;
+}
+
+
+// pages are shared between threads once published, the last owner frees
+void Chip8Fork::release( Page *page)
+{
+  if (page != NULL && page->refs.fetch_sub( 1, memory_order_acq_rel) == 1)
+    delete page;
+}
+
+
+Chip8Fork::Chip8Fork()
+  : opcode(0), draw_flag(false), unknown_opcodes(0), source(NULL), source_clock(0), state_hash(0),
+    copied(0)
+{
+  memset( &core, 0, sizeof(core));
+  for (size_t i = 0; i <= PAGES; ++i)
+    pages[i] = NULL;
+}
+
+
+Chip8Fork::Chip8Fork( Chip8 &chip8)
+  : opcode(0), draw_flag(false), unknown_opcodes(0), source(NULL), source_clock(0), state_hash(0),
+    copied(0)
+{
+  memset( &core, 0, sizeof(core));
+  for (size_t i = 0; i <= PAGES; ++i)
+    pages[i] = NULL;
+
+  capture( chip8);
+}
+
+
+Chip8Fork::Chip8Fork( const Chip8Fork &other)
+  : core(other.core), opcode(other.opcode), draw_flag(other.draw_flag),
+    unknown_opcodes(other.unknown_opcodes), source(other.source), source_clock(other.source_clock),
+    state_hash(other.state_hash), copied(0)
+{
+  for (size_t i = 0; i <= PAGES; ++i)
+  {
+    pages[i] = other.pages[i];
+    if (pages[i] != NULL)
+      pages[i]->refs.fetch_add( 1, memory_order_relaxed);
+  }
+}
+
+
+Chip8Fork &Chip8Fork::operator=( const Chip8Fork &other)
+{
+  // take the new references first, 'other' may share pages with this one
+  for (size_t i = 0; i <= PAGES; ++i)
+  {
+    if (other.pages[i] != NULL)
+      other.pages[i]->refs.fetch_add( 1, memory_order_relaxed);
+    release( pages[i]);
+    pages[i] = other.pages[i];
+  }
+  core = other.core;
+  opcode = other.opcode;
+  draw_flag = other.draw_flag;
+  unknown_opcodes = other.unknown_opcodes;
+  source = other.source;
+  source_clock = other.source_clock;
+  state_hash = other.state_hash;
+  copied = 0;
+  return *this;
+}
+
+
+Chip8Fork::~Chip8Fork()
+{
+  for (size_t i = 0; i <= PAGES; ++i)
+    release( pages[i]);
+}
+
+
+void Chip8Fork::setPage( size_t index, const void *bytes)
+{
+  // written and then put back as it was, keep sharing
+  if (pages[index] != NULL && memcmp( pages[index]->bytes, bytes, PAGE_SIZE) == 0)
+    return;
+
+  release( pages[index]);
+  pages[index] = newPage( bytes);
+  ++copied;
+}
+
+
+void Chip8Fork::rehash()
+{
+  uint64_t hash = hashBytes( reinterpret_cast<const unsigned char *>( &core), sizeof(core),
+                             0xCBF29CE484222325ULL);
+  for (size_t i = 0; i <= PAGES; ++i)
+    hash = fnv( hash, pages[i]->hash);
+  state_hash = hash;
+}
+
+
+void Chip8Fork::capture( Chip8 &chip8)
+{
+  memcpy( core.V, chip8.V, 16);
+  memcpy( core.key, chip8.key, 16);
+  memcpy( core.stack, chip8.stack, sizeof(core.stack));
+  core.I = chip8.I;
+  core.pc = chip8.pc;
+  core.sp = chip8.sp;
+  core.delay_timer = chip8.delay_timer;
+  core.sound_timer = chip8.sound_timer;
+  core.rng_state = chip8.rng_state;
+  core.waiting_key = chip8.waiting_key;
+  memset( core.zero, 0, sizeof(core.zero));
+  opcode = chip8.opcode;
+  draw_flag = chip8.draw_flag;
+  unknown_opcodes = chip8.unknown_opcodes;
+
+  // pages stamped before source_clock are as this fork holds them: every
+  // store since went through storeByte and stamped its page again
+  bool same_source = source == &chip8;
+  copied = 0;
+  for (size_t i = 0; i < PAGES; ++i)
+  {
+    if (!same_source || pages[i] == NULL || chip8.page_clock[i] >= source_clock)
+      setPage( i, chip8.memory + i * PAGE_SIZE);
+  }
+  source = &chip8;
+  source_clock = ++chip8.write_clock;
+
+  // the display is not tracked by page, comparing it is as cheap
+  setPage( PAGES, chip8.gfx);
+
+  rehash();
+
+}
+
+
+void Chip8Fork::restore( Chip8 &chip8) const
+{
+  memcpy( chip8.V, core.V, 16);
+  memcpy( chip8.key, core.key, 16);
+  memcpy( chip8.stack, core.stack, sizeof(core.stack));
+  chip8.I = core.I;
+  chip8.pc = core.pc;
+  chip8.sp = core.sp;
+  chip8.delay_timer = core.delay_timer;
+  chip8.sound_timer = core.sound_timer;
+  chip8.rng_state = core.rng_state;
+  chip8.waiting_key = core.waiting_key != 0;
+  chip8.opcode = opcode;
+  chip8.unknown_opcodes = unknown_opcodes;
+
+  // as in loadState, only bytes that differ are stored
+  for (size_t i = 0; i < PAGES; ++i)
+  {
+    unsigned char *dst = chip8.memory + i * PAGE_SIZE;
+    const unsigned char *src = pages[i]->bytes;
+    if (memcmp( dst, src, PAGE_SIZE) == 0)
+      continue;
+    for (size_t b = 0; b < PAGE_SIZE; ++b)
+    {
+      if (dst[b] != src[b])
+        chip8.storeByte( i * PAGE_SIZE + b, src[b]);
+    }
+  }
+
+  const uint64_t *rows = reinterpret_cast<const uint64_t *>( pages[PAGES]->bytes);
+  uint32_t changed = 0;
+  for (size_t row = 0; row < 32; ++row)
+  {
+    if (chip8.gfx[row] != rows[row])
+      changed |= 1u << row;
+    chip8.gfx[row] = rows[row];
+  }
+  chip8.draw_flag = draw_flag || changed != 0;
+
+}
+
+
+bool Chip8Fork::sameState( const Chip8Fork &other) const
+{
+  if (state_hash != other.state_hash || memcmp( &core, &other.core, sizeof(core)) != 0)
+    return false;
+
+  for (size_t i = 0; i <= PAGES; ++i)
+  {
+    if (pages[i] != other.pages[i] &&
+        memcmp( pages[i]->bytes, other.pages[i]->bytes, PAGE_SIZE) != 0)
+      return false;
+  }
+  return true;
+
+}
@@ -0,0 +1,124 @@
+/**
+ * @brief  CHIP8 EMULATOR PROJECT
+ * @Author esantiago
+ * @date   October, 2026
+ *
+ * @description: Header file for copy-on-write Chip8 states
+ *
+ * A Chip8Fork is a machine state that search code can branch from
+ * cheaply. Memory is split into sixteen 256-byte pages and the display
+ * into one more, each immutable and reference counted, so a fork is the
+ * registers plus seventeen page pointers: copying one copies about two
+ * hundred bytes and shares every page, including the font and the ROM.
+ *
+ * To expand a state it is restored into a worker Chip8, run, and then
+ * captured again. The core stamps every page it stores to with its write
+ * clock (see storeByte), and a capture advances the clock. A fork keeps
+ * the machine and the clock of its last capture and only copies the pages
+ * stamped since then, so any number of forks can follow one machine
+ * without seeing each other's captures. A frame usually writes none or
+ * one of them, plus the display when something was drawn.
+ *
+ * Every page keeps the hash of its contents, so the hash of a state,
+ * taken for transposition tables, costs seventeen combines instead of a
+ * pass over 4K. Equal states hash the same whichever pages they share.
+ */
+
+#ifndef CHIP8FORK_H_
+#define CHIP8FORK_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include "Chip8.h"
+
+
+class Chip8Fork{
+
+  public:
+
+    // holds no state until captured
+    Chip8Fork();
+
+    // the whole machine, every page copied; 'chip8' can be captured into
+    // this fork from here on
+    explicit Chip8Fork( Chip8 &chip8);
+
+    // copies share every page with 'other'
+    Chip8Fork( const Chip8Fork &other);
+    Chip8Fork &operator=( const Chip8Fork &other);
+    ~Chip8Fork();
+
+    Chip8Fork clone() const { return *this; }
+    bool empty() const { return pages[0] == NULL; }
+
+    // puts this state into 'chip8'. Only bytes that differ go through the
+    // core, so its decoded blocks survive when the code is the same.
+    // draw_flag is restored, and raised when the display changes.
+    void restore( Chip8 &chip8) const;
+
+    // takes the state of 'chip8'. Only pages written since this fork (or
+    // the one it was copied from) last captured 'chip8' are copied, every
+    // page is compared when it last captured another machine.
+    void capture( Chip8 &chip8);
+
+    // pages the last capture had to copy
+    unsigned int copiedPages() const { return copied; }
+
+    uint64_t hash() const { return state_hash; }
+
+    // same machine state, for telling hash collisions apart
+    bool sameState( const Chip8Fork &other) const;
+
+    static const size_t PAGE_SIZE = 256;
+    static const size_t PAGES = 4096 / PAGE_SIZE; // the display is page PAGES
+
+  private:
+
+    struct Page
+    {
+      std::atomic<unsigned int> refs;
+      uint64_t hash;
+      unsigned char bytes[PAGE_SIZE];
+    };
+
+    // everything but memory and display, laid out without implicit
+    // padding so it compares and hashes as bytes
+    struct Core
+    {
+      unsigned char V[16];
+      unsigned char key[16];
+      unsigned short stack[16];
+      unsigned short I;
+      unsigned short pc;
+      unsigned short sp;
+      unsigned char delay_timer;
+      unsigned char sound_timer;
+      uint32_t rng_state;
+      unsigned char waiting_key;
+      unsigned char zero[3];
+    };
+
+    Core core;
+    Page *pages[PAGES + 1];
+
+    // restored with the state, but not hashed or compared: states reached
+    // through different paths are the same even if one of them ran more
+    // unknown opcodes
+    unsigned short opcode;
+    bool draw_flag;
+    unsigned long long unknown_opcodes;
+
+    const Chip8 *source;   // the machine last captured, NULL if none
+    uint64_t source_clock; // its write_clock right after that capture
+    uint64_t state_hash;
+    unsigned int copied;
+
+    static Page *newPage( const void *bytes);
+    static void release( Page *page);
+    void setPage( size_t index, const void *bytes);
+    void rehash();
+
+};
+
+#endif // CHIP8FORK_H_
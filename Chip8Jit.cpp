@@ -0,0 +1,374 @@
+/**
+ * @brief  CHIP8 EMULATOR PROJECT
+ * @Author esantiago
+ * @date   October, 2026
+ *
+ * @description: x86-64 dynamic recompiler source file
+ *
+ * Register use inside a translated block (System V ABI):
+ *   rbx      - Chip8 instance (callee saved, survives interpreter calls)
+ *   eax..edx - scratch
+ */
+
+#include <string.h>
+#include <sys/mman.h>
+#include "Chip8Jit.h"
+
+using namespace std;
+
+
+// executable memory per instance, a full buffer flushes the block cache
+static const size_t JIT_BUFFER_SIZE = 1 << 20;
+
+// upper bound of the bytes one instruction translates to
+static const size_t JIT_MAX_OP_BYTES = 64;
+
+enum NativeKind
+{
+  NOT_NATIVE,        // goes through the interpreter
+  NATIVE_FALLTHROUGH, // continues at pc + 2
+  NATIVE_BRANCH      // writes pc itself
+};
+
+
+Chip8Jit::Chip8Jit()
+  : code(NULL), capacity(0), used(0), out_of_space(false), out(NULL), base(NULL)
+{
+#if defined(__x86_64__)
+  void *buffer = mmap( NULL, JIT_BUFFER_SIZE, PROT_READ | PROT_WRITE | PROT_EXEC,
+                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (buffer != MAP_FAILED)
+  {
+    code = (unsigned char *)buffer;
+    capacity = JIT_BUFFER_SIZE;
+  }
+#endif
+}
+
+
+Chip8Jit::~Chip8Jit()
+{
+  if (code != NULL)
+    munmap( code, capacity);
+  code = NULL;
+}
+
+
+void Chip8Jit::reset()
+{
+  used = 0;
+  out_of_space = false;
+}
+
+
+// executes one instruction exactly like runBlocks would
+void Chip8Jit::fallback( Chip8 *chip8, const Chip8::Instruction *in)
+{
+  chip8->opcode = in->opcode;
+  in->exec( *chip8, *in);
+}
+
+
+bool Chip8Jit::compile( Chip8 &chip8, Chip8::Block &block)
+{
+#if defined(__x86_64__)
+  if (code == NULL)
+    return false;
+
+  if (capacity - used < Chip8::MAX_BLOCK_LENGTH * JIT_MAX_OP_BYTES + 128)
+  {
+    out_of_space = true;
+    return false;
+  }
+
+  out = code + used;
+  base = (const unsigned char *)&chip8;
+
+  unsigned char *entry = out;
+  emit8( 0x53);                               // push rbx
+  emit8( 0x48); emit8( 0x89); emit8( 0xFB);   // mov rbx, rdi
+
+  int kind = NOT_NATIVE;
+  for (size_t i = 0; i < block.length; ++i)
+  {
+    const Chip8::Instruction &in = block.ops[i];
+    unsigned short pc = block.start + 2 * i;
+
+    kind = emitNative( chip8, in, pc);
+    if (kind == NOT_NATIVE)
+    {
+      // the handler expects pc to be up to date
+      emitStorePc( pc);
+      emitCall( &in);
+    }
+  }
+
+  if (kind == NATIVE_FALLTHROUGH)
+    emitStorePc( block.start + 2 * block.length);
+
+  if (kind != NOT_NATIVE)
+  {
+    // opcode keeps the last executed instruction, as in the interpreter
+    emit8( 0x66); emit8( 0xC7); emitModRM( 0, &chip8.opcode);
+    emit16( block.ops[block.length - 1].opcode);
+  }
+
+  emit8( 0x5B);                               // pop rbx
+  emit8( 0xC3);                               // ret
+
+  used = out - code;
+  block.native = (Chip8::NativeBlock)entry;
+  return true;
+#else
+  return false;
+#endif
+}
+
+
+int Chip8Jit::offset( const void *field) const
+{
+  return (int)((const unsigned char *)field - base);
+}
+
+
+void Chip8Jit::emit8( unsigned char byte)
+{
+  *out++ = byte;
+}
+
+
+void Chip8Jit::emit16( unsigned short word)
+{
+  memcpy( out, &word, 2);
+  out += 2;
+}
+
+
+void Chip8Jit::emit32( unsigned int dword)
+{
+  memcpy( out, &dword, 4);
+  out += 4;
+}
+
+
+void Chip8Jit::emit64( unsigned long long qword)
+{
+  memcpy( out, &qword, 8);
+  out += 8;
+}
+
+
+// [rbx + disp32] operand with 'reg' in the reg field
+void Chip8Jit::emitModRM( unsigned char reg, const void *field)
+{
+  emit8( 0x80 | (reg << 3) | 0x3);
+  emit32( offset( field));
+}
+
+
+void Chip8Jit::emitStorePc( unsigned short pc)
+{
+  const Chip8 *c = (const Chip8 *)base;
+  emit8( 0x66); emit8( 0xC7); emitModRM( 0, &c->pc);       // mov word [pc], imm16
+  emit16( pc);
+}
+
+
+void Chip8Jit::emitCall( const Chip8::Instruction *in)
+{
+  emit8( 0x48); emit8( 0x89); emit8( 0xDF);                // mov rdi, rbx
+  emit8( 0x48); emit8( 0xBE); emit64( (unsigned long long)in);        // mov rsi, in
+  emit8( 0x48); emit8( 0xB8); emit64( (unsigned long long)&fallback); // mov rax, fallback
+  emit8( 0xFF); emit8( 0xD0);                              // call rax
+}
+
+
+// pc = condition ? pc + 4 : pc + 2, flags already set by the caller
+void Chip8Jit::emitSkip( unsigned short pc, unsigned char cmov)
+{
+  const Chip8 *c = (const Chip8 *)base;
+  emit8( 0xB8); emit32( pc + 2);                           // mov eax, pc + 2
+  emit8( 0xB9); emit32( pc + 4);                           // mov ecx, pc + 4
+  emit8( 0x0F); emit8( cmov); emit8( 0xC1);                // cmovcc eax, ecx
+  emit8( 0x66); emit8( 0x89); emitModRM( 0, &c->pc);       // mov [pc], ax
+}
+
+
+// Emits the instruction inline when it is simple enough. Every sequence
+// writes VF before re-reading the operands, like the interpreter does,
+// so x or y being F gives the same result.
+int Chip8Jit::emitNative( Chip8 &c, const Chip8::Instruction &in, unsigned short pc)
+{
+  const unsigned char *vx = &c.V[in.x];
+  const unsigned char *vy = &c.V[in.y];
+  const unsigned char *vf = &c.V[0xF];
+
+  if (in.exec == &Chip8::op6xkk)
+  {
+    emit8( 0xC6); emitModRM( 0, vx); emit8( in.kk);        // mov byte [vx], kk
+    return NATIVE_FALLTHROUGH;
+  }
+
+  if (in.exec == &Chip8::op7xkk)
+  {
+    emit8( 0x80); emitModRM( 0, vx); emit8( in.kk);        // add byte [vx], kk
+    return NATIVE_FALLTHROUGH;
+  }
+
+  if (in.exec == &Chip8::op8xy0 || in.exec == &Chip8::op8xy1<0> ||
+      in.exec == &Chip8::op8xy2<0> || in.exec == &Chip8::op8xy3<0>)
+  {
+    unsigned char alu = 0x88;                              // mov
+    if (in.exec == &Chip8::op8xy1<0>) alu = 0x08;          // or
+    if (in.exec == &Chip8::op8xy2<0>) alu = 0x20;          // and
+    if (in.exec == &Chip8::op8xy3<0>) alu = 0x30;          // xor
+    emit8( 0x8A); emitModRM( 0, vy);                       // mov al, [vy]
+    emit8( alu); emitModRM( 0, vx);                        // op [vx], al
+    return NATIVE_FALLTHROUGH;
+  }
+
+  if (in.exec == &Chip8::op8xy4)
+  {
+    emit8( 0x8A); emitModRM( 0, vx);                       // mov al, [vx]
+    emit8( 0x02); emitModRM( 0, vy);                       // add al, [vy]
+    emit8( 0x0F); emit8( 0x92); emit8( 0xC2);              // setc dl
+    emit8( 0x88); emitModRM( 2, vf);                       // mov [vf], dl
+    emit8( 0x8A); emitModRM( 0, vy);                       // mov al, [vy]
+    emit8( 0x00); emitModRM( 0, vx);                       // add [vx], al
+    return NATIVE_FALLTHROUGH;
+  }
+
+  if (in.exec == &Chip8::op8xy5)
+  {
+    emit8( 0x8A); emitModRM( 0, vx);                       // mov al, [vx]
+    emit8( 0x3A); emitModRM( 0, vy);                       // cmp al, [vy]
+    emit8( 0x0F); emit8( 0x93); emit8( 0xC2);              // setae dl
+    emit8( 0x88); emitModRM( 2, vf);                       // mov [vf], dl
+    emit8( 0x8A); emitModRM( 0, vy);                       // mov al, [vy]
+    emit8( 0x28); emitModRM( 0, vx);                       // sub [vx], al
+    return NATIVE_FALLTHROUGH;
+  }
+
+  if (in.exec == &Chip8::op8xy7)
+  {
+    emit8( 0x8A); emitModRM( 0, vy);                       // mov al, [vy]
+    emit8( 0x3A); emitModRM( 0, vx);                       // cmp al, [vx]
+    emit8( 0x0F); emit8( 0x93); emit8( 0xC2);              // setae dl
+    emit8( 0x88); emitModRM( 2, vf);                       // mov [vf], dl
+    emit8( 0x8A); emitModRM( 0, vy);                       // mov al, [vy]
+    emit8( 0x2A); emitModRM( 0, vx);                       // sub al, [vx]
+    emit8( 0x88); emitModRM( 0, vx);                       // mov [vx], al
+    return NATIVE_FALLTHROUGH;
+  }
+
+  if (in.exec == &Chip8::op8xy6<0>)
+  {
+    emit8( 0x8A); emitModRM( 0, vx);                       // mov al, [vx]
+    emit8( 0x24); emit8( 0x01);                            // and al, 1
+    emit8( 0x88); emitModRM( 0, vf);                       // mov [vf], al
+    emit8( 0xD0); emitModRM( 5, vx);                       // shr byte [vx], 1
+    return NATIVE_FALLTHROUGH;
+  }
+
+  if (in.exec == &Chip8::op8xyE<0>)
+  {
+    emit8( 0x8A); emitModRM( 0, vx);                       // mov al, [vx]
+    emit8( 0xC0); emit8( 0xE8); emit8( 0x07);              // shr al, 7
+    emit8( 0x88); emitModRM( 0, vf);                       // mov [vf], al
+    emit8( 0xD0); emitModRM( 4, vx);                       // shl byte [vx], 1
+    return NATIVE_FALLTHROUGH;
+  }
+
+  if (in.exec == &Chip8::opAnnn)
+  {
+    emit8( 0x66); emit8( 0xC7); emitModRM( 0, &c.I);       // mov word [I], nnn
+    emit16( in.nnn);
+    return NATIVE_FALLTHROUGH;
+  }
+
+  if (in.exec == &Chip8::opFx1E<0>)
+  {
+    emit8( 0x0F); emit8( 0xB7); emitModRM( 0, &c.I);       // movzx eax, word [I]
+    emit8( 0x0F); emit8( 0xB6); emitModRM( 1, vx);         // movzx ecx, byte [vx]
+    emit8( 0x01); emit8( 0xC8);                            // add eax, ecx
+    emit8( 0x3D); emit32( 0xFFF);                          // cmp eax, 0xFFF
+    emit8( 0x0F); emit8( 0x97); emit8( 0xC2);              // seta dl
+    emit8( 0x88); emitModRM( 2, vf);                       // mov [vf], dl
+    emit8( 0x0F); emit8( 0xB6); emitModRM( 1, vx);         // movzx ecx, byte [vx]
+    emit8( 0x66); emit8( 0x01); emitModRM( 1, &c.I);       // add [I], cx
+    return NATIVE_FALLTHROUGH;
+  }
+
+  if (in.exec == &Chip8::opFx29)
+  {
+    emit8( 0x0F); emit8( 0xB6); emitModRM( 0, vx);         // movzx eax, byte [vx]
+    emit8( 0x8D); emit8( 0x44); emit8( 0x80); emit8( 0x50); // lea eax, [rax + rax*4 + 0x50]
+    emit8( 0x66); emit8( 0x89); emitModRM( 0, &c.I);       // mov [I], ax
+    return NATIVE_FALLTHROUGH;
+  }
+
+  if (in.exec == &Chip8::opFx07)
+  {
+    emit8( 0x8A); emitModRM( 0, &c.delay_timer);           // mov al, [delay_timer]
+    emit8( 0x88); emitModRM( 0, vx);                       // mov [vx], al
+    return NATIVE_FALLTHROUGH;
+  }
+
+  if (in.exec == &Chip8::opFx15 || in.exec == &Chip8::opFx18)
+  {
+    const unsigned char *timer = (in.exec == &Chip8::opFx15) ? &c.delay_timer : &c.sound_timer;
+    emit8( 0x8A); emitModRM( 0, vx);                       // mov al, [vx]
+    emit8( 0x88); emitModRM( 0, timer);                    // mov [timer], al
+    return NATIVE_FALLTHROUGH;
+  }
+
+  if (in.exec == &Chip8::op1nnn)
+  {
+    emitStorePc( in.nnn);
+    return NATIVE_BRANCH;
+  }
+
+  if (in.exec == &Chip8::op2nnn)
+  {
+    emit8( 0x0F); emit8( 0xB7); emitModRM( 0, &c.sp);      // movzx eax, word [sp]
+    emit8( 0xB9); emit32( pc);                             // mov ecx, pc
+    emit8( 0x66); emit8( 0x89); emit8( 0x8C); emit8( 0x43); // mov [rbx + rax*2 + stack], cx
+    emit32( offset( c.stack));
+    emit8( 0xFF); emit8( 0xC0);                            // inc eax
+    emit8( 0x83); emit8( 0xE0); emit8( 0x0F);              // and eax, 0xF
+    emit8( 0x66); emit8( 0x89); emitModRM( 0, &c.sp);      // mov [sp], ax
+    emitStorePc( in.nnn);
+    return NATIVE_BRANCH;
+  }
+
+  if (in.exec == &Chip8::op00EE)
+  {
+    emit8( 0x0F); emit8( 0xB7); emitModRM( 0, &c.sp);      // movzx eax, word [sp]
+    emit8( 0xFF); emit8( 0xC8);                            // dec eax
+    emit8( 0x83); emit8( 0xE0); emit8( 0x0F);              // and eax, 0xF
+    emit8( 0x66); emit8( 0x89); emitModRM( 0, &c.sp);      // mov [sp], ax
+    emit8( 0x0F); emit8( 0xB7); emit8( 0x8C); emit8( 0x43); // movzx ecx, word [rbx + rax*2 + stack]
+    emit32( offset( c.stack));
+    emit8( 0x83); emit8( 0xC1); emit8( 0x02);              // add ecx, 2
+    emit8( 0x66); emit8( 0x89); emitModRM( 1, &c.pc);      // mov [pc], cx
+    return NATIVE_BRANCH;
+  }
+
+  if (in.exec == &Chip8::op3xkk || in.exec == &Chip8::op4xkk)
+  {
+    emit8( 0x80); emitModRM( 7, vx); emit8( in.kk);        // cmp byte [vx], kk
+    emitSkip( pc, in.exec == &Chip8::op3xkk ? 0x44 : 0x45); // cmove / cmovne
+    return NATIVE_BRANCH;
+  }
+
+  if (in.exec == &Chip8::op5xy0 || in.exec == &Chip8::op9xy0)
+  {
+    emit8( 0x8A); emitModRM( 0, vx);                       // mov al, [vx]
+    emit8( 0x3A); emitModRM( 0, vy);                       // cmp al, [vy]
+    emitSkip( pc, in.exec == &Chip8::op5xy0 ? 0x44 : 0x45); // cmove / cmovne
+    return NATIVE_BRANCH;
+  }
+
+  return NOT_NATIVE;
+
+}
@@ -0,0 +1,76 @@
+/**
+ * @brief  CHIP8 EMULATOR PROJECT
+ * @Author esantiago
+ * @date   October, 2026
+ *
+ * @description: Header file for the x86-64 dynamic recompiler
+ *
+ * Translates hot basic blocks of the block cache into native code. The
+ * translated function receives the Chip8 instance and keeps it pinned in
+ * rbx for the whole block; registers, I, sp and the timers are operated
+ * on in place through rbx-relative operands and pc is known statically,
+ * so only the final pc is ever written back. Instructions with complex
+ * side effects (Dxyn, Fx0A, the memory stores, key checks, RND, Bnnn)
+ * call back into the interpreter handlers. Self-modifying code is handled
+ * by the block cache, which drops the block (and its translation) as soon
+ * as one of its bytes is written.
+ *
+ * On anything but x86-64 compile() always fails and the blocks keep
+ * running through the interpreter.
+ */
+
+#ifndef CHIP8JIT_H_
+#define CHIP8JIT_H_
+
+#include <stddef.h>
+#include "Chip8.h"
+
+
+class Chip8Jit{
+
+  public:
+
+    Chip8Jit();
+    ~Chip8Jit();
+
+    // translates the block and sets block.native, false when the block
+    // could not be translated (no executable memory or buffer full)
+    bool compile( Chip8 &chip8, Chip8::Block &block);
+
+    // true when the last compile failed for lack of code space
+    bool full() const { return out_of_space; }
+
+    // forgets every translation, only valid after the blocks are flushed
+    void reset();
+
+  private:
+
+    unsigned char *code; // executable buffer
+    size_t capacity;
+    size_t used;
+    bool out_of_space;
+
+    // emitter state for the block being translated
+    unsigned char *out;
+    const unsigned char *base; // the Chip8 instance, rbx at run time
+
+    static void fallback( Chip8 *chip8, const Chip8::Instruction *in);
+
+    int offset( const void *field) const;
+    void emit8( unsigned char byte);
+    void emit16( unsigned short word);
+    void emit32( unsigned int dword);
+    void emit64( unsigned long long qword);
+    void emitModRM( unsigned char reg, const void *field);
+
+    void emitStorePc( unsigned short pc);
+    void emitCall( const Chip8::Instruction *in);
+    void emitSkip( unsigned short pc, unsigned char cmov);
+    int emitNative( Chip8 &c, const Chip8::Instruction &in, unsigned short pc);
+
+    Chip8Jit( const Chip8Jit &);
+    Chip8Jit &operator=( const Chip8Jit &);
+
+};
+
+#endif // CHIP8JIT_H_
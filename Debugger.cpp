@@ -0,0 +1,297 @@
+/**
+ * @brief  CHIP8 EMULATOR PROJECT
+ * @Author esantiago
+ * @date   October, 2026
+ *
+ * @description: Chip8 debugger source file
+ */
+
+#include "Debugger.h"
+
+using namespace std;
+
+
+Debugger::Debugger( Chip8 &chip8, size_t history_size)
+  : chip8(chip8), breakpoints(4096, 0), watches(4096, 0), breakpoint_count(0), watch_count(0),
+    register_watches(0), stop_requested(false), stepping(false), resume_at_break(false),
+    stop_handler(NULL), stop_user(NULL), history(history_size > 0 ? history_size : 1),
+    history_head(0), history_count(0)
+{
+}
+
+
+Debugger::~Debugger()
+{
+  if (chip8.cycle_hook == this)
+    chip8.cycle_hook = NULL;
+}
+
+
+bool Debugger::armed() const
+{
+  return breakpoint_count > 0 || watch_count > 0 || register_watches != 0 ||
+         stop_requested || stepping;
+}
+
+
+// attached while anything is armed, the core runs its fast paths otherwise;
+// the history only covers one attached stretch. While a trace is being
+// recorded it holds the hook and the debugger stays detached.
+void Debugger::update()
+{
+  if (armed())
+  {
+    if (chip8.cycle_hook == NULL)
+      chip8.cycle_hook = this;
+  }
+  else
+  {
+    if (chip8.cycle_hook == this)
+      chip8.cycle_hook = NULL;
+    history_count = 0;
+  }
+}
+
+
+void Debugger::setBreakpoint( unsigned short address, bool on)
+{
+  address &= 0xFFF;
+  if (on != (breakpoints[address] != 0))
+  {
+    breakpoints[address] = on;
+    breakpoint_count += on ? 1 : -1;
+  }
+  update();
+}
+
+
+void Debugger::setWatchpoint( unsigned short address, size_t length, unsigned int flags, bool on)
+{
+  for (size_t i = 0; i < length && i < 4096; ++i)
+  {
+    unsigned char &watch = watches[(address + i) & 0xFFF];
+    bool was = watch != 0;
+    if (on)
+      watch |= flags;
+    else
+      watch &= ~flags;
+    if (was != (watch != 0))
+      watch_count += was ? -1 : 1;
+  }
+  update();
+}
+
+
+void Debugger::watchRegister( unsigned int reg, bool on)
+{
+  if (reg >= REGISTERS)
+    return;
+  if (on)
+    register_watches |= 1u << reg;
+  else
+    register_watches &= ~(1u << reg);
+  update();
+}
+
+
+void Debugger::clearAll()
+{
+  breakpoints.assign( 4096, 0);
+  watches.assign( 4096, 0);
+  breakpoint_count = 0;
+  watch_count = 0;
+  register_watches = 0;
+  stop_requested = false;
+  stepping = false;
+  update();
+}
+
+
+void Debugger::requestStop()
+{
+  stop_requested = true;
+  update();
+}
+
+
+unsigned int Debugger::registerValue( const Chip8 &chip8, unsigned int reg)
+{
+  switch (reg)
+  {
+    case REG_I:  return chip8.I;
+    case REG_PC: return chip8.pc;
+    case REG_SP: return chip8.sp;
+    case REG_DT: return chip8.delay_timer;
+    case REG_ST: return chip8.sound_timer;
+    default:     return reg < 16 ? chip8.V[reg] : 0;
+  }
+}
+
+
+void Debugger::setRegister( unsigned int reg, unsigned int value)
+{
+  switch (reg)
+  {
+    case REG_I:  chip8.I = value & 0xFFFF; break;
+    case REG_PC: chip8.pc = value & 0xFFFF; break;
+    case REG_SP: chip8.sp = value & 0xF; break;
+    case REG_DT: chip8.delay_timer = value; break;
+    case REG_ST: chip8.sound_timer = value; break;
+    default:
+      if (reg < 16)
+        chip8.V[reg] = value;
+    break;
+  }
+}
+
+
+void Debugger::writeMemory( unsigned short address, unsigned char value)
+{
+  chip8.storeByte( address, value);
+}
+
+
+void Debugger::accesses( const Chip8 &chip8, unsigned short &first, unsigned int &reads,
+                         unsigned int &writes)
+{
+  unsigned short pc = chip8.pc & 0xFFF;
+  unsigned short opcode = chip8.memory[pc] << 8 | chip8.memory[(pc + 1) & 0xFFF];
+  unsigned int x = (opcode >> 8) & 0xF;
+
+  first = chip8.I & 0xFFF;
+  reads = 0;
+  writes = 0;
+
+  if ((opcode & 0xF000) == 0xD000)
+    reads = opcode & 0xF;
+  else if ((opcode & 0xF0FF) == 0xF065)
+    reads = x + 1;
+  else if ((opcode & 0xF0FF) == 0xF055)
+    writes = x + 1;
+  else if ((opcode & 0xF0FF) == 0xF033)
+    writes = 3;
+
+}
+
+
+// the state before the instruction about to run; consecutive entries
+// share all but the pages one instruction wrote. The copy carries the
+// write clock of the previous capture, so pages a reverse step stored
+// back since then are compared again too.
+void Debugger::record()
+{
+  size_t previous = (history_head + history.size() - 1) % history.size();
+  if (history_count == 0)
+    history[history_head] = Chip8Fork( chip8);
+  else
+  {
+    history[history_head] = history[previous];
+    history[history_head].capture( chip8);
+  }
+
+  history_head = (history_head + 1) % history.size();
+  if (history_count < history.size())
+    ++history_count;
+
+}
+
+
+bool Debugger::reverseStep()
+{
+  if (history_count == 0)
+    return false;
+
+  history_head = (history_head + history.size() - 1) % history.size();
+  --history_count;
+  history[history_head].restore( chip8);
+  history[history_head] = Chip8Fork();
+  resume_at_break = true;
+  return true;
+
+}
+
+
+Debugger::Stop Debugger::reverseContinue()
+{
+  Stop result = { STOP_HISTORY_START, chip8.pc, 0 };
+  while (reverseStep())
+  {
+    if (breakpoints[chip8.pc & 0xFFF])
+    {
+      result.reason = STOP_BREAKPOINT;
+      break;
+    }
+  }
+  result.address = chip8.pc;
+  return result;
+
+}
+
+
+void Debugger::stop( StopReason reason, unsigned short address, unsigned int reg)
+{
+  Stop stop = { reason, address, reg };
+  stop_requested = false;
+  stepping = false;
+  resume_at_break = true;
+
+  if (stop_handler != NULL)
+    stop_handler( *this, stop, stop_user);
+  update();
+
+}
+
+
+void Debugger::run( unsigned long long cycles)
+{
+  for (unsigned long long i = 0; i < cycles && chip8.cycle_hook == this; ++i)
+  {
+    if (stop_requested)
+      stop( STOP_INTERRUPT, chip8.pc);
+    else if (breakpoints[chip8.pc & 0xFFF] && !resume_at_break)
+      stop( STOP_BREAKPOINT, chip8.pc);
+    resume_at_break = false;
+
+    // the handler may have let go: the rest of the call runs at full speed
+    if (chip8.cycle_hook != this)
+    {
+      chip8.runCycles( cycles - i);
+      return;
+    }
+
+    unsigned short first;
+    unsigned int reads, writes;
+    accesses( chip8, first, reads, writes);
+
+    unsigned int before[REGISTERS];
+    for (unsigned int r = 0; r < REGISTERS; ++r)
+      before[r] = registerValue( chip8, r);
+
+    record();
+    chip8.emulateCycle();
+
+    // watchpoints report after the access, like hardware ones
+    bool stopped = false;
+    for (unsigned int b = 0; b < reads + writes && watch_count > 0 && !stopped; ++b)
+    {
+      unsigned short address = (first + b) & 0xFFF;
+      unsigned int flag = b < reads ? WATCH_READ : WATCH_WRITE;
+      if (watches[address] & flag)
+      {
+        stop( flag == WATCH_READ ? STOP_WATCH_READ : STOP_WATCH_WRITE, address);
+        stopped = true;
+      }
+    }
+    for (unsigned int r = 0; r < REGISTERS && register_watches != 0 && !stopped; ++r)
+    {
+      if ((register_watches & (1u << r)) && registerValue( chip8, r) != before[r])
+      {
+        stop( STOP_REGISTER, chip8.pc, r);
+        stopped = true;
+      }
+    }
+    if (!stopped && stepping)
+      stop( STOP_STEP, chip8.pc);
+  }
+
+}
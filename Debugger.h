@@ -0,0 +1,148 @@
+/**
+ * @brief  CHIP8 EMULATOR PROJECT
+ * @Author esantiago
+ * @date   October, 2026
+ *
+ * @description: Header file for the Chip8 debugger
+ *
+ * Breakpoints on pc, read and write watchpoints on memory, watches on
+ * V0-VF and I, single stepping and reverse stepping for one Chip8.
+ *
+ * The core only looks at the debugger once per runCycles call: while
+ * anything is armed it hands the whole call to Debugger::run (through
+ * Chip8::CycleHook), which steps instruction by instruction through
+ * emulateCycle and checks everything around each one. With nothing armed
+ * the debugger detaches and the core runs its normal paths (block cache,
+ * JIT, idle skipping) with no hook at all, so a build with a debugger
+ * compiled in costs nothing until a breakpoint is set.
+ *
+ * Memory accesses are found from the instruction about to run (Dxyn and
+ * Fx65 read from I, Fx33 and Fx55 write there), so watchpoints need no
+ * hook in the load and store paths either. While attached every
+ * instruction leaves a Chip8Fork behind, a couple of hundred bytes, and
+ * reverse stepping restores them.
+ *
+ * A stop calls the stop handler on the thread running the core, which
+ * blocks the emulation there until it returns (the GDB stub serves its
+ * client from it). Everything here runs on that thread.
+ */
+
+#ifndef DEBUGGER_H_
+#define DEBUGGER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+#include "Chip8.h"
+#include "Chip8Fork.h"
+
+
+class Debugger : public Chip8::CycleHook{
+
+  public:
+
+    enum StopReason
+    {
+      STOP_STEP,          // single step done
+      STOP_BREAKPOINT,    // pc reached a breakpoint, before running it
+      STOP_WATCH_READ,    // an instruction read a watched byte, after it ran
+      STOP_WATCH_WRITE,   // an instruction wrote a watched byte, after it ran
+      STOP_REGISTER,      // a watched register changed, after the instruction
+      STOP_INTERRUPT,     // requestStop()
+      STOP_HISTORY_START  // reverse execution ran out of history
+    };
+
+    struct Stop
+    {
+      StopReason reason;
+      unsigned short address; // the watched byte, pc otherwise
+      unsigned int reg;       // STOP_REGISTER: the register, see REG_*
+    };
+
+    // called on every stop, the core is paused until it returns
+    typedef void (*StopHandler)( Debugger &debugger, const Stop &stop, void *user);
+
+    enum { WATCH_READ = 1, WATCH_WRITE = 2 };
+
+    // register numbers: 0-15 are V0-VF, then these
+    enum
+    {
+      REG_I = 16,
+      REG_PC,
+      REG_SP,
+      REG_DT,
+      REG_ST,
+      REGISTERS
+    };
+
+    // keeps the state before each of the last 'history' instructions
+    explicit Debugger( Chip8 &chip8, size_t history = 16384);
+    ~Debugger();
+
+    void setStopHandler( StopHandler handler, void *user) { stop_handler = handler; stop_user = user; }
+    Chip8 &machine() { return chip8; }
+
+    void setBreakpoint( unsigned short address, bool on);
+    void setWatchpoint( unsigned short address, size_t length, unsigned int flags, bool on);
+    void watchRegister( unsigned int reg, bool on);
+    void clearAll();
+
+    // stops before the next instruction
+    void requestStop();
+
+    // resume modes, for the stop handler to pick before returning
+    void resume() { stepping = false; }
+    void step() { stepping = true; }
+
+    // state before the instructions that ran, newest last; false when
+    // there is none left. reverseContinue goes back to the last
+    // breakpoint, or as far as the history reaches.
+    bool reverseStep();
+    Stop reverseContinue();
+    size_t historySize() const { return history_count; }
+
+    bool armed() const;
+
+    // runs 'cycles' instructions with every check, from Chip8::runCycles
+    virtual void run( unsigned long long cycles);
+
+    // the bytes the instruction at pc reads and writes, for watchpoints
+    static void accesses( const Chip8 &chip8, unsigned short &first, unsigned int &reads,
+                          unsigned int &writes);
+
+    // register access by number, see REG_*; memory writes go through the
+    // core so decoded blocks see them
+    static unsigned int registerValue( const Chip8 &chip8, unsigned int reg);
+    void setRegister( unsigned int reg, unsigned int value);
+    void writeMemory( unsigned short address, unsigned char value);
+
+  private:
+
+    Chip8 &chip8;
+    std::vector<unsigned char> breakpoints; // per address
+    std::vector<unsigned char> watches;     // per address, WATCH_* bits
+    size_t breakpoint_count;
+    size_t watch_count;
+    uint32_t register_watches;              // bit n = register n
+    bool stop_requested;
+    bool stepping;
+    bool resume_at_break;                   // run the instruction at a breakpoint once
+
+    StopHandler stop_handler;
+    void *stop_user;
+
+    // ring of states before each instruction run while attached
+    std::vector<Chip8Fork> history;
+    size_t history_head;  // next slot
+    size_t history_count;
+
+    void record();
+    void update();
+    void stop( StopReason reason, unsigned short address, unsigned int reg = 0);
+
+    Debugger( const Debugger &);
+    Debugger &operator=( const Debugger &);
+
+};
+
+#endif // DEBUGGER_H_
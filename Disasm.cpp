@@ -0,0 +1,89 @@
+/**
+ * @brief  CHIP8 EMULATOR PROJECT
+ * @Author esantiago
+ * @date   October, 2026
+ *
+ * @description: One-line instruction formatter source file
+ */
+
+#include <stdio.h>
+#include "Disasm.h"
+
+
+char *disassemble( unsigned short opcode, char *text, size_t size)
+{
+  unsigned int nnn = opcode & 0x0FFF;
+  unsigned int x   = (opcode & 0x0F00) >> 8;
+  unsigned int y   = (opcode & 0x00F0) >> 4;
+  unsigned int kk  = opcode & 0x00FF;
+  unsigned int n   = opcode & 0x000F;
+
+  switch(opcode & 0xF000)
+  {
+    case 0x0000:
+      if (n == 0x0)
+        snprintf( text, size, "CLS");
+      else if (n == 0xE)
+        snprintf( text, size, "RET");
+      else
+        break;
+      return text;
+
+    case 0x1000: snprintf( text, size, "JP 0x%03X", nnn); return text;
+    case 0x2000: snprintf( text, size, "CALL 0x%03X", nnn); return text;
+    case 0x3000: snprintf( text, size, "SE V%X, 0x%02X", x, kk); return text;
+    case 0x4000: snprintf( text, size, "SNE V%X, 0x%02X", x, kk); return text;
+    case 0x5000:
+      snprintf( text, size, "SE V%X, V%X", x, y);
+      return text;
+    case 0x6000: snprintf( text, size, "LD V%X, 0x%02X", x, kk); return text;
+    case 0x7000: snprintf( text, size, "ADD V%X, 0x%02X", x, kk); return text;
+
+    case 0x8000:
+    {
+      static const char *const ALU[16] =
+        { "LD", "OR", "AND", "XOR", "ADD", "SUB", "SHR", "SUBN",
+          NULL, NULL, NULL, NULL, NULL, NULL, "SHL", NULL };
+      if (ALU[n] == NULL)
+        break;
+      snprintf( text, size, "%s V%X, V%X", ALU[n], x, y);
+      return text;
+    }
+
+    case 0x9000:
+      snprintf( text, size, "SNE V%X, V%X", x, y);
+      return text;
+    case 0xA000: snprintf( text, size, "LD I, 0x%03X", nnn); return text;
+    case 0xB000: snprintf( text, size, "JP V0, 0x%03X", nnn); return text;
+    case 0xC000: snprintf( text, size, "RND V%X, 0x%02X", x, kk); return text;
+    case 0xD000: snprintf( text, size, "DRW V%X, V%X, %u", x, y, n); return text;
+
+    case 0xE000:
+      if (kk == 0x9E)
+        snprintf( text, size, "SKP V%X", x);
+      else if (kk == 0xA1)
+        snprintf( text, size, "SKNP V%X", x);
+      else
+        break;
+      return text;
+
+    case 0xF000:
+      switch(kk)
+      {
+        case 0x07: snprintf( text, size, "LD V%X, DT", x); return text;
+        case 0x0A: snprintf( text, size, "LD V%X, K", x); return text;
+        case 0x15: snprintf( text, size, "LD DT, V%X", x); return text;
+        case 0x18: snprintf( text, size, "LD ST, V%X", x); return text;
+        case 0x1E: snprintf( text, size, "ADD I, V%X", x); return text;
+        case 0x29: snprintf( text, size, "LD F, V%X", x); return text;
+        case 0x33: snprintf( text, size, "LD B, V%X", x); return text;
+        case 0x55: snprintf( text, size, "LD [I], V%X", x); return text;
+        case 0x65: snprintf( text, size, "LD V%X, [I]", x); return text;
+      }
+      break;
+  }
+
+  snprintf( text, size, "DW 0x%04X", opcode);
+  return text;
+
+}
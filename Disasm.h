@@ -0,0 +1,23 @@
+/**
+ * @brief  CHIP8 EMULATOR PROJECT
+ * @Author esantiago
+ * @date   October, 2026
+ *
+ * @description: Header file for the one-line instruction formatter
+ *
+ * Turns an opcode into the usual assembler mnemonic (Cowgod's names),
+ * e.g. "DRW V0, V1, 5" or "LD I, 0x2A4". Opcodes are read the way the
+ * emulator executes them (0nn0 is CLS, 5xyn ignores n and so on); the
+ * ones it does not implement come out as "DW 0xABCD".
+ */
+
+#ifndef DISASM_H_
+#define DISASM_H_
+
+#include <stddef.h>
+
+
+// writes the mnemonic into 'text' (always NUL terminated), returns 'text'
+char *disassemble( unsigned short opcode, char *text, size_t size);
+
+#endif // DISASM_H_
@@ -0,0 +1,275 @@
+/**
+ * @brief  CHIP8 EMULATOR PROJECT
+ * @Author esantiago
+ * @date   October, 2026
+ *
+ * @description: Control-flow-following disassembler source file
+ *
+ * Listing format:
+ *
+ *   sub_2A4:
+ *     0x2A4  6A05  LD VA, 0x05
+ *     0x2A6  A3D3  LD I, data_3D3
+ *   data_3D3:
+ *     0x3D3  db 0x3C, 0x42, 0x81, 0x81  ; ..####.. .#....#. #......# #......#
+ */
+
+#include <stdio.h>
+#include <stdarg.h>
+#include "Disassembler.h"
+#include "Disasm.h"
+
+using namespace std;
+
+
+static const size_t DATA_PER_LINE = 4;
+
+
+Disassembler::Disassembler()
+  : image(NULL), size(0), code_bytes(0)
+{
+}
+
+
+unsigned short Disassembler::opcodeAt( unsigned int address) const
+{
+  return image[address - 0x200] << 8 | image[address - 0x200 + 1];
+}
+
+
+void Disassembler::append( const char *format, ...)
+{
+  char line[128];
+  va_list args;
+  va_start( args, format);
+  int length = vsnprintf( line, sizeof(line), format, args);
+  va_end( args);
+  if (length > 0)
+    text.append( line, (size_t)length < sizeof(line) ? length : sizeof(line) - 1);
+}
+
+
+void Disassembler::label( unsigned int address, unsigned char kind)
+{
+  if (address >= 0x200 && address < 0x200 + size)
+    marks[address - 0x200] |= kind;
+}
+
+
+// decodes the straight-line run starting at 'address', queueing every
+// other path it can take
+void Disassembler::visit( unsigned int address)
+{
+  while (inImage( address) && !(marks[address - 0x200] & CODE_START))
+  {
+    marks[address - 0x200] |= CODE_START | CODE_BYTE;
+    marks[address - 0x200 + 1] |= CODE_BYTE;
+
+    unsigned short opcode = opcodeAt( address);
+    unsigned int nnn = opcode & 0x0FFF;
+    unsigned int kk = opcode & 0x00FF;
+
+    switch(opcode & 0xF000)
+    {
+      case 0x0000:
+        if ((opcode & 0x000F) != 0x0) // RET ends the path, others stall
+          return;
+      break;
+
+      case 0x1000:
+        label( nnn, LABEL_CODE);
+        work.push_back( nnn);
+        return;
+
+      case 0x2000:
+        label( nnn, LABEL_SUB);
+        work.push_back( nnn);
+      break;
+
+      case 0x3000:
+      case 0x4000:
+      case 0x5000:
+      case 0x9000:
+        work.push_back( address + 4);
+      break;
+
+      case 0x8000:
+        if ((opcode & 0x000F) > 0x7 && (opcode & 0x000F) != 0xE)
+          return;
+      break;
+
+      case 0xA000:
+        label( nnn, LABEL_DATA);
+      break;
+
+      case 0xB000: // only the V0 = 0 target is known
+        label( nnn, LABEL_CODE);
+        work.push_back( nnn);
+        return;
+
+      case 0xE000:
+        if (kk != 0x9E && kk != 0xA1)
+          return;
+        work.push_back( address + 4);
+      break;
+
+      case 0xF000:
+        switch(kk)
+        {
+          case 0x07: case 0x0A: case 0x15: case 0x18: case 0x1E:
+          case 0x29: case 0x33: case 0x55: case 0x65:
+          break;
+          default:
+            return;
+        }
+      break;
+    }
+
+    address += 2;
+  }
+}
+
+
+void Disassembler::trace()
+{
+  work.clear();
+  work.push_back( 0x200);
+  while (!work.empty())
+  {
+    unsigned int address = work.back();
+    work.pop_back();
+    visit( address);
+  }
+}
+
+
+// a byte can be several kinds of target, sub_ wins over L_ over data_
+const char *Disassembler::labelPrefix( unsigned char mark)
+{
+  if (mark & LABEL_SUB)
+    return "sub_";
+  if (mark & LABEL_CODE)
+    return "L_";
+  return "data_";
+}
+
+
+void Disassembler::emitLabel( unsigned int address)
+{
+  unsigned char mark = marks[address - 0x200];
+  if (mark & (LABEL_CODE | LABEL_SUB | LABEL_DATA))
+    append( "%s%03X:\n", labelPrefix( mark), address);
+}
+
+
+void Disassembler::emitCode( unsigned int address)
+{
+  unsigned short opcode = opcodeAt( address);
+  unsigned int nnn = opcode & 0x0FFF;
+  char operand[16];
+  const char *format = NULL;
+
+  switch(opcode & 0xF000)
+  {
+    case 0x1000: format = "JP %s"; break;
+    case 0x2000: format = "CALL %s"; break;
+    case 0xA000: format = "LD I, %s"; break;
+    case 0xB000: format = "JP V0, %s"; break;
+  }
+
+  // address operands become label names when they point into the image
+  if (format != NULL && nnn >= 0x200 && nnn < 0x200 + size &&
+      (marks[nnn - 0x200] & (LABEL_CODE | LABEL_SUB | LABEL_DATA)))
+  {
+    snprintf( operand, sizeof(operand), "%s%03X", labelPrefix( marks[nnn - 0x200]), nnn);
+    char mnemonic[32];
+    snprintf( mnemonic, sizeof(mnemonic), format, operand);
+    append( "  0x%03X  %04X  %s\n", address, opcode, mnemonic);
+    return;
+  }
+
+  char mnemonic[32];
+  append( "  0x%03X  %04X  %s\n", address, opcode, disassemble( opcode, mnemonic, sizeof(mnemonic)));
+}
+
+
+// one line of up to DATA_PER_LINE bytes that no instruction covers,
+// stopping at the next label; returns the number of bytes listed
+size_t Disassembler::emitData( unsigned int address)
+{
+  size_t count = 0;
+  while (count < DATA_PER_LINE && address + count < 0x200 + size)
+  {
+    unsigned char mark = marks[address + count - 0x200];
+    if ((mark & CODE_BYTE) || (count > 0 && (mark & (LABEL_CODE | LABEL_SUB | LABEL_DATA))))
+      break;
+    ++count;
+  }
+
+  char bytes[32];
+  char preview[48];
+  size_t b = 0, p = 0;
+  for (size_t i = 0; i < count; ++i)
+  {
+    unsigned char value = image[address + i - 0x200];
+    b += snprintf( bytes + b, sizeof(bytes) - b, i == 0 ? "0x%02X" : ", 0x%02X", value);
+    if (i > 0)
+      preview[p++] = ' ';
+    for (int bit = 7; bit >= 0; --bit)
+      preview[p++] = (value >> bit) & 1 ? '#' : '.';
+  }
+  preview[p] = '\0';
+
+  append( "  0x%03X  db %-24s ; %s\n", address, bytes, preview);
+  return count;
+}
+
+
+void Disassembler::analyze( const unsigned char *program, size_t program_size)
+{
+  image = program;
+  size = program_size;
+  marks.assign( size + 1, 0);
+
+  trace();
+
+  code_bytes = 0;
+  for (size_t i = 0; i < size; ++i)
+  {
+    if (marks[i] & CODE_BYTE)
+      ++code_bytes;
+  }
+}
+
+
+const string &Disassembler::run( const unsigned char *program, size_t program_size)
+{
+  analyze( program, program_size);
+  text.clear();
+
+  // addresses in order: instructions where one starts, bytes no
+  // instruction covers as data, instruction tails are skipped
+  unsigned int end = 0x200 + size;
+  for (unsigned int address = 0x200; address < end; )
+  {
+    unsigned char mark = marks[address - 0x200];
+    if (mark & CODE_START)
+    {
+      emitLabel( address);
+      emitCode( address);
+      ++address;
+      if (address < end && !(marks[address - 0x200] & CODE_START))
+        ++address;
+    }
+    else if (mark & CODE_BYTE)
+      ++address;
+    else
+    {
+      emitLabel( address);
+      address += emitData( address);
+    }
+  }
+
+  return text;
+
+}
@@ -0,0 +1,87 @@
+/**
+ * @brief  CHIP8 EMULATOR PROJECT
+ * @Author esantiago
+ * @date   October, 2026
+ *
+ * @description: Header file for the control-flow-following disassembler
+ *
+ * Starting at 0x200, follows every path a program can take (jumps, both
+ * sides of the skips, calls and the instruction after them) and only
+ * decodes what is reachable as code. Everything else in the image is
+ * data and is listed as bytes, with a sprite preview, instead of being
+ * read as instructions. JP/CALL targets get code labels, LD I targets
+ * get data labels.
+ *
+ * Limits: Bnnn (JP V0, nnn) is only followed to nnn itself, and code
+ * that the program writes at run time is not seen.
+ *
+ * The listing is written into a buffer owned by the disassembler and
+ * reused from one ROM to the next.
+ */
+
+#ifndef DISASSEMBLER_H_
+#define DISASSEMBLER_H_
+
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+
+class Disassembler{
+
+  public:
+
+    Disassembler();
+
+    // disassembles a program image loaded at 0x200, the listing stays
+    // valid until the next call
+    const std::string &run( const unsigned char *program, size_t size);
+
+    // only finds code and data, run() without the listing
+    void analyze( const unsigned char *program, size_t size);
+
+    // after analyze() or run(): whether a reachable instruction starts at
+    // 'address', and whether a JP, CALL or JP V0 lands there
+    bool instructionAt( unsigned int address) const { return marked( address, CODE_START); }
+    bool branchTarget( unsigned int address) const { return marked( address, LABEL_CODE | LABEL_SUB); }
+
+    const std::string &listing() const { return text; }
+    size_t codeBytes() const { return code_bytes; }
+    size_t dataBytes() const { return size - code_bytes; }
+
+  private:
+
+    enum
+    {
+      CODE_START = 1, // an instruction starts here
+      CODE_BYTE  = 2, // covered by an instruction
+      LABEL_CODE = 4, // JP target
+      LABEL_SUB  = 8, // CALL target
+      LABEL_DATA = 16 // LD I target
+    };
+
+    const unsigned char *image;
+    size_t size;
+    size_t code_bytes;
+    std::vector<unsigned char> marks; // per byte of the image
+    std::vector<unsigned short> work; // addresses still to visit
+    std::string text;
+
+    bool inImage( unsigned int address) const { return address >= 0x200 && address + 1 < 0x200 + size; }
+    bool marked( unsigned int address, unsigned char mark) const
+    {
+      return address >= 0x200 && address < 0x200 + size && (marks[address - 0x200] & mark) != 0;
+    }
+    unsigned short opcodeAt( unsigned int address) const;
+    void trace();
+    void visit( unsigned int address);
+    void label( unsigned int address, unsigned char kind);
+    static const char *labelPrefix( unsigned char mark);
+    void emitLabel( unsigned int address);
+    void emitCode( unsigned int address);
+    size_t emitData( unsigned int address);
+    void append( const char *format, ...);
+
+};
+
+#endif // DISASSEMBLER_H_
@@ -1,14 +1,18 @@
 #include <SDL2/SDL.h>
-#include <SDL2/SDL_mixer.h>
 #include "stdint.h"
 #include "Chip8.h"
 #include "EmuGfx.h"
+#include "GfxConvert.h"
+#ifdef CHIP8_PROFILE
+#include "Profiler.h"
+#endif
 
 using namespace std;
 
 
 EmuGfx::EmuGfx()
-  : gfxWindow(NULL), gfxRenderer(NULL), gfxTexture(NULL), bgMusic(NULL), SCREEN_WIDTH(1024), SCREEN_HEIGHT(512) //640 x 480
+  : gfxWindow(NULL), gfxRenderer(NULL), gfxTexture(NULL), SCREEN_WIDTH(1024), SCREEN_HEIGHT(512), presentedValid(false),
+    gfxProfiler(NULL) //640 x 480
 {
 }
 
@@ -18,13 +22,13 @@ EmuGfx::~EmuGfx()
 }
 
 
-bool EmuGfx::init()
+bool EmuGfx::init( bool vsync)
 {
     // initialization flag
 	bool success = true;
 
-	// initialize SDL
-	if( SDL_Init( SDL_INIT_EVERYTHING ) < 0 )
+	// initialize SDL, audio is started separately by the beeper
+	if( SDL_Init( SDL_INIT_VIDEO ) < 0 )
 	{
 		printf( "SDL could not initialize! SDL Error: %s\n", SDL_GetError() );
 		success = false;
@@ -47,7 +51,7 @@ bool EmuGfx::init()
 		else
 		{
 			// create renderer for window
-			gfxRenderer = SDL_CreateRenderer( gfxWindow, -1, 0 );  // if want to Create vsynced renderer for window (see SDL_RendererFlags)
+			gfxRenderer = SDL_CreateRenderer( gfxWindow, -1, vsync ? SDL_RENDERER_PRESENTVSYNC : 0 );
 			if( gfxRenderer == NULL )
 			{
 				printf( "Renderer could not be created! SDL Error: %s\n", SDL_GetError() );
@@ -63,11 +67,6 @@ bool EmuGfx::init()
 
                 // Use this function to create a texture for a rendering context
                 gfxTexture = SDL_CreateTexture( gfxRenderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, 64, 32 );
-
-                // initialize SDL Mixer and load audio file
-                Mix_OpenAudio( 44100, MIX_DEFAULT_FORMAT, 2, 8192 );
-                bgMusic = Mix_LoadMUS( "thruSpace.ogg" );
-                
 			}
 		}
 	}
@@ -78,10 +77,6 @@ bool EmuGfx::init()
 
 void EmuGfx::close()
 {
-    //Free audio
-    Mix_FreeMusic( bgMusic );
-    Mix_CloseAudio();
-
 	//Free loaded texture
 	SDL_DestroyTexture( gfxTexture );
 	gfxTexture = NULL;
@@ -97,33 +92,46 @@ void EmuGfx::close()
 }
 
 
-void EmuGfx::drawGfx(Chip8 &myChip8)
+void EmuGfx::drawGfx( const uint64_t *rows)
 {
-    myChip8.draw_flag = false;
+#ifdef CHIP8_PROFILE
+    Profiler::Timer timer( gfxProfiler != NULL ? &gfxProfiler->present : NULL);
+#endif
+
+    uint32_t dirty = 0;
+    bool full = !presentedValid;
+    presentedValid = true;
 
-    // store raw pixel data in format of texture in rendering buffer: gfxPixels[]
-    for (size_t i = 0; i < 2048; ++i)
+    // only rows that differ from what is already on screen
+    for (size_t y = 0; y < 32; ++y)
     {
-      uint8_t pixel = myChip8.gfx[i];
-      gfxPixels[i] = (0xFF0000FF * pixel);
+      if (full || rows[y] != presentedRows[y])
+      {
+        dirty |= 1u << y;
+        presentedRows[y] = rows[y];
+      }
     }
 
-    // update texture
-    SDL_UpdateTexture(gfxTexture, NULL, gfxPixels, 64 * sizeof(Uint32) );
+    if (dirty != 0)
+    {
+      // convert and upload the span of rows that changed: gfxPixels[]
+      size_t first = __builtin_ctz( dirty);
+      size_t count = 32 - __builtin_clz( dirty) - first;
+      expandRows( rows, first, count, &gfxPixels[first * 64], 0xFF0000FF, 0);
 
-    // clear screen
-    SDL_RenderClear(gfxRenderer);
+      // update texture
+      SDL_Rect span = { 0, (int)first, 64, (int)count };
+      SDL_UpdateTexture(gfxTexture, &span, &gfxPixels[first * 64], 64 * sizeof(Uint32) );
 
-    // render texture to screen
-    SDL_RenderCopy(gfxRenderer, gfxTexture, NULL, NULL);
+      // clear screen
+      SDL_RenderClear(gfxRenderer);
 
-    // update screen
-    SDL_RenderPresent(gfxRenderer);
+      // render texture to screen
+      SDL_RenderCopy(gfxRenderer, gfxTexture, NULL, NULL);
 
-    // timeout used to slow down emulation speed
-    // essentially rendering at ~130Hz
-    timeout = SDL_GetTicks() + 8;
-    while (!SDL_TICKS_PASSED( SDL_GetTicks(), timeout ) ) {};
+      // update screen
+      SDL_RenderPresent(gfxRenderer);
+    }
 
 }
 
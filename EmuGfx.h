@@ -9,6 +9,9 @@
 #ifndef EMUGFX_H_
 #define EMUGFX_H_
 
+#include <stdint.h>
+
+class Profiler;
 
 class EmuGfx{
 
@@ -17,11 +20,20 @@ class EmuGfx{
     EmuGfx();
     ~EmuGfx();
 
-    // starts up SDL and creates window
-    bool init();
+    // starts up SDL and creates window, presents are synced to the
+    // display refresh when vsync is set
+    bool init( bool vsync = false);
+
+    // presents a packed 64x32 frame, converting and uploading only the
+    // rows that differ from the one on screen
+    void drawGfx( const uint64_t *rows);
+
+    // the window lost its contents (uncovered, restored), the next
+    // drawGfx converts and presents every row
+    void invalidate() { presentedValid = false; }
 
-    // update screen if draw flag is set
-    void drawGfx(Chip8 &myChip8);
+    // times every drawGfx into profiler->present, NULL stops timing
+    void setProfiler( Profiler *profiler) { gfxProfiler = profiler; }
 
     // frees media and quits SDL
     void close();
@@ -47,9 +59,6 @@ class EmuGfx{
       SDLK_v, // F
     };
 
-    // create audio object
-    Mix_Music *bgMusic;
-
   private:
 
     // the window we'll be rendering to
@@ -68,8 +77,12 @@ class EmuGfx{
     // temporary pixel buffer
     uint32_t gfxPixels[2048];
 
-    // timeout used to slowdown emulation speed
-    uint32_t timeout;
+    // rows currently on screen, so rows drawn and erased again between
+    // presents are not converted, uploaded or presented
+    uint64_t presentedRows[32];
+    bool presentedValid;
+
+    Profiler *gfxProfiler;
 
 };
 
@@ -0,0 +1,38 @@
+/**
+ * @brief  CHIP8 EMULATOR PROJECT
+ * @Author esantiago
+ * @date   October, 2026
+ *
+ * @description: Framebuffer handoff source file
+ */
+
+#include <string.h>
+#include "FrameHandoff.h"
+
+using namespace std;
+
+
+FrameHandoff::FrameHandoff()
+  : back_index(0), front_index(1), middle(2)
+{
+  memset( slots, 0, sizeof(slots));
+}
+
+
+// release: the rows written to the back slot are visible to whoever
+// takes it; acquire: the slot handed back is no longer being read
+void FrameHandoff::publish()
+{
+  back_index = middle.exchange( back_index | FRESH, memory_order_acq_rel) & ~FRESH;
+}
+
+
+bool FrameHandoff::take()
+{
+  if ((middle.load( memory_order_relaxed) & FRESH) == 0)
+    return false;
+
+  front_index = middle.exchange( front_index, memory_order_acq_rel) & ~FRESH;
+  return true;
+
+}
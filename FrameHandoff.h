@@ -0,0 +1,61 @@
+/**
+ * @brief  CHIP8 EMULATOR PROJECT
+ * @Author esantiago
+ * @date   October, 2026
+ *
+ * @description: Header file for the framebuffer handoff between threads
+ *
+ * A triple buffer of packed 64x32 frames for one producer (the
+ * emulation thread) and one consumer (the render thread). The producer
+ * always owns a back slot to fill and the consumer a front slot to read;
+ * the third slot sits in between. Publishing swaps the back slot with
+ * the middle one and taking swaps the middle with the front, each a
+ * single atomic exchange, so neither side ever waits on the other. A
+ * frame published while an older one was still untaken replaces it: the
+ * consumer only ever sees the latest.
+ */
+
+#ifndef FRAMEHANDOFF_H_
+#define FRAMEHANDOFF_H_
+
+#include <stdint.h>
+#include <atomic>
+
+
+class FrameHandoff{
+
+  public:
+
+    FrameHandoff();
+
+    // producer: the slot to fill, then publish() makes it the latest frame
+    uint64_t *back() { return slots[back_index].rows; }
+    void publish();
+
+    // consumer: true when a frame newer than the last one taken was
+    // published, front() holds it from then on
+    bool take();
+    const uint64_t *front() const { return slots[front_index].rows; }
+
+  private:
+
+    // a cache line apart, so filling one slot never shares a line with
+    // the one being read
+    struct alignas(64) Slot
+    {
+      uint64_t rows[32];
+    };
+
+    static const unsigned char FRESH = 4; // set in 'middle' by publish, cleared by take
+
+    Slot slots[3];
+    unsigned char back_index;  // producer only
+    unsigned char front_index; // consumer only
+    std::atomic<unsigned char> middle; // slot index | FRESH
+
+    FrameHandoff( const FrameHandoff &);
+    FrameHandoff &operator=( const FrameHandoff &);
+
+};
+
+#endif // FRAMEHANDOFF_H_
@@ -0,0 +1,589 @@
+/**
+ * @brief  CHIP8 EMULATOR PROJECT
+ * @Author esantiago
+ * @date   October, 2026
+ *
+ * @description: GDB remote serial protocol stub source file
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include "GdbStub.h"
+
+using namespace std;
+
+
+static const char TARGET_XML[] =
+  "<?xml version=\"1.0\"?>"
+  "<!DOCTYPE target SYSTEM \"gdb-target.dtd\">"
+  "<target version=\"1.0\"><feature name=\"org.chip8.core\">"
+  "<reg name=\"v0\" bitsize=\"8\" regnum=\"0\"/><reg name=\"v1\" bitsize=\"8\"/>"
+  "<reg name=\"v2\" bitsize=\"8\"/><reg name=\"v3\" bitsize=\"8\"/>"
+  "<reg name=\"v4\" bitsize=\"8\"/><reg name=\"v5\" bitsize=\"8\"/>"
+  "<reg name=\"v6\" bitsize=\"8\"/><reg name=\"v7\" bitsize=\"8\"/>"
+  "<reg name=\"v8\" bitsize=\"8\"/><reg name=\"v9\" bitsize=\"8\"/>"
+  "<reg name=\"va\" bitsize=\"8\"/><reg name=\"vb\" bitsize=\"8\"/>"
+  "<reg name=\"vc\" bitsize=\"8\"/><reg name=\"vd\" bitsize=\"8\"/>"
+  "<reg name=\"ve\" bitsize=\"8\"/><reg name=\"vf\" bitsize=\"8\"/>"
+  "<reg name=\"i\" bitsize=\"16\" type=\"data_ptr\"/>"
+  "<reg name=\"pc\" bitsize=\"16\" type=\"code_ptr\"/>"
+  "<reg name=\"sp\" bitsize=\"8\"/><reg name=\"dt\" bitsize=\"8\"/><reg name=\"st\" bitsize=\"8\"/>"
+  "</feature></target>";
+
+static const char XFER_TARGET[] = "qXfer:features:read:target.xml";
+
+static const char *REGISTER_NAMES[Debugger::REGISTERS] =
+{
+  "v0", "v1", "v2", "v3", "v4", "v5", "v6", "v7", "v8", "v9", "va", "vb", "vc", "vd", "ve", "vf",
+  "i", "pc", "sp", "dt", "st"
+};
+
+
+// bytes a register takes in g/G/p/P, little endian
+static size_t registerSize( unsigned int reg)
+{
+  return reg == Debugger::REG_I || reg == Debugger::REG_PC ? 2 : 1;
+}
+
+
+static void appendHex( string &out, unsigned int value, size_t bytes)
+{
+  static const char digits[] = "0123456789abcdef";
+  for (size_t b = 0; b < bytes; ++b)
+  {
+    unsigned char byte = value >> (b * 8);
+    out += digits[byte >> 4];
+    out += digits[byte & 0xF];
+  }
+}
+
+
+static int hexDigit( char c)
+{
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+
+// little endian value of 'bytes' hex pairs at 'text', false if short
+static bool parseHexBytes( const char *text, size_t bytes, unsigned int &value)
+{
+  value = 0;
+  for (size_t b = 0; b < bytes; ++b)
+  {
+    int hi = hexDigit( text[b * 2]);
+    int lo = hi < 0 ? -1 : hexDigit( text[b * 2 + 1]);
+    if (lo < 0)
+      return false;
+    value |= (unsigned int)(hi << 4 | lo) << (b * 8);
+  }
+  return true;
+}
+
+
+GdbStub::GdbStub( Debugger &debugger)
+  : debugger(debugger), listener(-1), client(-1), reply_pending(false), cancelled(false)
+{
+  Debugger::Stop none = { Debugger::STOP_INTERRUPT, 0, 0 };
+  last_stop = none;
+  debugger.setStopHandler( onStop, this);
+}
+
+
+GdbStub::~GdbStub()
+{
+  close();
+  debugger.setStopHandler( NULL, NULL);
+}
+
+
+bool GdbStub::listenTcp( unsigned short port)
+{
+  close();
+  listener = socket( AF_INET, SOCK_STREAM, 0);
+  if (listener < 0)
+  {
+    printf( "gdb stub: socket failed: %s\n", strerror( errno));
+    return false;
+  }
+
+  int yes = 1;
+  setsockopt( listener, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+
+  // local only, the protocol has no authentication
+  sockaddr_in address;
+  memset( &address, 0, sizeof(address));
+  address.sin_family = AF_INET;
+  address.sin_port = htons( port);
+  address.sin_addr.s_addr = htonl( INADDR_LOOPBACK);
+  if (bind( listener, (sockaddr *)&address, sizeof(address)) < 0 || listen( listener, 1) < 0)
+  {
+    printf( "gdb stub: cannot listen on port %u: %s\n", port, strerror( errno));
+    close();
+    return false;
+  }
+
+  return true;
+
+}
+
+
+bool GdbStub::listenUnix( const char *path)
+{
+  close();
+  sockaddr_un address;
+  memset( &address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  if (strlen( path) >= sizeof(address.sun_path))
+  {
+    printf( "gdb stub: socket path too long: %s\n", path);
+    return false;
+  }
+  strcpy( address.sun_path, path);
+
+  listener = socket( AF_UNIX, SOCK_STREAM, 0);
+  unlink( path);
+  if (listener < 0 || bind( listener, (sockaddr *)&address, sizeof(address)) < 0 || listen( listener, 1) < 0)
+  {
+    printf( "gdb stub: cannot listen on %s: %s\n", path, strerror( errno));
+    close();
+    return false;
+  }
+  unix_path = path;
+
+  return true;
+
+}
+
+
+void GdbStub::close()
+{
+  disconnect();
+  if (listener >= 0)
+    ::close( listener);
+  listener = -1;
+  if (!unix_path.empty())
+    unlink( unix_path.c_str());
+  unix_path.clear();
+}
+
+
+// the client is gone: nothing stays armed and the core runs free
+void GdbStub::disconnect()
+{
+  if (client >= 0)
+    ::close( client);
+  client = -1;
+  input.clear();
+  reply_pending = false;
+  debugger.clearAll();
+}
+
+
+void GdbStub::poll()
+{
+  pollfd fd;
+
+  if (cancelled.load( memory_order_relaxed))
+  {
+    close();
+    return;
+  }
+
+  if (client < 0 && listener >= 0)
+  {
+    fd.fd = listener;
+    fd.events = POLLIN;
+    if (::poll( &fd, 1, 0) > 0)
+    {
+      client = accept( listener, NULL, NULL);
+      if (client >= 0)
+      {
+        int yes = 1;
+        setsockopt( client, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+        // GDB expects a stopped target when it attaches
+        debugger.requestStop();
+      }
+    }
+    return;
+  }
+
+  if (client < 0)
+    return;
+
+  // only an interrupt is expected while running, anything else waits
+  // in 'input' for the next stop
+  fd.fd = client;
+  fd.events = POLLIN;
+  while (::poll( &fd, 1, 0) > 0)
+  {
+    char buffer[256];
+    ssize_t size = recv( client, buffer, sizeof(buffer), 0);
+    if (size <= 0)
+    {
+      disconnect();
+      return;
+    }
+    for (ssize_t i = 0; i < size; ++i)
+    {
+      if (buffer[i] == 0x03)
+        debugger.requestStop();
+      else
+        input += buffer[i];
+    }
+  }
+
+}
+
+
+void GdbStub::onStop( Debugger &, const Debugger::Stop &stop, void *user)
+{
+  GdbStub *stub = static_cast<GdbStub *>( user);
+  stub->last_stop = stop;
+  if (stub->client >= 0)
+    stub->serve();
+}
+
+
+// runs while the core is stopped, until the client resumes or leaves
+void GdbStub::serve()
+{
+  if (reply_pending)
+  {
+    sendPacket( stopReply( last_stop));
+    reply_pending = false;
+  }
+
+  string packet;
+  while (client >= 0)
+  {
+    if (!readPacket( packet))
+    {
+      disconnect();
+      return;
+    }
+    if (!handle( packet))
+      return;
+  }
+
+}
+
+
+// blocks for one packet, acknowledges it; false when the client is gone
+bool GdbStub::readPacket( string &packet)
+{
+  while (client >= 0)
+  {
+    size_t start = input.find( '$');
+    size_t end = start == string::npos ? string::npos : input.find( '#', start);
+    if (end != string::npos && end + 2 < input.size())
+    {
+      packet = input.substr( start + 1, end - start - 1);
+      unsigned int sum = 0, expected;
+      for (size_t i = 0; i < packet.size(); ++i)
+        sum += (unsigned char)packet[i];
+      bool valid = parseHexBytes( input.c_str() + end + 1, 1, expected) && expected == (sum & 0xFF);
+      input.erase( 0, end + 3);
+      send( client, valid ? "+" : "-", 1, MSG_NOSIGNAL);
+      if (valid)
+        return true;
+      continue;
+    }
+
+    // acks and interrupts while stopped mean nothing here
+    if (start == string::npos)
+      input.clear();
+
+    // wait in slices, so cancel() gets through while the core is stopped
+    pollfd fd;
+    fd.fd = client;
+    fd.events = POLLIN;
+    if (::poll( &fd, 1, 100) <= 0)
+    {
+      if (cancelled.load( memory_order_relaxed))
+        return false;
+      continue;
+    }
+    char buffer[1024];
+    ssize_t size = recv( client, buffer, sizeof(buffer), 0);
+    if (size <= 0)
+      return false;
+    input.append( buffer, size);
+  }
+  return false;
+
+}
+
+
+void GdbStub::sendPacket( const string &data)
+{
+  unsigned int sum = 0;
+  for (size_t i = 0; i < data.size(); ++i)
+    sum += (unsigned char)data[i];
+
+  string framed = "$" + data + "#";
+  appendHex( framed, sum & 0xFF, 1);
+  if (send( client, framed.data(), framed.size(), MSG_NOSIGNAL) < 0)
+    disconnect();
+}
+
+
+string GdbStub::stopReply( const Debugger::Stop &stop) const
+{
+  char reply[32];
+  switch (stop.reason)
+  {
+    case Debugger::STOP_INTERRUPT:
+      return "S02";
+    case Debugger::STOP_WATCH_READ:
+      snprintf( reply, sizeof(reply), "T05rwatch:%x;", stop.address);
+      return reply;
+    case Debugger::STOP_WATCH_WRITE:
+      snprintf( reply, sizeof(reply), "T05watch:%x;", stop.address);
+      return reply;
+    case Debugger::STOP_HISTORY_START:
+      return "T05replaylog:begin;";
+    default:
+      return "S05";
+  }
+}
+
+
+// "monitor ..." commands, the text to show
+string GdbStub::monitor( const string &command)
+{
+  char verb[16], name[16];
+  if (sscanf( command.c_str(), "%15s %15s", verb, name) == 2 &&
+      (strcmp( verb, "watch") == 0 || strcmp( verb, "unwatch") == 0))
+  {
+    for (unsigned int r = 0; r < Debugger::REGISTERS; ++r)
+    {
+      if (strcasecmp( name, REGISTER_NAMES[r]) == 0)
+      {
+        debugger.watchRegister( r, verb[0] == 'w');
+        return string( verb[0] == 'w' ? "watching " : "not watching ") + REGISTER_NAMES[r] + "\n";
+      }
+    }
+    return string( "unknown register ") + name + "\n";
+  }
+  if (command == "history")
+  {
+    char text[64];
+    snprintf( text, sizeof(text), "%zu instructions can be reversed\n", debugger.historySize());
+    return text;
+  }
+  return "monitor commands: watch REG, unwatch REG, history\n";
+
+}
+
+
+// one packet while stopped; false when the core should run again
+bool GdbStub::handle( const string &packet)
+{
+  Chip8 &chip8 = debugger.machine();
+  const char *args = packet.c_str() + 1;
+  string reply;
+  unsigned int reg, value;
+  unsigned long address, length, kind;
+
+  switch (packet.empty() ? 0 : packet[0])
+  {
+    case '?':
+      reply = stopReply( last_stop);
+    break;
+
+    case 'g':
+      for (unsigned int r = 0; r < Debugger::REGISTERS; ++r)
+        appendHex( reply, Debugger::registerValue( chip8, r), registerSize( r));
+    break;
+
+    case 'G':
+    {
+      const char *hex = args;
+      for (unsigned int r = 0; r < Debugger::REGISTERS; ++r)
+      {
+        if (!parseHexBytes( hex, registerSize( r), value))
+          break;
+        debugger.setRegister( r, value);
+        hex += registerSize( r) * 2;
+      }
+      reply = "OK";
+    }
+    break;
+
+    case 'p':
+      reg = strtoul( args, NULL, 16);
+      if (reg < Debugger::REGISTERS)
+        appendHex( reply, Debugger::registerValue( chip8, reg), registerSize( reg));
+      else
+        reply = "E01";
+    break;
+
+    case 'P':
+    {
+      char *end;
+      reg = strtoul( args, &end, 16);
+      if (*end == '=' && reg < Debugger::REGISTERS && parseHexBytes( end + 1, registerSize( reg), value))
+      {
+        debugger.setRegister( reg, value);
+        reply = "OK";
+      }
+      else
+        reply = "E01";
+    }
+    break;
+
+    case 'm':
+      if (sscanf( args, "%lx,%lx", &address, &length) != 2)
+      {
+        reply = "E01";
+        break;
+      }
+      for (unsigned long i = 0; i < length && i < 4096; ++i)
+        appendHex( reply, chip8.ram()[(address + i) & 0xFFF], 1);
+    break;
+
+    case 'M':
+    {
+      const char *data = strchr( args, ':');
+      if (sscanf( args, "%lx,%lx", &address, &length) != 2 || data == NULL)
+      {
+        reply = "E01";
+        break;
+      }
+      ++data;
+      for (unsigned long i = 0; i < length; ++i)
+      {
+        if (!parseHexBytes( data + i * 2, 1, value))
+          break;
+        debugger.writeMemory( (address + i) & 0xFFF, value);
+      }
+      reply = "OK";
+    }
+    break;
+
+    case 'c':
+    case 's':
+      if (*args != 0)
+        debugger.setRegister( Debugger::REG_PC, strtoul( args, NULL, 16));
+      if (packet[0] == 's')
+        debugger.step();
+      else
+        debugger.resume();
+      reply_pending = true;
+    return false;
+
+    case 'b':
+      // reverse execution replies at once, the core stays stopped
+      if (packet == "bs")
+      {
+        Debugger::Stop stop = { Debugger::STOP_STEP, 0, 0 };
+        if (!debugger.reverseStep())
+          stop.reason = Debugger::STOP_HISTORY_START;
+        stop.address = Debugger::registerValue( chip8, Debugger::REG_PC);
+        last_stop = stop;
+        reply = stopReply( stop);
+      }
+      else if (packet == "bc")
+      {
+        last_stop = debugger.reverseContinue();
+        reply = stopReply( last_stop);
+      }
+    break;
+
+    case 'Z':
+    case 'z':
+    {
+      bool on = packet[0] == 'Z';
+      if (sscanf( args, "%lu,%lx,%lx", &kind, &address, &length) != 3)
+      {
+        reply = "E01";
+        break;
+      }
+      if (kind <= 1)
+        debugger.setBreakpoint( address, on);
+      else if (kind <= 4)
+      {
+        // 2 write, 3 read, 4 access
+        unsigned int flags = kind == 2 ? Debugger::WATCH_WRITE : kind == 3 ? Debugger::WATCH_READ :
+                             Debugger::WATCH_READ | Debugger::WATCH_WRITE;
+        debugger.setWatchpoint( address, length, flags, on);
+      }
+      else
+        break;
+      reply = "OK";
+    }
+    break;
+
+    case 'H':
+      reply = "OK";
+    break;
+
+    case 'D':
+      sendPacket( "OK");
+      disconnect();
+    return false;
+
+    case 'k':
+      disconnect();
+    return false;
+
+    case 'q':
+      if (packet.compare( 0, 10, "qSupported") == 0)
+        reply = "PacketSize=1000;qXfer:features:read+;ReverseStep+;ReverseContinue+";
+      else if (packet == "qAttached")
+        reply = "1";
+      else if (packet == "qC")
+        reply = "QC1";
+      else if (packet == "qfThreadInfo")
+        reply = "m1";
+      else if (packet == "qsThreadInfo")
+        reply = "l";
+      else if (packet.compare( 0, strlen( XFER_TARGET), XFER_TARGET) == 0)
+      {
+        unsigned long offset = 0;
+        length = 0;
+        sscanf( packet.c_str() + strlen( XFER_TARGET), ":%lx,%lx", &offset, &length);
+        size_t total = sizeof(TARGET_XML) - 1;
+        if (offset >= total)
+          reply = "l";
+        else
+        {
+          size_t chunk = length < total - offset ? length : total - offset;
+          reply = (offset + chunk < total ? "m" : "l") + string( TARGET_XML + offset, chunk);
+        }
+      }
+      else if (packet.compare( 0, 6, "qRcmd,") == 0)
+      {
+        string command;
+        for (size_t i = 6; i + 1 < packet.size(); i += 2)
+        {
+          if (parseHexBytes( packet.c_str() + i, 1, value))
+            command += (char)value;
+        }
+        string text = monitor( command);
+        string output = "O";
+        for (size_t i = 0; i < text.size(); ++i)
+          appendHex( output, (unsigned char)text[i], 1);
+        sendPacket( output);
+        reply = "OK";
+      }
+    break;
+  }
+
+  if (client >= 0)
+    sendPacket( reply);
+  return true;
+
+}
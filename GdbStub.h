@@ -0,0 +1,78 @@
+/**
+ * @brief  CHIP8 EMULATOR PROJECT
+ * @Author esantiago
+ * @date   October, 2026
+ *
+ * @description: Header file for the GDB remote serial protocol stub
+ *
+ * Serves one GDB remote protocol client over a local TCP port or a Unix
+ * socket, driving a Debugger. The host calls poll() between frames: it
+ * accepts a client (the core stops for it at the next instruction) and
+ * notices the client's interrupt. Everything else is served from the
+ * debugger's stop handler, on the thread running the core, while the
+ * core is stopped.
+ *
+ * Supported: registers (g, G, p, P), memory (m, M), continue and step
+ * (c, s), reverse step and continue (bs, bc), breakpoints (Z0, Z1),
+ * write, read and access watchpoints (Z2, Z3, Z4), detach and kill, and
+ * the target description. The registers are V0-VF, I, PC, SP, DT and ST,
+ * little endian. "monitor watch REG" and "monitor unwatch REG" stop when
+ * a register changes.
+ */
+
+#ifndef GDBSTUB_H_
+#define GDBSTUB_H_
+
+#include <string>
+#include <atomic>
+#include "Debugger.h"
+
+
+class GdbStub{
+
+  public:
+
+    explicit GdbStub( Debugger &debugger);
+    ~GdbStub();
+
+    // listens on 127.0.0.1:port, or on a Unix socket at 'path'; prints
+    // why and returns false when that fails
+    bool listenTcp( unsigned short port);
+    bool listenUnix( const char *path);
+    void close();
+
+    // between frames, on the thread running the core; never blocks
+    void poll();
+
+    bool connected() const { return client >= 0; }
+
+    // from any thread: a core stopped for the client resumes and the
+    // client is dropped, e.g. when the host quits
+    void cancel() { cancelled = true; }
+
+  private:
+
+    Debugger &debugger;
+    int listener;
+    int client;
+    std::string unix_path;
+    std::string input;           // bytes received, not yet a packet
+    bool reply_pending;          // the client resumed and waits for a stop reply
+    Debugger::Stop last_stop;
+    std::atomic<bool> cancelled;
+
+    static void onStop( Debugger &debugger, const Debugger::Stop &stop, void *user);
+    void serve();
+    bool handle( const std::string &packet);
+    bool readPacket( std::string &packet);
+    void sendPacket( const std::string &data);
+    std::string stopReply( const Debugger::Stop &stop) const;
+    std::string monitor( const std::string &command);
+    void disconnect();
+
+    GdbStub( const GdbStub &);
+    GdbStub &operator=( const GdbStub &);
+
+};
+
+#endif // GDBSTUB_H_
@@ -0,0 +1,47 @@
+/**
+ * @brief  CHIP8 EMULATOR PROJECT
+ * @Author esantiago
+ * @date   October, 2026
+ *
+ * @description: 1-bit to ARGB pixel expansion source file
+ */
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#include "GfxConvert.h"
+
+
+void expandRow( uint64_t row, uint32_t *dst, uint32_t on, uint32_t off)
+{
+#if defined(__SSE2__)
+  // Each sprite byte is broadcast to four lanes, every lane tests its own
+  // bit and the resulting all-ones / all-zeros mask selects the colour
+  const __m128i high_bits = _mm_set_epi32( 0x10, 0x20, 0x40, 0x80);
+  const __m128i low_bits  = _mm_set_epi32( 0x01, 0x02, 0x04, 0x08);
+  const __m128i on_color  = _mm_set1_epi32( on);
+  const __m128i off_color = _mm_set1_epi32( off);
+
+  for (size_t i = 0; i < 8; ++i)
+  {
+    __m128i byte = _mm_set1_epi32( (row >> (56 - 8 * i)) & 0xFF);
+    __m128i high = _mm_cmpeq_epi32( _mm_and_si128( byte, high_bits), high_bits);
+    __m128i low  = _mm_cmpeq_epi32( _mm_and_si128( byte, low_bits), low_bits);
+
+    _mm_storeu_si128( (__m128i *)&dst[8 * i],
+                      _mm_or_si128( _mm_and_si128( high, on_color), _mm_andnot_si128( high, off_color)));
+    _mm_storeu_si128( (__m128i *)&dst[8 * i + 4],
+                      _mm_or_si128( _mm_and_si128( low, on_color), _mm_andnot_si128( low, off_color)));
+  }
+#else
+  for (size_t x = 0; x < 64; ++x)
+    dst[x] = ((row >> (63 - x)) & 1) ? on : off;
+#endif
+}
+
+
+void expandRows( const uint64_t *rows, size_t first, size_t count, uint32_t *dst, uint32_t on, uint32_t off)
+{
+  for (size_t i = 0; i < count; ++i)
+    expandRow( rows[first + i], &dst[i * 64], on, off);
+}
@@ -0,0 +1,27 @@
+/**
+ * @brief  CHIP8 EMULATOR PROJECT
+ * @Author esantiago
+ * @date   October, 2026
+ *
+ * @description: Header file for the 1-bit to ARGB pixel expansion
+ *
+ * Kept apart from EmuGfx so the kernel can be used (and measured)
+ * without SDL.
+ */
+
+#ifndef GFXCONVERT_H_
+#define GFXCONVERT_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+// expands one packed display row (bit 63 = leftmost pixel) into 64 ARGB
+// pixels, 'on' for set bits and 'off' for clear ones
+void expandRow( uint64_t row, uint32_t *dst, uint32_t on, uint32_t off);
+
+// expands 'count' rows starting at 'first' into a 64-pixel wide buffer,
+// dst points at the pixel of row 'first'
+void expandRows( const uint64_t *rows, size_t first, size_t count, uint32_t *dst, uint32_t on, uint32_t off);
+
+#endif // GFXCONVERT_H_
@@ -0,0 +1,175 @@
+/**
+ * @brief  CHIP8 EMULATOR PROJECT
+ * @Author esantiago
+ * @date   October, 2026
+ *
+ * @description: Keypad input log source file
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "InputLog.h"
+
+using namespace std;
+
+
+static const unsigned char LOG_MAGIC[4] = { 'C', '8', 'I', 'N' };
+static const size_t HEADER_SIZE = 40; // 38 in version 2, 36 in version 1
+
+
+static void putLE( vector<unsigned char> &out, uint64_t value, size_t bytes)
+{
+  for (size_t i = 0; i < bytes; ++i)
+    out.push_back( (value >> (i * 8)) & 0xFF);
+}
+
+static uint64_t getLE( const unsigned char *p, size_t bytes)
+{
+  uint64_t value = 0;
+  for (size_t i = 0; i < bytes; ++i)
+    value |= (uint64_t)p[i] << (i * 8);
+  return value;
+}
+
+
+InputLog::InputLog()
+  : rng_seed(0), cycles_per_frame(0), quirk_set(0), start(0), end(0), frame_count(0), cursor(0), playing(0)
+{
+}
+
+
+void InputLog::begin( uint32_t seed, unsigned int cycles, uint64_t start_hash, unsigned int quirks)
+{
+  log.clear();
+  rng_seed = seed;
+  cycles_per_frame = cycles;
+  quirk_set = quirks;
+  start = start_hash;
+  end = 0;
+  frame_count = 0;
+  cursor = 0;
+  playing = 0;
+}
+
+
+void InputLog::record( unsigned int frame, const unsigned char key[16])
+{
+  uint16_t keys = 0;
+  for (size_t i = 0; i < 16; ++i)
+  {
+    if (key[i] != 0)
+      keys |= 1 << i;
+  }
+
+  uint16_t held = log.empty() ? 0 : log.back().keys;
+  if (keys != held)
+  {
+    Event event = { frame, keys };
+    log.push_back( event);
+  }
+
+  frame_count = frame + 1;
+}
+
+
+void InputLog::keysAt( unsigned int frame, unsigned char key[16])
+{
+  while (cursor < log.size() && log[cursor].frame <= frame)
+    playing = log[cursor++].keys;
+
+  for (size_t i = 0; i < 16; ++i)
+    key[i] = (playing >> i) & 1;
+}
+
+
+bool InputLog::save( const char *path) const
+{
+  vector<unsigned char> out( LOG_MAGIC, LOG_MAGIC + 4);
+  putLE( out, VERSION, 2);
+  putLE( out, cycles_per_frame, 4);
+  putLE( out, rng_seed, 4);
+  putLE( out, start, 8);
+  putLE( out, end, 8);
+  putLE( out, frame_count, 4);
+  putLE( out, log.size(), 4);
+  putLE( out, quirk_set, 2);
+
+  uint32_t previous = 0;
+  for (size_t i = 0; i < log.size(); ++i)
+  {
+    uint32_t delta = log[i].frame - previous;
+    previous = log[i].frame;
+    do
+    {
+      unsigned char byte = delta & 0x7F;
+      delta >>= 7;
+      out.push_back( delta != 0 ? byte | 0x80 : byte);
+    } while (delta != 0);
+    putLE( out, log[i].keys, 2);
+  }
+
+  FILE *file = fopen( path, "wb");
+  if (file == NULL)
+    return false;
+  bool ok = fwrite( &out[0], 1, out.size(), file) == out.size();
+  return fclose( file) == 0 && ok;
+}
+
+
+bool InputLog::load( const char *path)
+{
+  FILE *file = fopen( path, "rb");
+  if (file == NULL)
+    return false;
+
+  vector<unsigned char> in;
+  unsigned char chunk[4096];
+  size_t got;
+  while ((got = fread( chunk, 1, sizeof(chunk), file)) > 0)
+    in.insert( in.end(), chunk, chunk + got);
+  fclose( file);
+
+  if (in.size() < 6 || memcmp( &in[0], LOG_MAGIC, 4) != 0)
+    return false;
+  unsigned int version = getLE( &in[4], 2);
+  if (version < 1 || version > VERSION)
+    return false;
+
+  // versions 1 and 2 had a u16 cycles per frame, everything after it sits
+  // two bytes earlier
+  size_t ipf = version < 3 ? 2 : 4;
+  size_t header = HEADER_SIZE - (4 - ipf) - (version == 1 ? 2 : 0);
+  if (in.size() < header)
+    return false;
+
+  const unsigned char *fields = &in[6 + ipf];
+  begin( getLE( &fields[0], 4), getLE( &in[6], ipf), getLE( &fields[4], 8), version == 1 ? 0 : getLE( &fields[28], 2));
+  end = getLE( &fields[12], 8);
+  frame_count = getLE( &fields[20], 4);
+  size_t count = getLE( &fields[24], 4);
+
+  size_t at = header;
+  uint32_t frame = 0;
+  for (size_t i = 0; i < count; ++i)
+  {
+    uint32_t delta = 0;
+    for (unsigned int shift = 0; ; shift += 7)
+    {
+      if (at >= in.size() || shift > 28)
+        return false;
+      unsigned char byte = in[at++];
+      delta |= (uint32_t)(byte & 0x7F) << shift;
+      if ((byte & 0x80) == 0)
+        break;
+    }
+
+    if (at + 2 > in.size())
+      return false;
+    frame += delta;
+    Event event = { frame, (uint16_t)getLE( &in[at], 2) };
+    log.push_back( event);
+    at += 2;
+  }
+
+  return at == in.size();
+}
@@ -0,0 +1,82 @@
+/**
+ * @brief  CHIP8 EMULATOR PROJECT
+ * @Author esantiago
+ * @date   October, 2026
+ *
+ * @description: Header file for the keypad input log
+ *
+ * With a seeded RNG the only outside influence on a run is the keypad,
+ * so a run is fully described by the seed, the instructions per frame,
+ * the quirk set and the keypad state of every frame. The log stores the keypad only
+ * when it changes, as (frame delta, 16-bit key mask) pairs, plus the
+ * state hash before the first frame (catches a wrong ROM) and the rolling
+ * hash after the last one (what a replay has to reproduce).
+ *
+ * File layout, little-endian:
+ *   "C8IN", u16 version, u32 cycles per frame, u32 seed,
+ *   u64 start hash, u64 end hash, u32 frames, u32 events,
+ *   u16 quirks, events x (LEB128 frame delta, u16 key mask)
+ * Versions 1 and 2 stored cycles per frame as a u16; version 1 logs ran
+ * without quirks and have no quirks field.
+ */
+
+#ifndef INPUTLOG_H_
+#define INPUTLOG_H_
+
+#include <stdint.h>
+#include <vector>
+
+
+class InputLog{
+
+  public:
+
+    InputLog();
+
+    // starts an empty log for a run that is about to play frame 0
+    void begin( uint32_t seed, unsigned int cycles_per_frame, uint64_t start_hash, unsigned int quirks = 0);
+
+    // keypad as it is when 'frame' runs, frames are recorded in order
+    void record( unsigned int frame, const unsigned char key[16]);
+
+    // rolling hash after the last recorded frame
+    void finish( uint64_t end_hash) { end = end_hash; }
+
+    bool save( const char *path) const;
+    bool load( const char *path);
+
+    // keypad for 'frame' during playback, frames are asked for in order
+    void keysAt( unsigned int frame, unsigned char key[16]);
+
+    uint32_t seed() const { return rng_seed; }
+    unsigned int cyclesPerFrame() const { return cycles_per_frame; }
+    unsigned int quirks() const { return quirk_set; } // Chip8::QUIRK_* bits
+    uint64_t startHash() const { return start; }
+    uint64_t endHash() const { return end; }
+    unsigned int frames() const { return frame_count; }
+    size_t events() const { return log.size(); }
+
+    static const unsigned short VERSION = 3;
+
+  private:
+
+    struct Event
+    {
+      uint32_t frame;
+      uint16_t keys; // bit n = key n held
+    };
+
+    std::vector<Event> log;
+    uint32_t rng_seed;
+    unsigned int cycles_per_frame;
+    unsigned int quirk_set;
+    uint64_t start;
+    uint64_t end;
+    unsigned int frame_count;
+
+    size_t cursor;   // next event for keysAt
+    uint16_t playing; // mask keysAt is holding
+
+};
+
+#endif // INPUTLOG_H_
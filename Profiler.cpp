@@ -0,0 +1,336 @@
+/**
+ * @brief  CHIP8 EMULATOR PROJECT
+ * @Author esantiago
+ * @date   October, 2026
+ *
+ * @description: Execution profiler source file
+ */
+
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#include "Profiler.h"
+#include "Disasm.h"
+
+using namespace std;
+
+
+static const char *const CLASS_NAMES[Profiler::CLASS_COUNT] =
+{
+  "00E0 CLS", "00EE RET", "1nnn JP", "2nnn CALL", "3xkk SE", "4xkk SNE", "5xy0 SE",
+  "6xkk LD", "7xkk ADD", "8xy0 LD", "8xy1 OR", "8xy2 AND", "8xy3 XOR", "8xy4 ADD",
+  "8xy5 SUB", "8xy6 SHR", "8xy7 SUBN", "8xyE SHL", "9xy0 SNE", "Annn LD I", "Bnnn JP V0",
+  "Cxkk RND", "Dxyn DRW", "Ex9E SKP", "ExA1 SKNP", "Fx07 LD Vx, DT", "Fx0A LD Vx, K",
+  "Fx15 LD DT, Vx", "Fx18 LD ST, Vx", "Fx1E ADD I", "Fx29 LD F", "Fx33 LD B", "Fx55 LD [I], Vx",
+  "Fx65 LD Vx, [I]",
+  "unknown"
+};
+
+
+// class of an opcode as the emulator executes it (see Chip8::decodeOpcode)
+static unsigned char classOf( unsigned short opcode)
+{
+  static const unsigned char ALU[16] = { 9, 10, 11, 12, 13, 14, 15, 16, 34, 34, 34, 34, 34, 34, 17, 34 };
+  unsigned int n = opcode & 0x000F;
+  unsigned int kk = opcode & 0x00FF;
+
+  switch(opcode & 0xF000)
+  {
+    case 0x0000: return n == 0x0 ? 0 : n == 0xE ? 1 : 34;
+    case 0x1000: return 2;
+    case 0x2000: return 3;
+    case 0x3000: return 4;
+    case 0x4000: return 5;
+    case 0x5000: return 6;
+    case 0x6000: return 7;
+    case 0x7000: return 8;
+    case 0x8000: return ALU[n];
+    case 0x9000: return 18;
+    case 0xA000: return 19;
+    case 0xB000: return 20;
+    case 0xC000: return 21;
+    case 0xD000: return 22;
+    case 0xE000: return kk == 0x9E ? 23 : kk == 0xA1 ? 24 : 34;
+    case 0xF000:
+      switch(kk)
+      {
+        case 0x07: return 25;
+        case 0x0A: return 26;
+        case 0x15: return 27;
+        case 0x18: return 28;
+        case 0x1E: return 29;
+        case 0x29: return 30;
+        case 0x33: return 31;
+        case 0x55: return 32;
+        case 0x65: return 33;
+      }
+  }
+  return 34;
+}
+
+
+// shared by every profiler, built once on first use
+static const unsigned char *classTable()
+{
+  struct Table
+  {
+    unsigned char op_class[65536];
+    Table()
+    {
+      for (size_t op = 0; op < 65536; ++op)
+        op_class[op] = classOf( op);
+    }
+  };
+  static const Table table;
+  return table.op_class;
+}
+
+
+Profiler::Profiler()
+  : class_table(classTable())
+{
+  root.entry = 0x200;
+  root.parent = NULL;
+  reset();
+}
+
+
+Profiler::~Profiler()
+{
+  clearFrame( root);
+}
+
+
+void Profiler::clearFrame( Frame &f)
+{
+  for (map<unsigned short, Frame *>::iterator it = f.children.begin(); it != f.children.end(); ++it)
+  {
+    clearFrame( *it->second);
+    delete it->second;
+  }
+  f.children.clear();
+}
+
+
+void Profiler::reset()
+{
+  clearFrame( root);
+  root.counts.assign( 4096, 0);
+  root.calls = 0;
+  frame = &root;
+  depth = 0;
+  lost = 0;
+  memset( class_counts, 0, sizeof(class_counts));
+  memset( pc_counts, 0, sizeof(pc_counts));
+  draw.calls = draw.ticks = 0;
+  present.calls = present.ticks = 0;
+}
+
+
+void Profiler::enter( unsigned short entry)
+{
+  if (depth >= MAX_DEPTH)
+  {
+    ++lost;
+    return;
+  }
+
+  Frame *&child = frame->children[entry];
+  if (child == NULL)
+  {
+    child = new Frame;
+    child->entry = entry;
+    child->parent = frame;
+    child->counts.assign( 4096, 0);
+    child->calls = 0;
+  }
+
+  ++child->calls;
+  frame = child;
+  ++depth;
+}
+
+
+// a RET with nothing to return to (the program manages the stack
+// itself) stays in the current frame
+void Profiler::leave()
+{
+  if (lost > 0)
+    --lost;
+  else if (frame->parent != NULL)
+  {
+    frame = frame->parent;
+    --depth;
+  }
+}
+
+
+uint64_t Profiler::ticks()
+{
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return chrono::duration_cast<chrono::nanoseconds>(
+           chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+
+// measured once against the steady clock
+double Profiler::ticksPerSecond()
+{
+  static double rate = 0;
+  if (rate == 0)
+  {
+    chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+    uint64_t start = ticks();
+    this_thread::sleep_for( chrono::milliseconds( 20));
+    uint64_t stop = ticks();
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - t0;
+    rate = (stop - start) / elapsed.count();
+  }
+  return rate;
+}
+
+
+const char *Profiler::className( unsigned int op_class)
+{
+  return op_class < CLASS_COUNT ? CLASS_NAMES[op_class] : "?";
+}
+
+
+unsigned short Profiler::opcodeAt( const Chip8 &chip8, size_t address)
+{
+  const unsigned char *memory = chip8.memory;
+  return memory[address & 0xFFF] << 8 | memory[(address + 1) & 0xFFF];
+}
+
+
+void Profiler::selfCounts( const Frame &f, map<unsigned short, uint64_t> &self,
+                           map<unsigned short, uint64_t> &calls) const
+{
+  uint64_t sum = 0;
+  for (size_t i = 0; i < 4096; ++i)
+    sum += f.counts[i];
+  self[f.entry] += sum;
+  calls[f.entry] += f.calls;
+
+  for (map<unsigned short, Frame *>::const_iterator it = f.children.begin(); it != f.children.end(); ++it)
+    selfCounts( *it->second, self, calls);
+}
+
+
+static bool byCount( const pair<uint64_t, size_t> &a, const pair<uint64_t, size_t> &b)
+{
+  return a.first > b.first;
+}
+
+
+void Profiler::report( FILE *out, const Chip8 &chip8, size_t top) const
+{
+  uint64_t total = 0;
+  for (size_t i = 0; i < CLASS_COUNT; ++i)
+    total += class_counts[i];
+  double percent = total > 0 ? 100.0 / total : 0;
+  double ns_per_tick = 1e9 / ticksPerSecond();
+  char text[32];
+
+  fprintf( out, "%llu instructions, %llu unknown opcodes\n", (unsigned long long)total,
+           chip8.unknownOpcodes());
+  fprintf( out, "Dxyn:    %10llu draws  %10.3f ms  %8.1f ns/draw\n", draw.calls,
+           draw.ticks * ns_per_tick / 1e6, draw.calls > 0 ? draw.ticks * ns_per_tick / draw.calls : 0.0);
+  fprintf( out, "drawGfx: %10llu frames %10.3f ms  %8.1f ns/frame\n", present.calls,
+           present.ticks * ns_per_tick / 1e6,
+           present.calls > 0 ? present.ticks * ns_per_tick / present.calls : 0.0);
+
+  vector< pair<uint64_t, size_t> > rows;
+  for (size_t i = 0; i < CLASS_COUNT; ++i)
+  {
+    if (class_counts[i] > 0)
+      rows.push_back( make_pair( class_counts[i], i));
+  }
+  sort( rows.begin(), rows.end(), byCount);
+
+  fprintf( out, "\nopcode classes\n");
+  for (size_t i = 0; i < rows.size(); ++i)
+    fprintf( out, "  %14llu %6.2f%%  %s\n", (unsigned long long)rows[i].first, rows[i].first * percent,
+             CLASS_NAMES[rows[i].second]);
+
+  rows.clear();
+  for (size_t pc = 0; pc < 4096; ++pc)
+  {
+    if (pc_counts[pc] > 0)
+      rows.push_back( make_pair( pc_counts[pc], pc));
+  }
+  sort( rows.begin(), rows.end(), byCount);
+
+  fprintf( out, "\nhot addresses\n");
+  for (size_t i = 0; i < rows.size() && i < top; ++i)
+    fprintf( out, "  0x%03zX %14llu %6.2f%%  %s\n", rows[i].second, (unsigned long long)rows[i].first,
+             rows[i].first * percent, disassemble( opcodeAt( chip8, rows[i].second), text, sizeof(text)));
+
+  // a loop is a backward JP that was taken, weighted by what ran inside it
+  vector< pair<uint64_t, size_t> > loops;
+  for (size_t pc = 0; pc < 4096; ++pc)
+  {
+    unsigned short opcode = opcodeAt( chip8, pc);
+    if (pc_counts[pc] == 0 || (opcode & 0xF000) != 0x1000 || (opcode & 0x0FFF) > pc)
+      continue;
+    uint64_t inside = 0;
+    for (size_t at = opcode & 0x0FFF; at <= pc; ++at)
+      inside += pc_counts[at];
+    loops.push_back( make_pair( inside, pc));
+  }
+  sort( loops.begin(), loops.end(), byCount);
+
+  fprintf( out, "\nhot loops (backward jumps)\n");
+  for (size_t i = 0; i < loops.size() && i < top; ++i)
+  {
+    size_t pc = loops[i].second;
+    fprintf( out, "  0x%03X-0x%03zX %14llu %6.2f%%  %llu iterations\n", opcodeAt( chip8, pc) & 0x0FFF, pc,
+             (unsigned long long)loops[i].first, loops[i].first * percent, (unsigned long long)pc_counts[pc]);
+  }
+
+  map<unsigned short, uint64_t> self, calls;
+  selfCounts( root, self, calls);
+  rows.clear();
+  for (map<unsigned short, uint64_t>::iterator it = self.begin(); it != self.end(); ++it)
+    rows.push_back( make_pair( it->second, it->first));
+  sort( rows.begin(), rows.end(), byCount);
+
+  fprintf( out, "\nsubroutines (self)\n");
+  for (size_t i = 0; i < rows.size() && i < top; ++i)
+    fprintf( out, "  %s 0x%03zX %14llu %6.2f%%  %llu calls\n", rows[i].second == root.entry ? "main" : "sub ",
+             rows[i].second, (unsigned long long)rows[i].first, rows[i].first * percent,
+             (unsigned long long)calls[rows[i].second]);
+
+}
+
+
+void Profiler::collapse( FILE *out, const Chip8 &chip8, const Frame &f, const string &stack) const
+{
+  char text[32];
+  for (size_t pc = 0; pc < 4096; ++pc)
+  {
+    if (f.counts[pc] > 0)
+      fprintf( out, "%s;0x%03zX %s %llu\n", stack.c_str(), pc,
+               disassemble( opcodeAt( chip8, pc), text, sizeof(text)), (unsigned long long)f.counts[pc]);
+  }
+
+  for (map<unsigned short, Frame *>::const_iterator it = f.children.begin(); it != f.children.end(); ++it)
+  {
+    char name[16];
+    snprintf( name, sizeof(name), ";sub_0x%03X", it->first);
+    collapse( out, chip8, *it->second, stack + name);
+  }
+}
+
+
+void Profiler::writeCollapsed( FILE *out, const Chip8 &chip8) const
+{
+  collapse( out, chip8, root, "main");
+}
@@ -0,0 +1,131 @@
+/**
+ * @brief  CHIP8 EMULATOR PROJECT
+ * @Author esantiago
+ * @date   October, 2026
+ *
+ * @description: Header file for the execution profiler
+ *
+ * Only compiled in with -DCHIP8_PROFILE (see the Makefile), otherwise the
+ * core has no hooks at all. With a Profiler attached every instruction
+ * counts towards its opcode class, its address and its call stack (the
+ * chain of CALL targets that led to it, tracked from CALL/RET), and
+ * sprite drawing and frame presentation are timed with the cycle
+ * counter. The instruction hook is a table lookup and three increments.
+ *
+ * report() prints the opcode classes, the hottest addresses, loops and
+ * subroutines; writeCollapsed() writes one line per (call stack, address)
+ * in the collapsed format flamegraph.pl and speedscope read, the leaf
+ * frame being the address and its disassembly.
+ */
+
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <map>
+#include <string>
+#include <vector>
+#include "Chip8.h"
+
+
+class Profiler{
+
+  public:
+
+    Profiler();
+    ~Profiler();
+
+    // calls and cycle counter ticks of one timed activity
+    struct Stat
+    {
+      unsigned long long calls;
+      uint64_t ticks;
+    };
+
+    // times its scope into 'stat', does nothing when 'stat' is NULL
+    class Timer
+    {
+      public:
+        Timer( Stat *stat) : stat(stat), start(stat != NULL ? ticks() : 0) {}
+        ~Timer()
+        {
+          if (stat != NULL)
+          {
+            ++stat->calls;
+            stat->ticks += ticks() - start;
+          }
+        }
+      private:
+        Stat *stat;
+        uint64_t start;
+    };
+
+    Stat draw;    // Dxyn
+    Stat present; // EmuGfx::drawGfx
+
+    // hot path, called before the instruction at 'pc' executes
+    void instruction( unsigned short pc, unsigned short opcode)
+    {
+      pc &= 0xFFF;
+      ++class_counts[class_table[opcode]];
+      ++pc_counts[pc];
+      ++frame->counts[pc];
+      if ((opcode & 0xF000) == 0x2000)
+        enter( opcode & 0x0FFF);
+      else if ((opcode & 0xF00F) == 0x000E)
+        leave();
+    }
+
+    void reset();
+
+    // hotspot report, 'top' entries per table; addresses are disassembled
+    // from the memory of 'chip8' as it is now
+    void report( FILE *out, const Chip8 &chip8, size_t top = 20) const;
+    void writeCollapsed( FILE *out, const Chip8 &chip8) const;
+
+    // cycle counter (TSC on x86, nanoseconds elsewhere)
+    static uint64_t ticks();
+    static double ticksPerSecond();
+
+    enum { CLASS_COUNT = 35 };
+    static const char *className( unsigned int op_class);
+
+  private:
+
+    // a node of the call tree, one per distinct chain of CALL targets
+    struct Frame
+    {
+      unsigned short entry; // CALL target, 0x200 for the root
+      Frame *parent;
+      std::map<unsigned short, Frame *> children;
+      std::vector<uint64_t> counts; // per address
+      uint64_t calls;
+    };
+
+    static const unsigned int MAX_DEPTH = 64;
+
+    const unsigned char *class_table; // opcode -> class
+    uint64_t class_counts[CLASS_COUNT];
+    uint64_t pc_counts[4096];
+
+    Frame root;
+    Frame *frame;     // current call stack
+    unsigned int depth;
+    unsigned int lost; // CALLs past MAX_DEPTH that are not tracked
+
+    static unsigned short opcodeAt( const Chip8 &chip8, size_t address);
+    void enter( unsigned short entry);
+    void leave();
+    void clearFrame( Frame &f);
+    void collapse( FILE *out, const Chip8 &chip8, const Frame &f, const std::string &stack) const;
+    void selfCounts( const Frame &f, std::map<unsigned short, uint64_t> &self,
+                     std::map<unsigned short, uint64_t> &calls) const;
+
+    Profiler( const Profiler &);
+    Profiler &operator=( const Profiler &);
+
+};
+
+#endif // PROFILER_H_
@@ -0,0 +1,174 @@
+/**
+ * @brief  CHIP8 EMULATOR PROJECT
+ * @Author esantiago
+ * @date   October, 2026
+ *
+ * @description: Rewind history source file
+ *
+ * Delta format: a sequence of runs, each one
+ *   u16 zero bytes to skip, u16 literal length, literal bytes
+ * where the literal bytes are the XOR of the two snapshots. A literal
+ * only ends at four or more zero bytes (or the end), so every run after
+ * the first covers at least as many bytes as it takes and a delta never
+ * exceeds STATE_SIZE + 4 bytes.
+ */
+
+#include <string.h>
+#include "Rewind.h"
+
+using namespace std;
+
+
+Rewind::Rewind( size_t capacity, size_t max_frames)
+  : ring(capacity), deltas(max_frames > 0 ? max_frames : 1), first(0), count(0),
+    write_pos(0), used(0), have_latest(false), latest(Chip8::STATE_SIZE),
+    current(Chip8::STATE_SIZE), encoded(Chip8::STATE_SIZE + 4)
+{
+}
+
+
+void Rewind::clear()
+{
+  first = 0;
+  count = 0;
+  write_pos = 0;
+  used = 0;
+  have_latest = false;
+}
+
+
+void Rewind::dropOldest()
+{
+  used -= deltas[first].size;
+  first = (first + 1) % deltas.size();
+  --count;
+}
+
+
+void Rewind::push( const Chip8 &chip8)
+{
+  chip8.saveState( &current[0]);
+
+  if (!have_latest)
+  {
+    latest.swap( current);
+    have_latest = true;
+    return;
+  }
+
+  // the delta takes the new snapshot back to the previous one
+  size_t size = encode( &current[0], &latest[0], &encoded[0]);
+  latest.swap( current);
+
+  if (size > ring.size())
+  {
+    first = count = write_pos = used = 0;
+    return;
+  }
+
+  // no room before the end of the ring: whatever still lies past
+  // write_pos is the oldest history, drop it and wrap around
+  if (write_pos + size > ring.size())
+  {
+    while (count > 0 && deltas[first].offset >= write_pos)
+      dropOldest();
+    write_pos = 0;
+  }
+
+  while (count > 0 && (count == deltas.size() ||
+         (deltas[first].offset < write_pos + size &&
+          deltas[first].offset + deltas[first].size > write_pos)))
+    dropOldest();
+
+  if (size > 0)
+    memcpy( &ring[write_pos], &encoded[0], size);
+
+  Delta &d = deltas[(first + count) % deltas.size()];
+  d.offset = write_pos;
+  d.size = size;
+  ++count;
+  used += size;
+  write_pos += size;
+
+}
+
+
+bool Rewind::rewind( Chip8 &chip8)
+{
+  if (count == 0)
+    return false;
+
+  const Delta &d = deltas[(first + count - 1) % deltas.size()];
+  apply( &ring[d.offset], d.size, &latest[0]);
+  --count;
+  used -= d.size;
+  write_pos = count > 0 ? d.offset : 0;
+
+  return chip8.loadState( &latest[0], latest.size());
+
+}
+
+
+size_t Rewind::encode( const unsigned char *a, const unsigned char *b, unsigned char *out)
+{
+  const size_t n = Chip8::STATE_SIZE;
+  size_t length = 0;
+  size_t i = 0;
+
+  while (i < n)
+  {
+    size_t zeros = 0;
+    while (i + zeros < n && a[i + zeros] == b[i + zeros])
+      ++zeros;
+    if (i + zeros == n)
+      break;
+
+    size_t start = i + zeros;
+    size_t end = start;
+    while (end < n)
+    {
+      if (a[end] != b[end])
+      {
+        ++end;
+        continue;
+      }
+
+      size_t run = 0;
+      while (end + run < n && a[end + run] == b[end + run])
+        ++run;
+      if (run >= 4 || end + run == n)
+        break;
+      end += run;
+    }
+
+    out[length++] = zeros & 0xFF;
+    out[length++] = zeros >> 8;
+    out[length++] = (end - start) & 0xFF;
+    out[length++] = (end - start) >> 8;
+    for (size_t k = start; k < end; ++k)
+      out[length++] = a[k] ^ b[k];
+
+    i = end;
+  }
+
+  return length;
+
+}
+
+
+void Rewind::apply( const unsigned char *delta, size_t size, unsigned char *state)
+{
+  size_t at = 0;
+  size_t i = 0;
+
+  while (i + 4 <= size)
+  {
+    at += delta[i] | (delta[i + 1] << 8);
+    size_t literal = delta[i + 2] | (delta[i + 3] << 8);
+    i += 4;
+
+    for (size_t k = 0; k < literal; ++k)
+      state[at++] ^= delta[i++];
+  }
+
+}
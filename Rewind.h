@@ -0,0 +1,76 @@
+/**
+ * @brief  CHIP8 EMULATOR PROJECT
+ * @Author esantiago
+ * @date   October, 2026
+ *
+ * @description: Header file for the rewind history
+ *
+ * Keeps one Chip8 snapshot per frame in a fixed amount of memory. Only
+ * the newest snapshot is stored in full; every older frame is a reverse
+ * delta (the XOR against the frame after it, run-length encoded) in a
+ * byte ring. A typical frame changes a handful of registers, a timer and
+ * maybe a few display rows, so a delta is tens of bytes and minutes of
+ * history fit in a few megabytes. When the ring is full the oldest frames
+ * are dropped. Capturing costs one saveState plus a linear pass over the
+ * snapshot, a few microseconds, so it runs inline between frames.
+ */
+
+#ifndef REWIND_H_
+#define REWIND_H_
+
+#include <stddef.h>
+#include <vector>
+#include "Chip8.h"
+
+
+class Rewind{
+
+  public:
+
+    // 'capacity' bytes of deltas, never more than 'max_frames' of them
+    // (default: 5 minutes at 60 Hz in 4 MB)
+    Rewind( size_t capacity = 4 << 20, size_t max_frames = 5 * 60 * 60);
+
+    // records the current state as the newest frame
+    void push( const Chip8 &chip8);
+
+    // steps back one frame: restores the frame before the newest one and
+    // forgets the newest, false when there is no older frame
+    bool rewind( Chip8 &chip8);
+
+    void clear();
+
+    // frames that can still be rewound
+    size_t frames() const { return count; }
+    size_t bytesUsed() const { return used; }
+
+  private:
+
+    struct Delta
+    {
+      size_t offset; // in ring
+      size_t size;
+    };
+
+    std::vector<unsigned char> ring;
+    std::vector<Delta> deltas; // circular, oldest at 'first'
+    size_t first;
+    size_t count;
+    size_t write_pos;
+    size_t used;
+
+    bool have_latest;
+    std::vector<unsigned char> latest;  // newest snapshot in full
+    std::vector<unsigned char> current; // scratch for the incoming one
+    std::vector<unsigned char> encoded; // scratch for its delta
+
+    void dropOldest();
+    static size_t encode( const unsigned char *a, const unsigned char *b, unsigned char *out);
+    static void apply( const unsigned char *delta, size_t size, unsigned char *state);
+
+    Rewind( const Rewind &);
+    Rewind &operator=( const Rewind &);
+
+};
+
+#endif // REWIND_H_
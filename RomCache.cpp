@@ -0,0 +1,141 @@
+/**
+ * @brief  CHIP8 EMULATOR PROJECT
+ * @Author esantiago
+ * @date   October, 2026
+ *
+ * @description: Process-wide ROM cache source file
+ */
+
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "RomCache.h"
+
+using namespace std;
+
+
+RomCache &RomCache::instance()
+{
+  static RomCache cache;
+  return cache;
+}
+
+
+RomCache::~RomCache()
+{
+  for (multimap<uint64_t, RomImage *>::iterator it = by_hash.begin(); it != by_hash.end(); ++it)
+  {
+    munmap( (void *)it->second->data, it->second->size);
+    delete it->second;
+  }
+}
+
+
+uint64_t RomCache::hash( const unsigned char *data, size_t size)
+{
+  uint64_t h = 0xCBF29CE484222325ULL;
+  for (size_t i = 0; i < size; ++i)
+    h = (h ^ data[i]) * 0x100000001B3ULL;
+  return h;
+}
+
+
+size_t RomCache::images() const
+{
+  lock_guard<mutex> guard( lock);
+  return by_hash.size();
+}
+
+
+static bool validRom( const struct stat &st)
+{
+  return S_ISREG( st.st_mode) && st.st_size > 0 && (unsigned long long)st.st_size <= RomCache::MAX_ROM_SIZE;
+}
+
+
+void RomCache::describe( const struct stat &st, PathEntry &entry)
+{
+  entry.device = st.st_dev;
+  entry.inode = st.st_ino;
+  entry.size = st.st_size;
+  entry.mtime_sec = st.st_mtim.tv_sec;
+  entry.mtime_nsec = st.st_mtim.tv_nsec;
+  entry.image = NULL;
+}
+
+
+const RomImage *RomCache::load( const char *path)
+{
+  struct stat st;
+  if (stat( path, &st) != 0 || !validRom( st))
+    return NULL;
+
+  PathEntry entry;
+  describe( st, entry);
+
+  lock_guard<mutex> guard( lock);
+
+  map<string, PathEntry>::iterator known = by_path.find( path);
+  if (known != by_path.end() && known->second.device == entry.device &&
+      known->second.inode == entry.inode && known->second.size == entry.size &&
+      known->second.mtime_sec == entry.mtime_sec && known->second.mtime_nsec == entry.mtime_nsec)
+    return known->second.image;
+
+  // the file may have changed between the stat and the open
+  int fd = open( path, O_RDONLY);
+  if (fd < 0)
+    return NULL;
+  if (fstat( fd, &st) != 0 || !validRom( st))
+  {
+    close( fd);
+    return NULL;
+  }
+  describe( st, entry);
+
+  void *mapping = mmap( NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close( fd);
+  if (mapping == MAP_FAILED)
+    return NULL;
+
+  const unsigned char *data = (const unsigned char *)mapping;
+  size_t size = st.st_size;
+  uint64_t h = hash( data, size);
+
+  // same content under another path (or the same file rewritten)
+  pair<multimap<uint64_t, RomImage *>::iterator, multimap<uint64_t, RomImage *>::iterator> same =
+    by_hash.equal_range( h);
+  for (multimap<uint64_t, RomImage *>::iterator it = same.first; it != same.second; ++it)
+  {
+    if (it->second->size == size && memcmp( it->second->data, data, size) == 0)
+    {
+      munmap( mapping, size);
+      entry.image = it->second;
+      by_path[path] = entry;
+      return entry.image;
+    }
+  }
+
+  // a file rewritten in place would change (or, truncated, fault) under
+  // a file mapping, so a new image is sealed into read-only pages of its own
+  void *pages = mmap( NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (pages == MAP_FAILED)
+  {
+    munmap( mapping, size);
+    return NULL;
+  }
+  memcpy( pages, data, size);
+  munmap( mapping, size);
+  mprotect( pages, size, PROT_READ);
+
+  RomImage *image = new RomImage;
+  image->data = (const unsigned char *)pages;
+  image->size = size;
+  image->hash = h;
+  by_hash.insert( make_pair( h, image));
+
+  entry.image = image;
+  by_path[path] = entry;
+  return image;
+}
@@ -0,0 +1,77 @@
+/**
+ * @brief  CHIP8 EMULATOR PROJECT
+ * @Author esantiago
+ * @date   October, 2026
+ *
+ * @description: Header file for the process-wide ROM cache
+ *
+ * ROM files are memory mapped and validated (1 to 3584 bytes, what fits
+ * from 0x200 to the end of memory). Images are keyed by a 64-bit FNV-1a
+ * hash of their content, so every path holding the same bytes shares one
+ * read-only image; only new content is copied out of the file mapping.
+ * A path that was already loaded, and has not changed on disk since
+ * (same inode, size and mtime), is found with a single fstat. Images
+ * live as long as the process and can be used from any thread.
+ */
+
+#ifndef ROMCACHE_H_
+#define ROMCACHE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <map>
+#include <mutex>
+#include <string>
+
+struct stat;
+
+
+struct RomImage
+{
+  const unsigned char *data; // read-only mapping
+  size_t size;
+  uint64_t hash;
+};
+
+
+class RomCache{
+
+  public:
+
+    static const size_t MAX_ROM_SIZE = 4096 - 512;
+
+    static RomCache &instance();
+
+    // the shared image of the file at 'path', NULL when it cannot be
+    // mapped or is not a valid size
+    const RomImage *load( const char *path);
+
+    size_t images() const;
+
+    static uint64_t hash( const unsigned char *data, size_t size);
+
+  private:
+
+    RomCache() {}
+    ~RomCache();
+
+    // what a path resolved to the last time, to skip the mapping
+    struct PathEntry
+    {
+      unsigned long long device, inode, size;
+      long long mtime_sec, mtime_nsec;
+      const RomImage *image;
+    };
+
+    static void describe( const struct stat &st, PathEntry &entry);
+
+    mutable std::mutex lock;
+    std::multimap<uint64_t, RomImage *> by_hash;
+    std::map<std::string, PathEntry> by_path;
+
+    RomCache( const RomCache &);
+    RomCache &operator=( const RomCache &);
+
+};
+
+#endif // ROMCACHE_H_
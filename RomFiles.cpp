@@ -0,0 +1,134 @@
+/**
+ * @brief  CHIP8 EMULATOR PROJECT
+ * @Author esantiago
+ * @date   October, 2026
+ *
+ * @description: ROM path helpers shared by the tools
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include "RomFiles.h"
+#include "Chip8.h"
+
+using namespace std;
+
+
+static const struct
+{
+  const char *name;
+  unsigned int bit;
+} QUIRK_NAMES[] =
+{
+  { "shift-vy",  Chip8::QUIRK_SHIFT_VY },
+  { "keep-i",    Chip8::QUIRK_KEEP_I },
+  { "no-add-vf", Chip8::QUIRK_NO_ADD_VF },
+  { "wrap",      Chip8::QUIRK_WRAP },
+  { "vf-reset",  Chip8::QUIRK_VF_RESET }
+};
+static const size_t QUIRK_COUNT = sizeof(QUIRK_NAMES) / sizeof(QUIRK_NAMES[0]);
+
+
+static bool endsWith( const string &s, const char *suffix)
+{
+  size_t n = strlen( suffix);
+  return s.size() >= n && s.compare( s.size() - n, n, suffix) == 0;
+}
+
+
+void collectRoms( const char *path, vector<string> &roms)
+{
+  struct stat st;
+  if (stat( path, &st) != 0)
+  {
+    printf( "Unable to open %s\n", path);
+    return;
+  }
+
+  if (!S_ISDIR(st.st_mode))
+  {
+    roms.push_back( path);
+    return;
+  }
+
+  DIR *dir = opendir( path);
+  if (dir == NULL)
+    return;
+
+  vector<string> entries;
+  struct dirent *entry;
+  while ((entry = readdir( dir)) != NULL)
+  {
+    string full = string(path) + "/" + entry->d_name;
+    if (endsWith( full, ".state") || endsWith( full, ".quirks"))
+      continue;
+    if (stat( full.c_str(), &st) == 0 && S_ISREG(st.st_mode))
+      entries.push_back( full);
+  }
+  closedir( dir);
+
+  sort( entries.begin(), entries.end());
+  roms.insert( roms.end(), entries.begin(), entries.end());
+}
+
+
+bool parseQuirks( const char *spec, unsigned int &quirks)
+{
+  unsigned int bits = 0;
+  string list( spec);
+  size_t at = 0;
+
+  while (at <= list.size())
+  {
+    size_t end = list.find( ',', at);
+    if (end == string::npos)
+      end = list.size();
+    string name = list.substr( at, end - at);
+    at = end + 1;
+
+    if (name.empty() || name == "none")
+      continue;
+
+    size_t i = 0;
+    while (i < QUIRK_COUNT && name != QUIRK_NAMES[i].name)
+      ++i;
+    if (i == QUIRK_COUNT)
+      return false;
+    bits |= QUIRK_NAMES[i].bit;
+  }
+
+  quirks = bits;
+  return true;
+}
+
+
+string quirkNames( unsigned int quirks)
+{
+  string names;
+  for (size_t i = 0; i < QUIRK_COUNT; ++i)
+  {
+    if (quirks & QUIRK_NAMES[i].bit)
+      names += (names.empty() ? "" : ",") + string( QUIRK_NAMES[i].name);
+  }
+  return names.empty() ? "none" : names;
+}
+
+
+bool romQuirks( const char *rom, unsigned int &quirks)
+{
+  quirks = 0;
+  string path = string( rom) + ".quirks";
+  FILE *file = fopen( path.c_str(), "r");
+  if (file == NULL)
+    return true;
+
+  char line[256] = "";
+  bool ok = fgets( line, sizeof(line), file) != NULL || feof( file);
+  fclose( file);
+  line[strcspn( line, " \t\r\n")] = 0;
+
+  return ok && parseQuirks( line, quirks);
+}
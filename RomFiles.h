@@ -0,0 +1,34 @@
+/**
+ * @brief  CHIP8 EMULATOR PROJECT
+ * @Author esantiago
+ * @date   October, 2026
+ *
+ * @description: Header file for the ROM path helpers shared by the tools
+ */
+
+#ifndef ROMFILES_H_
+#define ROMFILES_H_
+
+#include <string>
+#include <vector>
+
+
+// Appends 'path' to 'roms', or every regular file inside it (sorted by
+// name) when 'path' is a directory; ROM.state and ROM.quirks files that
+// sit next to the ROMs are left out
+void collectRoms( const char *path, std::vector<std::string> &roms);
+
+// Parses a comma separated list of quirk names into Chip8::QUIRK_* bits:
+// shift-vy, keep-i, no-add-vf, wrap, vf-reset. "none" or an empty list is
+// the reference behaviour; false on an unknown name.
+bool parseQuirks( const char *spec, unsigned int &quirks);
+
+// the names of the bits in 'quirks', "none" when there are none
+std::string quirkNames( unsigned int quirks);
+
+// The quirk set a ROM was written for, read from ROM.quirks next to it
+// (a parseQuirks list on the first line). None without such a file,
+// false when the file cannot be parsed.
+bool romQuirks( const char *rom, unsigned int &quirks);
+
+#endif // ROMFILES_H_
@@ -0,0 +1,104 @@
+/**
+ * @brief  CHIP8 EMULATOR PROJECT
+ * @Author esantiago
+ * @date   October, 2026
+ *
+ * @description: Real-time frame scheduler source file
+ */
+
+#include <thread>
+#include "Scheduler.h"
+
+using namespace std;
+
+
+Scheduler::Scheduler( unsigned int cycles_per_frame)
+  : frame(0), frames_run(0), frames_dropped(0), cycles_per_frame(cycles_per_frame), max_catch_up(4),
+    multiplier(1), turbo_batch(1)
+{
+  reset();
+}
+
+
+void Scheduler::reset()
+{
+  start = Clock::now();
+  frame = 0;
+  turbo_batch = 1;
+  last_batch = start;
+}
+
+
+void Scheduler::setSpeed( unsigned int speed)
+{
+  multiplier = speed;
+  reset();
+}
+
+
+// start of frame n; exact in integer nanoseconds so the rate never drifts
+Scheduler::Clock::time_point Scheduler::deadline( unsigned long long n) const
+{
+  return start + chrono::nanoseconds( n * 1000000000ULL / (FRAME_RATE * multiplier));
+}
+
+
+unsigned int Scheduler::framesDue()
+{
+  Clock::time_point now = Clock::now();
+
+  // turbo: grow or shrink the batch so one takes about a millisecond,
+  // judged by the time since the previous one was handed out
+  if (multiplier == 0)
+  {
+    chrono::nanoseconds took = chrono::duration_cast<chrono::nanoseconds>( now - last_batch);
+    if (took < chrono::microseconds( 500) && turbo_batch < 65536)
+      turbo_batch *= 2;
+    else if (took > chrono::microseconds( 2000) && turbo_batch > 1)
+      turbo_batch /= 2;
+    last_batch = now;
+    frame += turbo_batch;
+    frames_run += turbo_batch;
+    return turbo_batch;
+  }
+
+  if (now < deadline( frame))
+    return 0;
+
+  // frames whose start time has passed
+  unsigned long long elapsed = chrono::duration_cast<chrono::nanoseconds>( now - start).count();
+  unsigned long long due = elapsed * FRAME_RATE * multiplier / 1000000000ULL + 1 - frame;
+
+  unsigned long long limit = (unsigned long long)max_catch_up * multiplier;
+  if (due > limit)
+  {
+    frames_dropped += due - limit;
+    frame += due - limit;
+    due = limit;
+  }
+
+  frame += due;
+  frames_run += due;
+  return (unsigned int)due;
+}
+
+
+chrono::nanoseconds Scheduler::untilNextFrame() const
+{
+  if (multiplier == 0)
+    return chrono::nanoseconds( 0);
+
+  Clock::time_point now = Clock::now();
+  Clock::time_point next = deadline( frame);
+  if (next <= now)
+    return chrono::nanoseconds( 0);
+  return chrono::duration_cast<chrono::nanoseconds>( next - now);
+}
+
+
+void Scheduler::sleepUntilNextFrame() const
+{
+  if (multiplier != 0)
+    this_thread::sleep_until( deadline( frame));
+}
+
@@ -0,0 +1,84 @@
+/**
+ * @brief  CHIP8 EMULATOR PROJECT
+ * @Author esantiago
+ * @date   October, 2026
+ *
+ * @description: Header file for the real-time frame scheduler
+ *
+ * Emulated time advances in 60 Hz frames: each frame is a fixed budget
+ * of instructions followed by one timer tick. The scheduler maps wall
+ * clock time onto frames with no drift (deadlines are computed from the
+ * start time, not accumulated), tells the host how many frames are due,
+ * and sleeps until the next deadline instead of spinning. After a stall
+ * it catches up a few frames and drops the rest rather than fast
+ * forwarding through seconds of game time.
+ *
+ * The speed multiplier runs N emulated frames per wall clock frame, and
+ * turbo (speed 0) runs frames as fast as the host can. Timers still tick
+ * once per emulated frame, so game time stays consistent.
+ */
+
+#ifndef SCHEDULER_H_
+#define SCHEDULER_H_
+
+#include <chrono>
+
+
+class Scheduler{
+
+  public:
+
+    Scheduler( unsigned int cycles_per_frame = 10);
+
+    // CPU budget of one 60 Hz frame (10 per frame = 600 instructions/s)
+    void setCyclesPerFrame( unsigned int cycles) { cycles_per_frame = cycles; }
+    unsigned int cyclesPerFrame() const { return cycles_per_frame; }
+
+    // most frames run back to back after a stall (times the speed), the
+    // rest are dropped
+    void setMaxCatchUp( unsigned int frames) { max_catch_up = frames; }
+
+    // emulated frames per 60 Hz wall clock frame, 1 is real time and 0 is
+    // turbo; restarts the clock
+    void setSpeed( unsigned int multiplier);
+    unsigned int speed() const { return multiplier; }
+
+    // restarts the clock, e.g. after the emulation was paused
+    void reset();
+
+    // number of frames that should be emulated now, never more than
+    // the catch-up limit; marks them as done. In turbo, a batch sized to
+    // take about a millisecond so input and presents keep flowing.
+    unsigned int framesDue();
+
+    // blocks until the next frame is due (returns at once if it is, and
+    // always in turbo)
+    void sleepUntilNextFrame() const;
+
+    // time until the next frame is due, zero when it already is
+    std::chrono::nanoseconds untilNextFrame() const;
+
+    unsigned long long framesRun() const { return frames_run; }
+    unsigned long long framesDropped() const { return frames_dropped; }
+
+    static const unsigned int FRAME_RATE = 60;
+
+  private:
+
+    typedef std::chrono::steady_clock Clock;
+
+    Clock::time_point start;
+    unsigned long long frame; // frames since start that are done or dropped
+    unsigned long long frames_run;
+    unsigned long long frames_dropped;
+    unsigned int cycles_per_frame;
+    unsigned int max_catch_up;
+    unsigned int multiplier;
+    unsigned int turbo_batch;         // frames handed out per framesDue in turbo
+    Clock::time_point last_batch;     // when the previous turbo batch was handed out
+
+    Clock::time_point deadline( unsigned long long n) const;
+
+};
+
+#endif // SCHEDULER_H_
@@ -0,0 +1,133 @@
+/**
+ * @brief  CHIP8 EMULATOR PROJECT
+ * @Author esantiago
+ * @date   October, 2026
+ *
+ * @description: Work-stealing thread pool source file
+ */
+
+#include "ThreadPool.h"
+
+using namespace std;
+
+
+ThreadPool::ThreadPool( size_t threads)
+  : pending(0), queued(0), next_queue(0), stopping(false)
+{
+  if (threads == 0)
+    threads = thread::hardware_concurrency();
+  if (threads == 0)
+    threads = 1;
+
+  for (size_t i = 0; i < threads; ++i)
+    queues.push_back( new WorkQueue);
+
+  for (size_t i = 0; i < threads; ++i)
+    workers.push_back( thread( &ThreadPool::workerLoop, this, i));
+}
+
+
+ThreadPool::~ThreadPool()
+{
+  {
+    lock_guard<mutex> guard(state_lock);
+    stopping = true;
+  }
+  work_cv.notify_all();
+
+  for (size_t i = 0; i < workers.size(); ++i)
+    workers[i].join();
+
+  for (size_t i = 0; i < queues.size(); ++i)
+    delete queues[i];
+}
+
+
+void ThreadPool::submit( const function<void()> &task)
+{
+  size_t target;
+  {
+    lock_guard<mutex> guard(state_lock);
+    ++pending;
+    ++queued;
+    target = next_queue;
+    next_queue = (next_queue + 1) % queues.size();
+  }
+
+  {
+    lock_guard<mutex> guard(queues[target]->lock);
+    queues[target]->tasks.push_back( task);
+  }
+
+  work_cv.notify_one();
+}
+
+
+void ThreadPool::wait()
+{
+  unique_lock<mutex> guard(state_lock);
+  while (pending != 0)
+    idle_cv.wait( guard);
+}
+
+
+// Own queue first (LIFO, keeps the cache warm), then steal the oldest
+// task from the other workers (FIFO, takes the biggest remaining chunk)
+bool ThreadPool::popTask( size_t self, function<void()> &task)
+{
+  {
+    WorkQueue &own = *queues[self];
+    lock_guard<mutex> guard(own.lock);
+    if (!own.tasks.empty())
+    {
+      task = own.tasks.back();
+      own.tasks.pop_back();
+      return true;
+    }
+  }
+
+  for (size_t i = 1; i < queues.size(); ++i)
+  {
+    WorkQueue &victim = *queues[(self + i) % queues.size()];
+    lock_guard<mutex> guard(victim.lock);
+    if (!victim.tasks.empty())
+    {
+      task = victim.tasks.front();
+      victim.tasks.pop_front();
+      return true;
+    }
+  }
+
+  return false;
+}
+
+
+void ThreadPool::workerLoop( size_t self)
+{
+  function<void()> task;
+
+  for (;;)
+  {
+    {
+      unique_lock<mutex> guard(state_lock);
+      while (queued == 0 && !stopping)
+        work_cv.wait( guard);
+      if (queued == 0 && stopping)
+        return;
+      --queued;
+    }
+
+    // a task is reserved for us, keep looking until we grab one
+    while (!popTask( self, task))
+      this_thread::yield();
+
+    task();
+    task = function<void()>();
+
+    {
+      lock_guard<mutex> guard(state_lock);
+      if (--pending == 0)
+        idle_cv.notify_all();
+    }
+  }
+}
@@ -0,0 +1,70 @@
+/**
+ * @brief  CHIP8 EMULATOR PROJECT
+ * @Author esantiago
+ * @date   October, 2026
+ *
+ * @description: Header file for a small work-stealing thread pool
+ *
+ * Every worker owns a task deque. Tasks submitted to the pool are dealt
+ * round-robin onto the worker deques; a worker pops from the back of its
+ * own deque and, once that is empty, steals from the front of the others.
+ * Used by the headless tools to spread Chip8 instances over all cores.
+ */
+
+#ifndef THREADPOOL_H_
+#define THREADPOOL_H_
+
+#include <stddef.h>
+#include <deque>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+
+class ThreadPool{
+
+  public:
+
+    // 0 threads means one per hardware thread
+    explicit ThreadPool( size_t threads = 0);
+    ~ThreadPool();
+
+    // queue a task, may be called from any thread (including a task)
+    void submit( const std::function<void()> &task);
+
+    // block until every submitted task has finished
+    void wait();
+
+    size_t size() const { return workers.size(); }
+
+  private:
+
+    struct WorkQueue
+    {
+      std::mutex lock;
+      std::deque< std::function<void()> > tasks;
+    };
+
+    std::vector<std::thread> workers;
+    std::vector<WorkQueue *> queues;
+
+    // pending counts queued + running tasks, guarded by state_lock
+    std::mutex state_lock;
+    std::condition_variable work_cv;
+    std::condition_variable idle_cv;
+    size_t pending;
+    size_t queued;
+    size_t next_queue;
+    bool stopping;
+
+    bool popTask( size_t self, std::function<void()> &task);
+    void workerLoop( size_t self);
+
+    ThreadPool( const ThreadPool &);
+    ThreadPool &operator=( const ThreadPool &);
+
+};
+
+#endif // THREADPOOL_H_
@@ -0,0 +1,430 @@
+/**
+ * @brief  CHIP8 EMULATOR PROJECT
+ * @Author esantiago
+ * @date   October, 2026
+ *
+ * @description: Execution trace recorder and reader source file
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <zlib.h>
+#include "Trace.h"
+
+using namespace std;
+
+
+static const unsigned char TRACE_MAGIC[4] = { 'C', '8', 'T', 'R' };
+static const unsigned short TRACE_VERSION = 1;
+
+static const unsigned char RECORD_PC        = 0x01;
+static const unsigned char RECORD_REGISTERS = 0x02;
+static const unsigned char RECORD_WRITE     = 0x04;
+static const unsigned char RECORD_COLLISION = 0x08;
+static const unsigned char RECORD_FRAME     = 0x80;
+
+
+static inline size_t putValue( unsigned char *out, unsigned int value, size_t bytes)
+{
+  for (size_t b = 0; b < bytes; ++b)
+    out[b] = (unsigned char)(value >> (b * 8));
+  return bytes;
+}
+
+
+TraceRecorder::TraceRecorder()
+  : chip8(NULL), file(NULL), next_pc(0), record_count(0), raw_bytes(0), finished(false), failed(false)
+{
+  memset( &shadow, 0, sizeof(shadow));
+}
+
+
+TraceRecorder::~TraceRecorder()
+{
+  close();
+}
+
+
+void TraceRecorder::capture( TraceState &state) const
+{
+  for (size_t i = 0; i < 16; ++i)
+    state.regs[i] = chip8->V[i];
+  state.regs[TraceState::REG_I] = chip8->I;
+  state.regs[TraceState::REG_SP] = chip8->sp;
+  state.regs[TraceState::REG_DT] = chip8->delay_timer;
+  state.regs[TraceState::REG_ST] = chip8->sound_timer;
+
+  unsigned int keys = 0;
+  for (size_t k = 0; k < 16; ++k)
+    keys |= (chip8->key[k] != 0) << k;
+  state.regs[TraceState::REG_KEYS] = keys;
+}
+
+
+bool TraceRecorder::open( const char *path, Chip8 &machine)
+{
+  close();
+  if (machine.cycle_hook != NULL)
+  {
+    printf( "Cannot trace while a debugger is attached\n");
+    return false;
+  }
+
+  // fastest deflate level, the writer has to keep up with the core
+  gzFile gz = gzopen( path, "wb1");
+  if (gz == NULL)
+  {
+    printf( "Cannot write trace %s\n", path);
+    return false;
+  }
+
+  file = gz;
+  chip8 = &machine;
+  record_count = 0;
+  raw_bytes = 0;
+  finished = false;
+  failed = false;
+  chunk.clear();
+  chunk.reserve( CHUNK_SIZE);
+  writer = thread( &TraceRecorder::write, this);
+
+  // header: where it starts from
+  unsigned char header[8 + 2 * TraceState::REGISTERS];
+  size_t size = 0;
+  memcpy( header, TRACE_MAGIC, 4);
+  size += 4;
+  size += putValue( header + size, TRACE_VERSION, 2);
+  next_pc = chip8->pc;
+  size += putValue( header + size, next_pc, 2);
+  capture( shadow);
+  for (unsigned int r = 0; r < TraceState::REGISTERS; ++r)
+    size += putValue( header + size, shadow.regs[r], TraceState::size( r));
+  put( header, size);
+
+  chip8->cycle_hook = this;
+  return true;
+
+}
+
+
+bool TraceRecorder::close()
+{
+  if (chip8 == NULL)
+    return !failed;
+
+  if (chip8->cycle_hook == this)
+    chip8->cycle_hook = NULL;
+  chip8 = NULL;
+
+  flush();
+  {
+    lock_guard<mutex> guard( lock);
+    finished = true;
+  }
+  changed.notify_all();
+  writer.join();
+
+  if (gzclose( static_cast<gzFile>( file)) != Z_OK)
+    failed = true;
+  file = NULL;
+  return !failed;
+
+}
+
+
+void TraceRecorder::put( const unsigned char *bytes, size_t size)
+{
+  if (chunk.size() + size > CHUNK_SIZE)
+    flush();
+  chunk.insert( chunk.end(), bytes, bytes + size);
+  raw_bytes += size;
+}
+
+
+// hands the chunk to the writer, waiting while it is QUEUED_CHUNKS behind
+void TraceRecorder::flush()
+{
+  if (chunk.empty())
+    return;
+
+  vector<unsigned char> full;
+  full.reserve( CHUNK_SIZE);
+  full.swap( chunk);
+
+  unique_lock<mutex> guard( lock);
+  while (queue.size() >= QUEUED_CHUNKS)
+    changed.wait( guard);
+  queue.push_back( vector<unsigned char>());
+  queue.back().swap( full);
+  guard.unlock();
+  changed.notify_all();
+
+}
+
+
+// background thread: compresses and writes chunks in order
+void TraceRecorder::write()
+{
+  unique_lock<mutex> guard( lock);
+  for (;;)
+  {
+    while (queue.empty() && !finished)
+      changed.wait( guard);
+    if (queue.empty())
+      return;
+
+    vector<unsigned char> data;
+    data.swap( queue.front());
+    guard.unlock();
+
+    if (!failed && gzwrite( static_cast<gzFile>( file), &data[0], data.size()) != (int)data.size())
+      failed = true;
+
+    guard.lock();
+    queue.pop_front();
+    changed.notify_all();
+  }
+
+}
+
+
+void TraceRecorder::run( unsigned long long cycles)
+{
+  unsigned char marker = RECORD_FRAME;
+  put( &marker, 1);
+
+  TraceState now;
+  unsigned char record[64];
+
+  for (unsigned long long i = 0; i < cycles; ++i)
+  {
+    unsigned short pc = chip8->pc;
+    unsigned short opcode = chip8->memory[pc & 0xFFF] << 8 | chip8->memory[(pc + 1) & 0xFFF];
+
+    // stores go to I onwards, read them back once the instruction ran
+    unsigned short write_address = chip8->I & 0xFFF;
+    unsigned int write_count = 0;
+    if ((opcode & 0xF0FF) == 0xF033)
+      write_count = 3;
+    else if ((opcode & 0xF0FF) == 0xF055)
+      write_count = ((opcode >> 8) & 0xF) + 1;
+
+    chip8->emulateCycle();
+    capture( now);
+
+    uint32_t mask = 0;
+    for (unsigned int r = 0; r < TraceState::REGISTERS; ++r)
+    {
+      if (now.regs[r] != shadow.regs[r])
+        mask |= 1u << r;
+    }
+
+    unsigned char flags = 0;
+    if (pc != next_pc)
+      flags |= RECORD_PC;
+    if (mask != 0)
+      flags |= RECORD_REGISTERS;
+    if (write_count != 0)
+      flags |= RECORD_WRITE;
+    if ((opcode & 0xF000) == 0xD000 && chip8->V[0xF] != 0)
+      flags |= RECORD_COLLISION;
+
+    size_t size = 0;
+    record[size++] = flags;
+    size += putValue( record + size, opcode, 2);
+    if (flags & RECORD_PC)
+      size += putValue( record + size, pc, 2);
+    if (flags & RECORD_REGISTERS)
+    {
+      for (uint32_t m = mask; ; m >>= 7)
+      {
+        record[size++] = (m & 0x7F) | (m > 0x7F ? 0x80 : 0);
+        if (m <= 0x7F)
+          break;
+      }
+      for (unsigned int r = 0; r < TraceState::REGISTERS; ++r)
+      {
+        if (mask & (1u << r))
+          size += putValue( record + size, now.regs[r], TraceState::size( r));
+      }
+    }
+    if (flags & RECORD_WRITE)
+    {
+      size += putValue( record + size, write_address, 2);
+      record[size++] = write_count;
+      for (unsigned int b = 0; b < write_count; ++b)
+        record[size++] = chip8->memory[(write_address + b) & 0xFFF];
+    }
+
+    put( record, size);
+    shadow = now;
+    next_pc = pc + 2;
+    ++record_count;
+  }
+
+}
+
+
+TraceReader::TraceReader()
+  : file(NULL), next_pc(0), frame(0), index(0), error_text(NULL)
+{
+  memset( &current, 0, sizeof(current));
+}
+
+
+TraceReader::~TraceReader()
+{
+  close();
+}
+
+
+void TraceReader::close()
+{
+  if (file != NULL)
+    gzclose( static_cast<gzFile>( file));
+  file = NULL;
+}
+
+
+bool TraceReader::read( void *bytes, size_t size)
+{
+  return gzread( static_cast<gzFile>( file), bytes, size) == (int)size;
+}
+
+
+bool TraceReader::readVarint( uint32_t &value)
+{
+  value = 0;
+  for (unsigned int shift = 0; shift < 32; shift += 7)
+  {
+    unsigned char byte;
+    if (!read( &byte, 1))
+      return false;
+    value |= (uint32_t)(byte & 0x7F) << shift;
+    if ((byte & 0x80) == 0)
+      return true;
+  }
+  return false;
+}
+
+
+bool TraceReader::readValue( unsigned int &value, size_t bytes)
+{
+  unsigned char buffer[4];
+  if (!read( buffer, bytes))
+    return false;
+  value = 0;
+  for (size_t b = 0; b < bytes; ++b)
+    value |= (unsigned int)buffer[b] << (b * 8);
+  return true;
+}
+
+
+bool TraceReader::open( const char *path)
+{
+  close();
+  error_text = NULL;
+  frame = 0;
+  index = 0;
+
+  file = gzopen( path, "rb");
+  if (file == NULL)
+  {
+    error_text = "cannot open";
+    return false;
+  }
+
+  unsigned char magic[4];
+  unsigned int version, pc;
+  if (!read( magic, 4) || memcmp( magic, TRACE_MAGIC, 4) != 0 ||
+      !readValue( version, 2) || version != TRACE_VERSION)
+  {
+    error_text = "not a trace";
+    close();
+    return false;
+  }
+
+  bool ok = readValue( pc, 2);
+  for (unsigned int r = 0; r < TraceState::REGISTERS && ok; ++r)
+    ok = readValue( current.regs[r], TraceState::size( r));
+  if (!ok)
+  {
+    error_text = "truncated header";
+    close();
+    return false;
+  }
+  next_pc = pc;
+
+  return true;
+
+}
+
+
+bool TraceReader::next( TraceRecord &record)
+{
+  if (file == NULL)
+    return false;
+
+  unsigned char flags;
+  for (;;)
+  {
+    // a clean end of stream is only allowed between records, and only
+    // where the gzip stream itself ends
+    if (!read( &flags, 1))
+    {
+      int status;
+      gzerror( static_cast<gzFile>( file), &status);
+      if (status != Z_OK)
+        error_text = "truncated stream";
+      return false;
+    }
+    if (flags != RECORD_FRAME)
+      break;
+    ++frame;
+  }
+
+  unsigned int value = 0;
+  bool ok = readValue( value, 2);
+  record.opcode = value;
+  record.pc = next_pc;
+  if (ok && (flags & RECORD_PC))
+  {
+    ok = readValue( value, 2);
+    record.pc = value;
+  }
+
+  record.changed = 0;
+  if (ok && (flags & RECORD_REGISTERS))
+  {
+    ok = readVarint( record.changed);
+    for (unsigned int r = 0; r < TraceState::REGISTERS && ok; ++r)
+    {
+      if (record.changed & (1u << r))
+        ok = readValue( current.regs[r], TraceState::size( r));
+    }
+  }
+
+  record.write_count = 0;
+  if (ok && (flags & RECORD_WRITE))
+  {
+    unsigned char count = 0;
+    ok = readValue( value, 2) && read( &count, 1) && count <= 16 &&
+         read( record.written, count);
+    record.write_address = value;
+    record.write_count = count;
+  }
+
+  if (!ok)
+  {
+    error_text = "truncated record";
+    return false;
+  }
+
+  record.collision = (flags & RECORD_COLLISION) != 0;
+  record.after = current;
+  record.frame = frame;
+  record.index = index++;
+  next_pc = record.pc + 2;
+  return true;
+
+}
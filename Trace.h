@@ -0,0 +1,168 @@
+/**
+ * @brief  CHIP8 EMULATOR PROJECT
+ * @Author esantiago
+ * @date   October, 2026
+ *
+ * @description: Header file for the execution trace recorder and reader
+ *
+ * A trace holds every instruction the core executed, delta encoded
+ * against the machine state after the one before, so a typical record
+ * is the opcode plus one or two changed registers: a handful of bytes
+ * before compression, about one after.
+ *
+ * The recorder attaches to the core the way the debugger does (see
+ * Chip8::CycleHook), so the core runs its normal paths while no trace is
+ * being recorded. Records go into fixed-size chunks that a background
+ * thread deflates into a gzip file. At most QUEUED_CHUNKS wait for it
+ * and the core blocks when they are all taken, so memory stays bounded
+ * however long the session.
+ *
+ * Stream (after gunzip): "C8TR", u16 version, u16 pc, the full register
+ * state (see TraceState), then records. A record starts with a flags byte:
+ *   0x80 alone       a new runCycles call (usually a frame) starts
+ *   0x01 PC          u16 pc, when it is not the previous record's pc + 2
+ *   0x02 REGISTERS   LEB128 mask of TraceState registers, then their values
+ *   0x04 WRITE       u16 address, u8 count, the bytes stored
+ *   0x08 COLLISION   Dxyn erased a pixel
+ * followed by the u16 opcode, then the fields flagged, in that order.
+ * Multi-byte values are little endian. Changes made between two
+ * instructions (timer ticks, keys) show up in the next record.
+ */
+
+#ifndef TRACE_H_
+#define TRACE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "Chip8.h"
+
+
+// registers a trace follows, in mask bit order
+struct TraceState
+{
+  enum
+  {
+    REG_I = 16,   // 0-15 are V0-VF
+    REG_SP,
+    REG_DT,
+    REG_ST,
+    REG_KEYS,     // bit k = key k down
+    REGISTERS
+  };
+
+  unsigned int regs[REGISTERS];
+
+  // bytes a register takes in the stream
+  static size_t size( unsigned int reg) { return reg == REG_I || reg == REG_KEYS ? 2 : 1; }
+};
+
+
+struct TraceRecord
+{
+  unsigned long long frame; // the runCycles call it ran in, counting from 1
+  unsigned long long index; // instructions before this one
+  unsigned short pc;
+  unsigned short opcode;
+  uint32_t changed;         // TraceState registers this record set, bit n = register n
+  TraceState after;         // registers after the instruction
+  unsigned short write_address;
+  unsigned int write_count;
+  unsigned char written[16];
+  bool collision;
+};
+
+
+class TraceRecorder : public Chip8::CycleHook{
+
+  public:
+
+    TraceRecorder();
+    ~TraceRecorder();
+
+    // starts tracing 'chip8' into a gzip file; prints why and returns
+    // false when the file cannot be written or a debugger holds the core
+    bool open( const char *path, Chip8 &chip8);
+
+    // detaches and writes everything out, false if a write failed
+    bool close();
+    bool isOpen() const { return chip8 != NULL; }
+
+    unsigned long long records() const { return record_count; }
+    unsigned long long rawBytes() const { return raw_bytes; }
+
+    // from Chip8::runCycles while open
+    virtual void run( unsigned long long cycles);
+
+    static const size_t CHUNK_SIZE = 64 << 10;
+    static const size_t QUEUED_CHUNKS = 4;
+
+  private:
+
+    Chip8 *chip8;
+    void *file;               // gzFile
+    TraceState shadow;        // registers after the last record
+    unsigned short next_pc;   // the last record's pc + 2
+    std::vector<unsigned char> chunk;
+    unsigned long long record_count;
+    unsigned long long raw_bytes;
+
+    std::thread writer;
+    std::mutex lock;
+    std::condition_variable changed;
+    std::deque< std::vector<unsigned char> > queue;
+    bool finished;
+    bool failed;
+
+    void capture( TraceState &state) const;
+    void put( const unsigned char *bytes, size_t size);
+    void flush();
+    void write();
+
+    TraceRecorder( const TraceRecorder &);
+    TraceRecorder &operator=( const TraceRecorder &);
+
+};
+
+
+class TraceReader{
+
+  public:
+
+    TraceReader();
+    ~TraceReader();
+
+    // false with 'error' set when the file is not a trace
+    bool open( const char *path);
+    void close();
+    const char *error() const { return error_text; }
+
+    // the next instruction; false at the end, or with error() set when
+    // the trace is cut short
+    bool next( TraceRecord &record);
+
+    const TraceState &state() const { return current; }
+
+  private:
+
+    void *file; // gzFile
+    TraceState current;
+    unsigned short next_pc;
+    unsigned long long frame;
+    unsigned long long index;
+    const char *error_text;
+
+    bool read( void *bytes, size_t size);
+    bool readValue( unsigned int &value, size_t bytes);
+    bool readVarint( uint32_t &value);
+
+    TraceReader( const TraceReader &);
+    TraceReader &operator=( const TraceReader &);
+
+};
+
+#endif // TRACE_H_
@@ -0,0 +1,107 @@
+/**
+ * @brief  CHIP8 EMULATOR PROJECT
+ * @Author esantiago
+ * @date   October, 2026
+ *
+ * @description: Ahead-of-time ROM compiler driver
+ *
+ * Translates one ROM into a C++ unit (see AotCompiler.h). Linking the
+ * unit into any of the tools, or the emulator itself, lets EXEC_AOT run
+ * that ROM as native code; 'make batch_aot' and 'make lockstep_aot' do
+ * this for every ROM in AOT_ROMS.
+ *
+ * usage: aot_Chip8 [-l max-block-length] [-n name] [-o unit.cpp] ROM
+ */
+
+#include <cstddef>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "AotCompiler.h"
+
+using namespace std;
+
+
+static void usage( const char *prog)
+{
+  printf( "usage: %s [-l max-block-length] [-n name] [-o unit.cpp] ROM\n", prog);
+}
+
+
+int main( int argc, char *argv[] )
+{
+  size_t max_length = 8;
+  const char *name = NULL;
+  const char *out_path = NULL;
+  const char *rom = NULL;
+
+  for (int i = 1; i < argc; ++i)
+  {
+    if (strcmp( argv[i], "-l") == 0 && i + 1 < argc)
+      max_length = strtoul( argv[++i], NULL, 10);
+    else if (strcmp( argv[i], "-n") == 0 && i + 1 < argc)
+      name = argv[++i];
+    else if (strcmp( argv[i], "-o") == 0 && i + 1 < argc)
+      out_path = argv[++i];
+    else if (argv[i][0] == '-' || rom != NULL)
+    {
+      usage( argv[0]);
+      return 1;
+    }
+    else
+      rom = argv[i];
+  }
+
+  if (rom == NULL)
+  {
+    usage( argv[0]);
+    return 1;
+  }
+
+  if (name == NULL)
+  {
+    name = strrchr( rom, '/');
+    name = name != NULL ? name + 1 : rom;
+  }
+
+  // same limit as Chip8::loadProgram
+  vector<unsigned char> program( 4096 - 512 + 1);
+  FILE *file = fopen( rom, "rb");
+  if (file == NULL)
+  {
+    printf( "Unable to read %s\n", rom);
+    return 1;
+  }
+  program.resize( fread( &program[0], 1, program.size(), file));
+  fclose( file);
+  if (program.empty() || program.size() > 4096 - 512)
+  {
+    printf( "%s is not a CHIP-8 program\n", rom);
+    return 1;
+  }
+
+  AotCompiler compiler;
+  compiler.setMaxBlockLength( max_length);
+  const string &unit = compiler.compile( name, &program[0], program.size());
+
+  FILE *out = out_path != NULL ? fopen( out_path, "w") : stdout;
+  if (out == NULL)
+  {
+    printf( "Unable to open %s\n", out_path);
+    return 1;
+  }
+  bool written = fwrite( unit.data(), 1, unit.size(), out) == unit.size();
+  if (out != stdout)
+    written = fclose( out) == 0 && written;
+  if (!written)
+  {
+    fprintf( stderr, "Unable to write the unit for %s\n", rom);
+    return 1;
+  }
+
+  fprintf( stderr, "%-24s %4zu blocks, %5zu instructions\n", rom, compiler.blocks(), compiler.instructions());
+  return 0;
+
+}
@@ -0,0 +1,206 @@
+/**
+ * @brief  CHIP8 EMULATOR PROJECT
+ * @Author esantiago
+ * @date   October, 2026
+ *
+ * @description: Headless batch runner for the chip8 project
+ *
+ * Runs many ROMs (or many copies of one ROM) without SDL, one Chip8
+ * instance per task, spread over a work-stealing thread pool. Reports
+ * per-instance results and the aggregate instructions per second. Only
+ * instructions actually executed count towards IPS; idle loop passes the
+ * core skipped (unless -I turns that off) are reported on their own.
+ * Every ROM runs with the
+ * quirks of its ROM.quirks file, or the -q list for all of them.
+ *
+ * usage: batch_Chip8 [-j threads] [-n copies] [-c cycles] [-f cycles-per-frame]
+ *                    [-m switch|table|block|jit|aot] [-I] [-q quirks] ROM|DIR ...
+ */
+
+#include <cstddef>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <chrono>
+#include "Chip8.h"
+#include "RomFiles.h"
+#include "ThreadPool.h"
+
+using namespace std;
+
+
+struct BatchResult
+{
+  string rom;
+  unsigned int quirks;
+  bool loaded;
+  unsigned long long cycles;
+  unsigned long long idle; // of them skipped as idle loop passes
+  double seconds;
+};
+
+
+static void usage( const char *prog)
+{
+  printf( "usage: %s [-j threads] [-n copies] [-c cycles] [-f cycles-per-frame]\n"
+          "       [-m switch|table|block|jit|aot] [-I] [-q quirks] ROM|DIR ...\n", prog);
+}
+
+
+static void runInstance( BatchResult &result, unsigned long long cycles, unsigned int per_frame,
+                         Chip8::ExecMode mode, bool idle_skip, uint32_t seed)
+{
+  Chip8 chip8_emu;
+
+  chip8_emu.initialize();
+  chip8_emu.setExecMode( mode);
+  chip8_emu.setIdleSkip( idle_skip);
+  chip8_emu.setQuirks( result.quirks);
+  chip8_emu.seedRandom( seed);
+  result.loaded = chip8_emu.loadGame( result.rom.c_str());
+  result.cycles = 0;
+  result.idle = 0;
+  result.seconds = 0;
+
+  if (!result.loaded)
+    return;
+
+  chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+  // 60 Hz frames as fast as possible: the CPU budget, then a timer tick
+  for (unsigned long long done = 0; done < cycles; done += per_frame)
+    chip8_emu.runFrame( cycles - done < per_frame ? cycles - done : per_frame);
+
+  chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+  result.cycles = cycles;
+  result.idle = chip8_emu.idleCycles();
+  result.seconds = elapsed.count();
+}
+
+
+int main( int argc, char *argv[] )
+{
+  size_t threads = 0;
+  size_t copies = 1;
+  unsigned long long cycles = 1000000;
+  unsigned int per_frame = 10;
+  Chip8::ExecMode mode = Chip8::EXEC_SWITCH;
+  bool idle_skip = true;
+  const char *quirk_list = NULL;
+  vector<string> roms;
+
+  for (int i = 1; i < argc; ++i)
+  {
+    if (strcmp( argv[i], "-j") == 0 && i + 1 < argc)
+      threads = strtoul( argv[++i], NULL, 10);
+    else if (strcmp( argv[i], "-n") == 0 && i + 1 < argc)
+      copies = strtoul( argv[++i], NULL, 10);
+    else if (strcmp( argv[i], "-c") == 0 && i + 1 < argc)
+      cycles = strtoull( argv[++i], NULL, 10);
+    else if (strcmp( argv[i], "-f") == 0 && i + 1 < argc)
+      per_frame = strtoul( argv[++i], NULL, 10);
+    else if (strcmp( argv[i], "-m") == 0 && i + 1 < argc)
+    {
+      ++i;
+      if (strcmp( argv[i], "switch") == 0)
+        mode = Chip8::EXEC_SWITCH;
+      else if (strcmp( argv[i], "table") == 0)
+        mode = Chip8::EXEC_TABLE;
+      else if (strcmp( argv[i], "block") == 0)
+        mode = Chip8::EXEC_BLOCK;
+      else if (strcmp( argv[i], "jit") == 0)
+        mode = Chip8::EXEC_JIT;
+      else if (strcmp( argv[i], "aot") == 0)
+        mode = Chip8::EXEC_AOT;
+      else
+      {
+        usage( argv[0]);
+        return 1;
+      }
+    }
+    else if (strcmp( argv[i], "-I") == 0)
+      idle_skip = false;
+    else if (strcmp( argv[i], "-q") == 0 && i + 1 < argc)
+      quirk_list = argv[++i];
+    else if (argv[i][0] == '-')
+    {
+      usage( argv[0]);
+      return 1;
+    }
+    else
+      collectRoms( argv[i], roms);
+  }
+
+  if (roms.empty() || copies == 0 || per_frame == 0)
+  {
+    usage( argv[0]);
+    return 1;
+  }
+
+  vector<unsigned int> quirks( roms.size());
+  for (size_t i = 0; i < roms.size(); ++i)
+  {
+    if (quirk_list != NULL ? !parseQuirks( quirk_list, quirks[i]) : !romQuirks( roms[i].c_str(), quirks[i]))
+    {
+      printf( "Unknown quirk in %s\n", quirk_list != NULL ? quirk_list : (roms[i] + ".quirks").c_str());
+      return 1;
+    }
+  }
+
+  vector<BatchResult> results( roms.size() * copies);
+  for (size_t i = 0; i < results.size(); ++i)
+  {
+    results[i].rom = roms[i / copies];
+    results[i].quirks = quirks[i / copies];
+  }
+
+  chrono::steady_clock::time_point start = chrono::steady_clock::now();
+  size_t workers;
+  {
+    ThreadPool pool( threads);
+    workers = pool.size();
+
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+      BatchResult *slot = &results[i];
+      uint32_t seed = i + 1; // reproducible runs, different per copy
+      pool.submit( [slot, cycles, per_frame, mode, idle_skip, seed]()
+                   { runInstance( *slot, cycles, per_frame, mode, idle_skip, seed); });
+    }
+
+    pool.wait();
+  }
+  chrono::duration<double> wall = chrono::steady_clock::now() - start;
+
+  unsigned long long total = 0;
+  unsigned long long skipped = 0;
+  size_t failed = 0;
+  for (size_t i = 0; i < results.size(); ++i)
+  {
+    const BatchResult &r = results[i];
+    if (!r.loaded)
+    {
+      printf( "%-24s FAILED TO LOAD\n", r.rom.c_str());
+      ++failed;
+      continue;
+    }
+    // skipped idle passes cost nothing, counting them would inflate IPS
+    unsigned long long executed = r.cycles - r.idle;
+    if (copies == 1)
+      printf( "%-24s %12llu executed %8.3f s %12.0f IPS %12llu skipped (%4.1f%%)\n", r.rom.c_str(),
+              executed, r.seconds, r.seconds > 0 ? executed / r.seconds : 0.0, r.idle,
+              r.cycles > 0 ? 100.0 * r.idle / r.cycles : 0.0);
+    total += executed;
+    skipped += r.idle;
+  }
+
+  printf( "\n%zu instances on %zu threads, %zu failed\n", results.size(), workers, failed);
+  printf( "%llu instructions executed in %.3f s: %.0f aggregate IPS\n", total, wall.count(),
+          wall.count() > 0 ? total / wall.count() : 0.0);
+  printf( "%llu idle loop passes skipped\n", skipped);
+
+  return failed == 0 ? 0 : 1;
+
+}
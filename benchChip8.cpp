@@ -0,0 +1,493 @@
+/**
+ * @brief  CHIP8 EMULATOR PROJECT
+ * @Author esantiago
+ * @date   October, 2026
+ *
+ * @description: Benchmark suite for the chip8 core
+ *
+ * Three suites, every one timed as warmup runs followed by repetitions
+ * that are reported as mean, standard deviation and best:
+ *
+ *   rom  every ROM runs headless for a fixed number of frames with
+ *        scripted key presses and a fixed seed (instructions/s)
+ *   op   synthetic loops of a single instruction class, Dxyn included,
+ *        to see what each class costs in each execution mode (ns/instr)
+ *   gfx  the 1-bit to ARGB expansion drawGfx uses (frames/s, ns/frame)
+ *
+ * Idle loop skipping is off: every cycle counted is an instruction that
+ * ran, so the numbers compare with runs from before the core had it.
+ *
+ * Repetitions restart from a snapshot taken after loading, so caches and
+ * translations built during the warmup are kept and the numbers are the
+ * steady state. -F json / -F csv print machine-readable results, -l tags
+ * them (e.g. with a commit id) so two runs can be compared.
+ *
+ * usage: bench_Chip8 [-s rom,op,gfx] [-m switch,table,block,jit,aot] [-f frames]
+ *                    [-i cycles-per-frame] [-n op-cycles] [-r reps] [-w warmup]
+ *                    [-F text|json|csv] [-l label] [ROM|DIR ...]
+ */
+
+#include <cstddef>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <functional>
+#include "Chip8.h"
+#include "GfxConvert.h"
+#include "RomFiles.h"
+
+using namespace std;
+
+
+struct BenchResult
+{
+  string suite;
+  string name;
+  string mode;
+  const char *unit;     // what one item is
+  double items;         // per repetition
+  vector<double> seconds; // one per repetition
+};
+
+
+struct BenchOptions
+{
+  unsigned int frames;
+  unsigned int cycles_per_frame;
+  unsigned long long op_cycles;
+  unsigned int reps;
+  unsigned int warmup;
+};
+
+
+// an instruction class microbenchmark: 'prelude' runs once, then 'body'
+// is repeated and looped over with a jump back to its first instruction
+struct OpBench
+{
+  const char *name;
+  unsigned short prelude[4];
+  unsigned short body;
+};
+
+static const OpBench OP_BENCHES[] =
+{
+  { "00E0 cls",      { 0 },                      0x00E0 },
+  { "1nnn jp",       { 0 },                      0x1000 }, // chain, see buildProgram
+  { "2nnn/00EE call",{ 0 },                      0x2000 }, // call + return pairs
+  { "3xkk se",       { 0 },                      0x3AFF }, // never skips
+  { "6xkk ld",       { 0 },                      0x6A55 },
+  { "7xkk add",      { 0 },                      0x7A01 },
+  { "8xy4 add",      { 0x6B03, 0 },              0x8AB4 },
+  { "Annn ld i",     { 0 },                      0xA300 },
+  { "Cxkk rnd",      { 0 },                      0xCAFF },
+  { "Dxyn draw",     { 0x6A10, 0x6B08, 0xA050, 0 }, 0xDAB5 },
+  { "Dxyn draw edge",{ 0x6A3C, 0x6B1D, 0xA050, 0 }, 0xDAB5 }, // wraps and clips
+  { "Ex9E skp",      { 0 },                      0xEA9E },
+  { "Fx1E add i",    { 0 },                      0xFA1E },
+  { "Fx33 bcd",      { 0xA800, 0 },              0xFA33 },
+  { "Fx55 store",    { 0xA800, 0 },              0xFF55 },
+  { "Fx65 load",     { 0xA800, 0 },              0xFF65 },
+};
+
+static const size_t OP_BODY_LENGTH = 64;
+static const unsigned short OP_SUBROUTINE = 0x600;
+
+
+static void usage( const char *prog)
+{
+  printf( "usage: %s [-s rom,op,gfx] [-m switch,table,block,jit,aot] [-f frames]\n"
+          "       [-i cycles-per-frame] [-n op-cycles] [-r reps] [-w warmup]\n"
+          "       [-F text|json|csv] [-l label] [ROM|DIR ...]\n", prog);
+}
+
+
+static const char *modeName( Chip8::ExecMode mode)
+{
+  switch(mode)
+  {
+    case Chip8::EXEC_SWITCH: return "switch";
+    case Chip8::EXEC_TABLE:  return "table";
+    case Chip8::EXEC_BLOCK:  return "block";
+    case Chip8::EXEC_JIT:    return "jit";
+    case Chip8::EXEC_AOT:    return "aot";
+  }
+  return "?";
+}
+
+
+// true when 'name' is in the comma separated 'list'
+static bool listed( const char *list, const char *name)
+{
+  size_t length = strlen( name);
+  for (const char *p = list; *p != '\0'; )
+  {
+    const char *comma = strchr( p, ',');
+    size_t item = comma != NULL ? (size_t)(comma - p) : strlen( p);
+    if (item == length && strncmp( p, name, length) == 0)
+      return true;
+    p += item + (comma != NULL ? 1 : 0);
+  }
+  return false;
+}
+
+
+static double mean( const vector<double> &v)
+{
+  double sum = 0;
+  for (size_t i = 0; i < v.size(); ++i)
+    sum += v[i];
+  return v.empty() ? 0 : sum / v.size();
+}
+
+static double stddev( const vector<double> &v)
+{
+  if (v.size() < 2)
+    return 0;
+  double m = mean( v), sum = 0;
+  for (size_t i = 0; i < v.size(); ++i)
+    sum += (v[i] - m) * (v[i] - m);
+  return sqrt( sum / (v.size() - 1));
+}
+
+static double best( const vector<double> &v)
+{
+  double b = v.empty() ? 0 : v[0];
+  for (size_t i = 1; i < v.size(); ++i)
+    b = v[i] < b ? v[i] : b;
+  return b;
+}
+
+
+// 'run' is one repetition, it returns its own duration so that setup
+// (restoring a snapshot) stays out of the measurement
+static vector<double> measure( const BenchOptions &opt, const function<double()> &run)
+{
+  vector<double> seconds;
+  for (unsigned int i = 0; i < opt.warmup; ++i)
+    run();
+  for (unsigned int i = 0; i < opt.reps; ++i)
+    seconds.push_back( run());
+  return seconds;
+}
+
+
+static double elapsedSince( chrono::steady_clock::time_point start)
+{
+  chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+  return elapsed.count();
+}
+
+
+static void benchRom( const string &rom, Chip8::ExecMode mode, const BenchOptions &opt,
+                      vector<BenchResult> &results)
+{
+  Chip8 *chip8_emu = new Chip8;
+  chip8_emu->initialize();
+  chip8_emu->setExecMode( mode);
+  chip8_emu->setIdleSkip( false);
+  chip8_emu->seedRandom( 1);
+  if (!chip8_emu->loadGame( rom.c_str()))
+  {
+    fprintf( stderr, "%s: failed to load\n", rom.c_str());
+    delete chip8_emu;
+    return;
+  }
+
+  vector<unsigned char> start( Chip8::STATE_SIZE);
+  chip8_emu->saveState( &start[0]);
+
+  vector<double> seconds = measure( opt, [&]() -> double
+  {
+    chip8_emu->loadState( &start[0], start.size());
+    chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+    for (unsigned int frame = 0; frame < opt.frames; ++frame)
+    {
+      // a new key pattern every half second
+      if (frame % 30 == 0)
+      {
+        for (size_t k = 0; k < 16; ++k)
+          chip8_emu->key[k] = ((frame / 30) * 7 + k) % 5 == 0;
+      }
+      chip8_emu->runFrame( opt.cycles_per_frame);
+    }
+    return elapsedSince( t0);
+  });
+
+  BenchResult r;
+  r.suite = "rom";
+  size_t slash = rom.find_last_of( '/');
+  r.name = slash == string::npos ? rom : rom.substr( slash + 1);
+  r.mode = modeName( mode);
+  r.unit = "instr";
+  r.items = (double)opt.frames * opt.cycles_per_frame;
+  r.seconds = seconds;
+  results.push_back( r);
+
+  delete chip8_emu;
+}
+
+
+static vector<unsigned char> buildProgram( const OpBench &bench)
+{
+  vector<unsigned short> ops;
+  for (size_t i = 0; i < 4 && bench.prelude[i] != 0; ++i)
+    ops.push_back( bench.prelude[i]);
+
+  unsigned short loop = 0x200 + ops.size() * 2;
+  for (size_t i = 0; i < OP_BODY_LENGTH; ++i)
+  {
+    unsigned short at = 0x200 + ops.size() * 2;
+    if (bench.body == 0x1000)
+      ops.push_back( 0x1000 | (i + 1 < OP_BODY_LENGTH ? at + 2 : loop));
+    else if (bench.body == 0x2000)
+      ops.push_back( 0x2000 | OP_SUBROUTINE);
+    else
+      ops.push_back( bench.body);
+  }
+  if (bench.body != 0x1000)
+    ops.push_back( 0x1000 | loop);
+
+  if (bench.body == 0x2000)
+  {
+    while (0x200 + ops.size() * 2 < OP_SUBROUTINE)
+      ops.push_back( 0x0000);
+    ops.push_back( 0x00EE);
+  }
+
+  vector<unsigned char> program;
+  for (size_t i = 0; i < ops.size(); ++i)
+  {
+    program.push_back( ops[i] >> 8);
+    program.push_back( ops[i] & 0xFF);
+  }
+  return program;
+}
+
+
+static void benchOp( const OpBench &bench, Chip8::ExecMode mode, const BenchOptions &opt,
+                     vector<BenchResult> &results)
+{
+  vector<unsigned char> program = buildProgram( bench);
+  Chip8 *chip8_emu = new Chip8;
+  chip8_emu->initialize();
+  chip8_emu->setExecMode( mode);
+  chip8_emu->setIdleSkip( false);
+  chip8_emu->seedRandom( 1);
+  chip8_emu->loadProgram( &program[0], program.size());
+
+  vector<unsigned char> start( Chip8::STATE_SIZE);
+  chip8_emu->saveState( &start[0]);
+
+  vector<double> seconds = measure( opt, [&]() -> double
+  {
+    chip8_emu->loadState( &start[0], start.size());
+    chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+    chip8_emu->runCycles( opt.op_cycles);
+    return elapsedSince( t0);
+  });
+
+  BenchResult r;
+  r.suite = "op";
+  r.name = bench.name;
+  r.mode = modeName( mode);
+  r.unit = "instr";
+  r.items = (double)opt.op_cycles;
+  r.seconds = seconds;
+  results.push_back( r);
+
+  delete chip8_emu;
+}
+
+
+static void benchGfx( const BenchOptions &opt, vector<BenchResult> &results)
+{
+  static uint32_t pixels[64 * 32];
+  uint64_t rows[32];
+  for (size_t i = 0; i < 32; ++i)
+    rows[i] = 0x9E3779B97F4A7C15ULL * (i + 1);
+
+  const unsigned int frames = 10000;
+  volatile uint32_t sink = 0;
+
+  BenchResult full;
+  full.suite = "gfx";
+  full.name = "expandRows 32 rows";
+  full.mode = "-";
+  full.unit = "frame";
+  full.items = frames;
+  full.seconds = measure( opt, [&]() -> double
+  {
+    chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+    for (unsigned int f = 0; f < frames; ++f)
+    {
+      rows[f & 31] ^= f; // a different frame every time
+      expandRows( rows, 0, 32, pixels, 0xFFFFFFFF, 0xFF000000);
+      sink += pixels[f & 2047];
+    }
+    return elapsedSince( t0);
+  });
+  results.push_back( full);
+
+  BenchResult row;
+  row.suite = "gfx";
+  row.name = "expandRow 1 row";
+  row.mode = "-";
+  row.unit = "row";
+  row.items = frames * 32.0;
+  row.seconds = measure( opt, [&]() -> double
+  {
+    chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+    for (unsigned int f = 0; f < frames * 32; ++f)
+    {
+      expandRow( rows[f & 31] ^ f, pixels + (f & 31) * 64, 0xFFFFFFFF, 0xFF000000);
+      sink += pixels[f & 2047];
+    }
+    return elapsedSince( t0);
+  });
+  results.push_back( row);
+}
+
+
+static void printText( const vector<BenchResult> &results)
+{
+  printf( "%-5s %-20s %-7s %16s %12s %8s %12s\n", "suite", "name", "mode", "items/s", "ns/item",
+          "stddev", "best ns");
+  for (size_t i = 0; i < results.size(); ++i)
+  {
+    const BenchResult &r = results[i];
+    double m = mean( r.seconds);
+    printf( "%-5s %-20s %-7s %16.0f %12.3f %7.1f%% %12.3f\n", r.suite.c_str(), r.name.c_str(),
+            r.mode.c_str(), m > 0 ? r.items / m : 0.0, m * 1e9 / r.items,
+            m > 0 ? 100.0 * stddev( r.seconds) / m : 0.0, best( r.seconds) * 1e9 / r.items);
+  }
+}
+
+
+static void printCsv( const vector<BenchResult> &results, const char *label)
+{
+  printf( "label,suite,name,mode,unit,items,reps,mean_s,stddev_s,best_s,items_per_s,ns_per_item\n");
+  for (size_t i = 0; i < results.size(); ++i)
+  {
+    const BenchResult &r = results[i];
+    double m = mean( r.seconds);
+    printf( "%s,%s,%s,%s,%s,%.0f,%zu,%.9f,%.9f,%.9f,%.1f,%.4f\n", label, r.suite.c_str(),
+            r.name.c_str(), r.mode.c_str(), r.unit, r.items, r.seconds.size(), m, stddev( r.seconds),
+            best( r.seconds), m > 0 ? r.items / m : 0.0, m * 1e9 / r.items);
+  }
+}
+
+
+static void printJson( const vector<BenchResult> &results, const char *label, const BenchOptions &opt)
+{
+  printf( "{\n  \"label\": \"%s\",\n", label);
+  printf( "  \"frames\": %u,\n  \"cycles_per_frame\": %u,\n  \"op_cycles\": %llu,\n", opt.frames,
+          opt.cycles_per_frame, opt.op_cycles);
+  printf( "  \"reps\": %u,\n  \"warmup\": %u,\n  \"results\": [\n", opt.reps, opt.warmup);
+  for (size_t i = 0; i < results.size(); ++i)
+  {
+    const BenchResult &r = results[i];
+    double m = mean( r.seconds);
+    printf( "    { \"suite\": \"%s\", \"name\": \"%s\", \"mode\": \"%s\", \"unit\": \"%s\", "
+            "\"items\": %.0f, \"mean_s\": %.9f, \"stddev_s\": %.9f, \"best_s\": %.9f, "
+            "\"items_per_s\": %.1f, \"ns_per_item\": %.4f }%s\n", r.suite.c_str(), r.name.c_str(),
+            r.mode.c_str(), r.unit, r.items, m, stddev( r.seconds), best( r.seconds),
+            m > 0 ? r.items / m : 0.0, m * 1e9 / r.items, i + 1 < results.size() ? "," : "");
+  }
+  printf( "  ]\n}\n");
+}
+
+
+int main( int argc, char *argv[] )
+{
+  BenchOptions opt;
+  opt.frames = 20000;
+  opt.cycles_per_frame = 10;
+  opt.op_cycles = 1000000;
+  opt.reps = 10;
+  opt.warmup = 2;
+
+  const char *suites = "rom,op,gfx";
+  const char *modes = "switch,table,block,jit";
+  const char *format = "text";
+  const char *label = "";
+  vector<string> roms;
+
+  for (int i = 1; i < argc; ++i)
+  {
+    if (strcmp( argv[i], "-s") == 0 && i + 1 < argc)
+      suites = argv[++i];
+    else if (strcmp( argv[i], "-m") == 0 && i + 1 < argc)
+      modes = argv[++i];
+    else if (strcmp( argv[i], "-f") == 0 && i + 1 < argc)
+      opt.frames = strtoul( argv[++i], NULL, 10);
+    else if (strcmp( argv[i], "-i") == 0 && i + 1 < argc)
+      opt.cycles_per_frame = strtoul( argv[++i], NULL, 10);
+    else if (strcmp( argv[i], "-n") == 0 && i + 1 < argc)
+      opt.op_cycles = strtoull( argv[++i], NULL, 10);
+    else if (strcmp( argv[i], "-r") == 0 && i + 1 < argc)
+      opt.reps = strtoul( argv[++i], NULL, 10);
+    else if (strcmp( argv[i], "-w") == 0 && i + 1 < argc)
+      opt.warmup = strtoul( argv[++i], NULL, 10);
+    else if (strcmp( argv[i], "-F") == 0 && i + 1 < argc)
+      format = argv[++i];
+    else if (strcmp( argv[i], "-l") == 0 && i + 1 < argc)
+      label = argv[++i];
+    else if (argv[i][0] == '-')
+    {
+      usage( argv[0]);
+      return 1;
+    }
+    else
+      collectRoms( argv[i], roms);
+  }
+
+  if (roms.empty() && listed( suites, "rom"))
+    collectRoms( "ROMs", roms);
+
+  if (opt.reps == 0 || opt.frames == 0 || opt.cycles_per_frame == 0 || opt.op_cycles == 0 ||
+      (strcmp( format, "text") != 0 && strcmp( format, "json") != 0 && strcmp( format, "csv") != 0))
+  {
+    usage( argv[0]);
+    return 1;
+  }
+
+  static const Chip8::ExecMode ALL_MODES[] =
+    { Chip8::EXEC_SWITCH, Chip8::EXEC_TABLE, Chip8::EXEC_BLOCK, Chip8::EXEC_JIT, Chip8::EXEC_AOT };
+
+  vector<BenchResult> results;
+  for (size_t m = 0; m < sizeof(ALL_MODES) / sizeof(ALL_MODES[0]); ++m)
+  {
+    Chip8::ExecMode mode = ALL_MODES[m];
+    if (!listed( modes, modeName( mode)))
+      continue;
+
+    if (listed( suites, "rom"))
+    {
+      for (size_t i = 0; i < roms.size(); ++i)
+        benchRom( roms[i], mode, opt, results);
+    }
+
+    if (listed( suites, "op"))
+    {
+      for (size_t i = 0; i < sizeof(OP_BENCHES) / sizeof(OP_BENCHES[0]); ++i)
+        benchOp( OP_BENCHES[i], mode, opt, results);
+    }
+  }
+
+  if (listed( suites, "gfx"))
+    benchGfx( opt, results);
+
+  if (strcmp( format, "json") == 0)
+    printJson( results, label, opt);
+  else if (strcmp( format, "csv") == 0)
+    printCsv( results, label);
+  else
+    printText( results);
+
+  return 0;
+
+}
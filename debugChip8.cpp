@@ -0,0 +1,292 @@
+/**
+ * @brief  CHIP8 EMULATOR PROJECT
+ * @Author esantiago
+ * @date   October, 2026
+ *
+ * @description: Headless Chip8 with a GDB remote stub
+ *
+ * Runs a ROM in real time without a window or input and serves a GDB
+ * remote protocol client on a local port or Unix socket. The ROM runs
+ * normally until a client attaches, then stops for it.
+ *
+ * -t checks reverse execution instead: a short program that stores to
+ * memory is stepped and reversed the way a client would, then the ROM
+ * (if any) is walked forward and back at random for -n steps. After
+ * every step the machine has to hash the same as a straight run to the
+ * same instruction, memory and registers included.
+ *
+ * usage: debug_Chip8 [-g port|path] [-f cycles-per-frame] [-m switch|table|block|jit|aot]
+ *                    [-s seed] ROM
+ *        debug_Chip8 -t [-n steps] [-m switch|table|block|jit|aot] [ROM]
+ */
+
+#include <cstddef>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "Chip8.h"
+#include "Debugger.h"
+#include "GdbStub.h"
+#include "Scheduler.h"
+
+using namespace std;
+
+
+static void usage( const char *prog)
+{
+  printf( "usage: %s [-g port|path] [-f cycles-per-frame] [-m switch|table|block|jit|aot]\n"
+          "       [-s seed] ROM\n"
+          "       %s -t [-n steps] [-m switch|table|block|jit|aot] [ROM]\n", prog, prog);
+}
+
+
+// A script of moves ('s' steps, 'r' reverse steps) played from the stop
+// handler, the way a client drives the debugger: the whole script runs
+// inside one runCycles call. After every move the machine is compared
+// with a straight run to the same instruction; that one only goes
+// forward, so the hash after each instruction is kept.
+struct ReverseCheck
+{
+  const char *name;
+  string script;
+  size_t move;
+  Chip8 straight;
+  vector<uint64_t> hashes;
+  size_t position;
+  bool failed;
+};
+
+
+static bool matches( ReverseCheck &check, const Chip8 &chip8)
+{
+  if (chip8.hashState() == check.hashes[check.position])
+    return true;
+
+  printf( "%s: move %zu left instruction %zu differing from a straight run, pc %03X\n",
+          check.name, check.move, check.position, Debugger::registerValue( chip8, Debugger::REG_PC));
+  check.failed = true;
+  return false;
+
+}
+
+
+static void playMoves( Debugger &debugger, const Debugger::Stop &stop, void *user)
+{
+  ReverseCheck &check = *static_cast<ReverseCheck *>( user);
+  const Chip8 &chip8 = debugger.machine();
+
+  if (stop.reason == Debugger::STOP_STEP)
+  {
+    if (++check.position == check.hashes.size())
+    {
+      check.straight.emulateCycle();
+      check.hashes.push_back( check.straight.hashState());
+    }
+    ++check.move;
+  }
+
+  while (matches( check, chip8) && check.move < check.script.size())
+  {
+    if (check.script[check.move] == 's')
+    {
+      debugger.step();
+      return;
+    }
+    if (!debugger.reverseStep())
+    {
+      printf( "%s: move %zu, no history left at instruction %zu\n", check.name, check.move, check.position);
+      check.failed = true;
+      break;
+    }
+    --check.position;
+    ++check.move;
+  }
+
+  debugger.resume();
+
+}
+
+
+static bool checkReverse( const char *name, const unsigned char *program, size_t size,
+                          Chip8::ExecMode mode, const string &script)
+{
+  ReverseCheck check;
+  check.name = name;
+  check.script = script;
+  check.move = 0;
+  check.straight.initialize();
+  check.straight.seedRandom( 1);
+  check.straight.loadProgram( program, size);
+  check.hashes.assign( 1, check.straight.hashState());
+  check.position = 0;
+  check.failed = false;
+
+  Chip8 chip8;
+  chip8.initialize();
+  chip8.seedRandom( 1);
+  chip8.setExecMode( mode);
+  chip8.loadProgram( program, size);
+
+  // stops before the first instruction, the handler takes it from there;
+  // the call runs one instruction per step
+  Debugger debugger( chip8);
+  debugger.setStopHandler( playMoves, &check);
+  debugger.requestStop();
+  chip8.runCycles( count( script.begin(), script.end(), 's'));
+
+  if (!check.failed && check.move < script.size())
+  {
+    printf( "%s: stopped after %zu of %zu moves\n", name, check.move, script.size());
+    check.failed = true;
+  }
+  if (!check.failed)
+    printf( "%s: %zu moves, reverse execution matches\n", name, script.size());
+  return !check.failed;
+
+}
+
+
+static int selfCheck( const char *rom, unsigned long long steps, Chip8::ExecMode mode)
+{
+  // I = 0x300, V0 = 1, store V0, then V0 += 1 in a loop: stepping over
+  // the store and back twice has to bring the stored byte back both times
+  static const unsigned char STORE_LOOP[] =
+    { 0xA3, 0x00, 0x60, 0x01, 0xF0, 0x55, 0x70, 0x01, 0x12, 0x04 };
+  bool ok = checkReverse( "store loop", STORE_LOOP, sizeof(STORE_LOOP), mode, "ssssrsrsssrrrsss");
+
+  if (rom != NULL)
+  {
+    FILE *file = fopen( rom, "rb");
+    unsigned char program[4096 - 512];
+    size_t size = 0;
+    if (file != NULL)
+    {
+      size = fread( program, 1, sizeof(program), file);
+      fclose( file);
+    }
+    if (size == 0)
+    {
+      printf( "%s FAILED TO LOAD\n", rom);
+      return 1;
+    }
+
+    // two steps forward for each one back, in random runs
+    string script;
+    uint32_t state = 0x9E3779B9;
+    size_t position = 0;
+    while (script.size() < steps)
+    {
+      state ^= state << 13;
+      state ^= state >> 17;
+      state ^= state << 5;
+      bool back = position > 0 && state % 3 == 0;
+      unsigned int run = 1 + (state >> 8) % 8;
+      for (unsigned int k = 0; k < run && script.size() < steps && (!back || position > 0); ++k)
+      {
+        script += back ? 'r' : 's';
+        if (back)
+          --position;
+        else
+          ++position;
+      }
+    }
+    ok = checkReverse( rom, program, size, mode, script) && ok;
+  }
+
+  return ok ? 0 : 1;
+
+}
+
+
+int main( int argc, char *argv[] )
+{
+  const char *where = "1234";
+  unsigned int per_frame = 10;
+  Chip8::ExecMode mode = Chip8::EXEC_SWITCH;
+  uint32_t seed = 1;
+  const char *rom = NULL;
+  bool check = false;
+  unsigned long long steps = 100000;
+
+  for (int i = 1; i < argc; ++i)
+  {
+    if (strcmp( argv[i], "-g") == 0 && i + 1 < argc)
+      where = argv[++i];
+    else if (strcmp( argv[i], "-t") == 0)
+      check = true;
+    else if (strcmp( argv[i], "-n") == 0 && i + 1 < argc)
+      steps = strtoull( argv[++i], NULL, 10);
+    else if (strcmp( argv[i], "-f") == 0 && i + 1 < argc)
+      per_frame = strtoul( argv[++i], NULL, 10);
+    else if (strcmp( argv[i], "-s") == 0 && i + 1 < argc)
+      seed = strtoul( argv[++i], NULL, 10);
+    else if (strcmp( argv[i], "-m") == 0 && i + 1 < argc)
+    {
+      const char *name = argv[++i];
+      if (strcmp( name, "switch") == 0)
+        mode = Chip8::EXEC_SWITCH;
+      else if (strcmp( name, "table") == 0)
+        mode = Chip8::EXEC_TABLE;
+      else if (strcmp( name, "block") == 0)
+        mode = Chip8::EXEC_BLOCK;
+      else if (strcmp( name, "jit") == 0)
+        mode = Chip8::EXEC_JIT;
+      else if (strcmp( name, "aot") == 0)
+        mode = Chip8::EXEC_AOT;
+      else
+      {
+        usage( argv[0]);
+        return 1;
+      }
+    }
+    else if (argv[i][0] == '-' || rom != NULL)
+    {
+      usage( argv[0]);
+      return 1;
+    }
+    else
+      rom = argv[i];
+  }
+
+  if (check)
+    return selfCheck( rom, steps, mode);
+
+  if (rom == NULL)
+  {
+    usage( argv[0]);
+    return 1;
+  }
+
+  Chip8 chip8;
+  chip8.initialize();
+  chip8.seedRandom( seed);
+  chip8.setExecMode( mode);
+  if (!chip8.loadGame( rom))
+  {
+    printf( "%s FAILED TO LOAD\n", rom);
+    return 1;
+  }
+
+  // a number is a TCP port on localhost, anything else a socket path
+  Debugger debugger( chip8);
+  GdbStub stub( debugger);
+  char *end;
+  unsigned long port = strtoul( where, &end, 10);
+  if (*end == 0 ? !stub.listenTcp( port) : !stub.listenUnix( where))
+    return 1;
+  printf( "%s: waiting for gdb on %s\n", rom, where);
+
+  Scheduler scheduler( per_frame);
+  for (;;)
+  {
+    stub.poll();
+    unsigned int frames = scheduler.framesDue();
+    for (unsigned int f = 0; f < frames; ++f)
+      chip8.runFrame( scheduler.cyclesPerFrame());
+    scheduler.sleepUntilNextFrame();
+  }
+
+}
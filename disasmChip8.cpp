@@ -0,0 +1,178 @@
+/**
+ * @brief  CHIP8 EMULATOR PROJECT
+ * @Author esantiago
+ * @date   October, 2026
+ *
+ * @description: Batch disassembler for the chip8 project
+ *
+ * Disassembles one ROM, or every ROM of a directory in parallel over the
+ * work-stealing thread pool. Every worker keeps one Disassembler, so its
+ * buffers are reused from ROM to ROM. Listings are printed in ROM order,
+ * or written as OUTDIR/<rom name>.asm with -o, followed by how many
+ * bytes of each ROM were found to be code and how many data.
+ *
+ * usage: disasm_Chip8 [-j threads] [-o outdir] [-q] ROM|DIR ...
+ */
+
+#include <cstddef>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <chrono>
+#include "Disassembler.h"
+#include "RomFiles.h"
+#include "ThreadPool.h"
+
+using namespace std;
+
+
+struct DisasmResult
+{
+  string rom;
+  bool loaded;
+  bool written;
+  size_t code_bytes;
+  size_t data_bytes;
+  string listing; // only kept when printing to stdout
+};
+
+
+static void usage( const char *prog)
+{
+  printf( "usage: %s [-j threads] [-o outdir] [-q] ROM|DIR ...\n", prog);
+}
+
+
+// same limit as Chip8::loadProgram, 0x200 up to the end of memory
+static bool readRom( const char *path, vector<unsigned char> &program)
+{
+  FILE *file = fopen( path, "rb");
+  if (file == NULL)
+    return false;
+
+  program.resize( 4096 - 512 + 1);
+  size_t size = fread( &program[0], 1, program.size(), file);
+  fclose( file);
+  program.resize( size);
+  return size > 0 && size <= 4096 - 512;
+}
+
+
+static string baseName( const string &path)
+{
+  size_t slash = path.find_last_of( '/');
+  return slash == string::npos ? path : path.substr( slash + 1);
+}
+
+
+static void disassembleRom( DisasmResult &result, const char *outdir, bool keep)
+{
+  thread_local Disassembler disassembler;
+  thread_local vector<unsigned char> program;
+
+  result.loaded = readRom( result.rom.c_str(), program);
+  result.written = false;
+  result.code_bytes = result.data_bytes = 0;
+  if (!result.loaded)
+    return;
+
+  const string &listing = disassembler.run( &program[0], program.size());
+  result.code_bytes = disassembler.codeBytes();
+  result.data_bytes = disassembler.dataBytes();
+
+  if (outdir != NULL)
+  {
+    string path = string( outdir) + "/" + baseName( result.rom) + ".asm";
+    FILE *out = fopen( path.c_str(), "w");
+    if (out != NULL)
+    {
+      result.written = fwrite( listing.data(), 1, listing.size(), out) == listing.size();
+      result.written = fclose( out) == 0 && result.written;
+    }
+  }
+  else if (keep)
+    result.listing = listing;
+}
+
+
+int main( int argc, char *argv[] )
+{
+  size_t threads = 0;
+  const char *outdir = NULL;
+  bool quiet = false;
+  vector<string> roms;
+
+  for (int i = 1; i < argc; ++i)
+  {
+    if (strcmp( argv[i], "-j") == 0 && i + 1 < argc)
+      threads = strtoul( argv[++i], NULL, 10);
+    else if (strcmp( argv[i], "-o") == 0 && i + 1 < argc)
+      outdir = argv[++i];
+    else if (strcmp( argv[i], "-q") == 0)
+      quiet = true;
+    else if (argv[i][0] == '-')
+    {
+      usage( argv[0]);
+      return 1;
+    }
+    else
+      collectRoms( argv[i], roms);
+  }
+
+  if (roms.empty())
+  {
+    usage( argv[0]);
+    return 1;
+  }
+
+  vector<DisasmResult> results( roms.size());
+  for (size_t i = 0; i < results.size(); ++i)
+    results[i].rom = roms[i];
+
+  chrono::steady_clock::time_point start = chrono::steady_clock::now();
+  {
+    ThreadPool pool( threads);
+    bool keep = !quiet;
+
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+      DisasmResult *slot = &results[i];
+      pool.submit( [slot, outdir, keep]() { disassembleRom( *slot, outdir, keep); });
+    }
+
+    pool.wait();
+  }
+  chrono::duration<double> wall = chrono::steady_clock::now() - start;
+
+  size_t failed = 0;
+  size_t total = 0;
+  for (size_t i = 0; i < results.size(); ++i)
+  {
+    const DisasmResult &r = results[i];
+    if (!r.loaded)
+    {
+      fprintf( stderr, "%-24s FAILED TO LOAD\n", r.rom.c_str());
+      ++failed;
+      continue;
+    }
+    if (outdir != NULL && !r.written)
+    {
+      fprintf( stderr, "%-24s FAILED TO WRITE\n", r.rom.c_str());
+      ++failed;
+      continue;
+    }
+
+    if (outdir == NULL && !quiet)
+      printf( "; %s\n%s\n", r.rom.c_str(), r.listing.c_str());
+    fprintf( stderr, "%-24s %5zu code bytes %5zu data bytes\n", r.rom.c_str(), r.code_bytes, r.data_bytes);
+    total += r.code_bytes + r.data_bytes;
+  }
+
+  fprintf( stderr, "\n%zu ROMs, %zu failed, %zu bytes in %.3f ms\n", results.size(), failed, total,
+           wall.count() * 1e3);
+
+  return failed == 0 ? 0 : 1;
+
+}
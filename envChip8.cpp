@@ -0,0 +1,134 @@
+/**
+ * @brief  CHIP8 EMULATOR PROJECT
+ * @Author esantiago
+ * @date   October, 2026
+ *
+ * @description: Random agent driver for the environment API
+ *
+ * Steps a batch of environments of one ROM with random action masks,
+ * the observations, rewards and done flags landing in flat arrays the
+ * way a training loop would consume them. Episodes are cut at the frame
+ * limit and reset automatically. Reports steps and frames per second.
+ *
+ * usage: env_Chip8 [-n envs] [-j threads] [-s steps] [-k frames-per-step]
+ *                  [-f cycles-per-frame] [-t max-frames] ROM
+ */
+
+#include <cstddef>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include <chrono>
+#include "Chip8Env.h"
+
+using namespace std;
+
+
+static void usage( const char *prog)
+{
+  printf( "usage: %s [-n envs] [-j threads] [-s steps] [-k frames-per-step]\n"
+          "       [-f cycles-per-frame] [-t max-frames] ROM\n", prog);
+}
+
+
+// pixels lit, a stand-in for a ROM specific score
+static float litPixels( const unsigned char *, const uint64_t *framebuffer, void *)
+{
+  unsigned int lit = 0;
+  for (size_t row = 0; row < 32; ++row)
+    lit += __builtin_popcountll( framebuffer[row]);
+  return lit / 2048.0f;
+}
+
+
+int main( int argc, char *argv[] )
+{
+  size_t envs = 64;
+  size_t threads = 1;
+  unsigned long long steps = 10000;
+  unsigned int frames = 4;
+  unsigned int per_frame = 10;
+  unsigned long long max_frames = 3600;
+  const char *rom = NULL;
+
+  for (int i = 1; i < argc; ++i)
+  {
+    if (strcmp( argv[i], "-n") == 0 && i + 1 < argc)
+      envs = strtoul( argv[++i], NULL, 10);
+    else if (strcmp( argv[i], "-j") == 0 && i + 1 < argc)
+      threads = strtoul( argv[++i], NULL, 10);
+    else if (strcmp( argv[i], "-s") == 0 && i + 1 < argc)
+      steps = strtoull( argv[++i], NULL, 10);
+    else if (strcmp( argv[i], "-k") == 0 && i + 1 < argc)
+      frames = strtoul( argv[++i], NULL, 10);
+    else if (strcmp( argv[i], "-f") == 0 && i + 1 < argc)
+      per_frame = strtoul( argv[++i], NULL, 10);
+    else if (strcmp( argv[i], "-t") == 0 && i + 1 < argc)
+      max_frames = strtoull( argv[++i], NULL, 10);
+    else if (argv[i][0] == '-' || rom != NULL)
+    {
+      usage( argv[0]);
+      return 1;
+    }
+    else
+      rom = argv[i];
+  }
+
+  if (rom == NULL || envs == 0 || frames == 0)
+  {
+    usage( argv[0]);
+    return 1;
+  }
+
+  Chip8EnvBatch batch( envs, threads);
+  if (!batch.load( rom))
+  {
+    printf( "%s FAILED TO LOAD\n", rom);
+    return 1;
+  }
+  batch.configure( per_frame, max_frames, true);
+  batch.setHooks( litPixels, NULL, NULL);
+  batch.reset( 1);
+
+  vector<uint16_t> actions( envs);
+  vector<uint64_t> observations( envs * 32);
+  vector<float> rewards( envs);
+  vector<unsigned char> flags( envs);
+  uint32_t rng = 0x2545F491;
+  unsigned long long episodes = 0;
+  double reward_sum = 0;
+
+  chrono::steady_clock::time_point start = chrono::steady_clock::now();
+  for (unsigned long long s = 0; s < steps; ++s)
+  {
+    // at most one key per action, often none
+    for (size_t i = 0; i < envs; ++i)
+    {
+      rng ^= rng << 13;
+      rng ^= rng >> 17;
+      rng ^= rng << 5;
+      actions[i] = (rng >> 24) < 128 ? 1u << ((rng >> 8) & 0xF) : 0;
+    }
+
+    batch.step( &actions[0], frames, &observations[0], &rewards[0], &flags[0]);
+
+    for (size_t i = 0; i < envs; ++i)
+    {
+      reward_sum += rewards[i];
+      if (flags[i] != 0)
+        ++episodes;
+    }
+  }
+  chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+
+  unsigned long long total_steps = steps * envs;
+  printf( "%s: %zu envs, %llu steps of %u frames, %llu episodes ended, mean reward %.4f\n", rom, envs,
+          total_steps, frames, episodes, total_steps > 0 ? reward_sum / total_steps : 0.0);
+  printf( "%.3f s: %.0f steps/s, %.0f frames/s\n", elapsed.count(),
+          elapsed.count() > 0 ? total_steps / elapsed.count() : 0.0,
+          elapsed.count() > 0 ? total_steps * frames / elapsed.count() : 0.0);
+
+  return 0;
+
+}
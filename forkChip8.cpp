@@ -0,0 +1,156 @@
+/**
+ * @brief  CHIP8 EMULATOR PROJECT
+ * @Author esantiago
+ * @date   October, 2026
+ *
+ * @description: Breadth-first search driver for copy-on-write states
+ *
+ * Expands a ROM's state space breadth first: every state of a level is
+ * forked once per action (no key, or one of the first keys held), each
+ * child runs a few frames on a shared worker Chip8 and is captured
+ * again. Children already seen, by hash and then by content, are
+ * dropped; the rest make the next level, cut to the beam width. Reports
+ * forks per second, the unique states found and the memory a child
+ * costs. -v restores every child into a second machine and compares its
+ * state hash with the worker it was captured from.
+ *
+ * usage: fork_Chip8 [-d depth] [-w beam-width] [-a actions] [-k frames-per-step]
+ *                   [-f cycles-per-frame] [-v] ROM
+ */
+
+#include <cstddef>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include <unordered_map>
+#include <chrono>
+#include "Chip8Fork.h"
+
+using namespace std;
+
+
+static void usage( const char *prog)
+{
+  printf( "usage: %s [-d depth] [-w beam-width] [-a actions] [-k frames-per-step]\n"
+          "       [-f cycles-per-frame] [-v] ROM\n", prog);
+}
+
+
+int main( int argc, char *argv[] )
+{
+  unsigned int depth = 8;
+  size_t width = 4096;
+  unsigned int actions = 5;
+  unsigned int frames = 4;
+  unsigned int per_frame = 10;
+  bool verify = false;
+  const char *rom = NULL;
+
+  for (int i = 1; i < argc; ++i)
+  {
+    if (strcmp( argv[i], "-d") == 0 && i + 1 < argc)
+      depth = strtoul( argv[++i], NULL, 10);
+    else if (strcmp( argv[i], "-w") == 0 && i + 1 < argc)
+      width = strtoul( argv[++i], NULL, 10);
+    else if (strcmp( argv[i], "-a") == 0 && i + 1 < argc)
+      actions = strtoul( argv[++i], NULL, 10);
+    else if (strcmp( argv[i], "-k") == 0 && i + 1 < argc)
+      frames = strtoul( argv[++i], NULL, 10);
+    else if (strcmp( argv[i], "-f") == 0 && i + 1 < argc)
+      per_frame = strtoul( argv[++i], NULL, 10);
+    else if (strcmp( argv[i], "-v") == 0)
+      verify = true;
+    else if (argv[i][0] == '-' || rom != NULL)
+    {
+      usage( argv[0]);
+      return 1;
+    }
+    else
+      rom = argv[i];
+  }
+
+  // action 0 holds nothing, action k holds key k - 1
+  if (rom == NULL || width == 0 || actions == 0 || actions > 17)
+  {
+    usage( argv[0]);
+    return 1;
+  }
+
+  Chip8 worker;
+  worker.initialize();
+  worker.seedRandom( 1);
+  if (!worker.loadGame( rom))
+  {
+    printf( "%s FAILED TO LOAD\n", rom);
+    return 1;
+  }
+  Chip8 check;
+  check.initialize();
+  check.loadGame( rom);
+
+  vector<Chip8Fork> level( 1, Chip8Fork( worker));
+  vector<Chip8Fork> next;
+  unordered_multimap<uint64_t, size_t> seen; // hash -> index in 'states'
+  vector<Chip8Fork> states( level);
+  seen.insert( make_pair( level[0].hash(), 0));
+
+  unsigned long long forks = 0;
+  unsigned long long copied_pages = 0;
+  unsigned long long mismatches = 0;
+
+  chrono::steady_clock::time_point start = chrono::steady_clock::now();
+  for (unsigned int d = 0; d < depth && !level.empty(); ++d)
+  {
+    next.clear();
+    for (size_t s = 0; s < level.size(); ++s)
+    {
+      for (unsigned int a = 0; a < actions; ++a)
+      {
+        Chip8Fork child = level[s].clone();
+        child.restore( worker);
+        for (size_t k = 0; k < 16; ++k)
+          worker.key[k] = a == k + 1;
+        for (unsigned int f = 0; f < frames; ++f)
+          worker.runFrame( per_frame);
+        child.capture( worker);
+        ++forks;
+        copied_pages += child.copiedPages();
+
+        if (verify)
+        {
+          child.restore( check);
+          if (check.hashState() != worker.hashState())
+            ++mismatches;
+        }
+
+        // transposition: the same machine reached by another input
+        bool known = false;
+        pair<unordered_multimap<uint64_t, size_t>::iterator,
+             unordered_multimap<uint64_t, size_t>::iterator> range = seen.equal_range( child.hash());
+        for (unordered_multimap<uint64_t, size_t>::iterator it = range.first; it != range.second && !known; ++it)
+          known = states[it->second].sameState( child);
+        if (known)
+          continue;
+
+        seen.insert( make_pair( child.hash(), states.size()));
+        states.push_back( child);
+        if (next.size() < width)
+          next.push_back( child);
+      }
+    }
+    level.swap( next);
+    printf( "depth %u: %zu new states\n", d + 1, level.size());
+  }
+  chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+
+  printf( "%s: %llu forks, %zu unique states, %.2f pages copied per fork (%zu bytes per fork before pages)\n",
+          rom, forks, states.size(), forks > 0 ? (double)copied_pages / forks : 0.0, sizeof(Chip8Fork));
+  printf( "%.3f s: %.0f forks/s (%u frames each)\n", elapsed.count(),
+          elapsed.count() > 0 ? forks / elapsed.count() : 0.0, frames);
+  if (verify)
+    printf( "%llu of %llu restored states differ\n", mismatches, forks);
+
+  return mismatches == 0 ? 0 : 1;
+
+}
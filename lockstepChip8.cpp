@@ -0,0 +1,168 @@
+/**
+ * @brief  CHIP8 EMULATOR PROJECT
+ * @Author esantiago
+ * @date   October, 2026
+ *
+ * @description: Lockstep checker for the chip8 execution modes
+ *
+ * Runs every ROM twice side by side: once through the reference switch
+ * in emulateCycle, without idle loop skipping, and once through the mode
+ * under test (the JIT by default) with it. Both instances get the same
+ * scripted key presses, RNG seed and quirks (from ROM.quirks or -q), and
+ * their machine state is compared after every slice of instructions.
+ * Slice lengths vary so block and translation boundaries fall everywhere.
+ * With quirks the reference decodes through the table, the switch only
+ * knows the default behaviour.
+ *
+ * usage: lockstep_Chip8 [-m switch|table|block|jit|aot] [-c cycles] [-q quirks] ROM|DIR ...
+ */
+
+#include <cstddef>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "Chip8.h"
+#include "RomFiles.h"
+
+using namespace std;
+
+
+static void usage( const char *prog)
+{
+  printf( "usage: %s [-m switch|table|block|jit|aot] [-c cycles] [-q quirks] ROM|DIR ...\n", prog);
+}
+
+
+// returns true when both instances stayed identical for 'cycles'
+static bool lockstep( const char *rom, Chip8::ExecMode mode, unsigned int quirks, unsigned long long cycles)
+{
+  Chip8 *reference = new Chip8;
+  Chip8 *candidate = new Chip8;
+  bool same = true;
+
+  reference->initialize();
+  candidate->initialize();
+  candidate->setExecMode( mode);
+  reference->setIdleSkip( false);
+  reference->setQuirks( quirks);
+  candidate->setQuirks( quirks);
+  reference->seedRandom( 0x43384C53);
+  candidate->seedRandom( 0x43384C53);
+
+  if (!reference->loadGame( rom) || !candidate->loadGame( rom))
+  {
+    printf( "%-24s FAILED TO LOAD\n", rom);
+    delete reference;
+    delete candidate;
+    return false;
+  }
+
+  unsigned long long done = 0;
+  for (unsigned int slice = 0; done < cycles; ++slice)
+  {
+    // hold a different key pattern every few hundred instructions
+    if (slice % 64 == 0)
+    {
+      for (size_t k = 0; k < 16; ++k)
+        reference->key[k] = candidate->key[k] = ((slice / 64) * 7 + k) % 5 == 0;
+    }
+
+    unsigned long long length = 1 + (slice * 7919) % 37;
+    if (length > cycles - done)
+      length = cycles - done;
+
+    reference->runCycles( length);
+    candidate->runCycles( length);
+    done += length;
+
+    // roughly one 60 Hz tick per ten instructions
+    if (slice % 2 == 1)
+    {
+      reference->tickTimers();
+      candidate->tickTimers();
+    }
+
+    const char *field = reference->diffState( *candidate);
+    if (field != NULL)
+    {
+      printf( "%-24s DIVERGED in %s after %llu instructions\n", rom, field, done);
+      same = false;
+      break;
+    }
+  }
+
+  if (same)
+    printf( "%-24s OK (%llu instructions)\n", rom, done);
+
+  delete reference;
+  delete candidate;
+  return same;
+}
+
+
+int main( int argc, char *argv[] )
+{
+  Chip8::ExecMode mode = Chip8::EXEC_JIT;
+  unsigned long long cycles = 1000000;
+  const char *quirk_list = NULL;
+  vector<string> roms;
+
+  for (int i = 1; i < argc; ++i)
+  {
+    if (strcmp( argv[i], "-c") == 0 && i + 1 < argc)
+      cycles = strtoull( argv[++i], NULL, 10);
+    else if (strcmp( argv[i], "-q") == 0 && i + 1 < argc)
+      quirk_list = argv[++i];
+    else if (strcmp( argv[i], "-m") == 0 && i + 1 < argc)
+    {
+      ++i;
+      if (strcmp( argv[i], "switch") == 0)
+        mode = Chip8::EXEC_SWITCH;
+      else if (strcmp( argv[i], "table") == 0)
+        mode = Chip8::EXEC_TABLE;
+      else if (strcmp( argv[i], "block") == 0)
+        mode = Chip8::EXEC_BLOCK;
+      else if (strcmp( argv[i], "jit") == 0)
+        mode = Chip8::EXEC_JIT;
+      else if (strcmp( argv[i], "aot") == 0)
+        mode = Chip8::EXEC_AOT;
+      else
+      {
+        usage( argv[0]);
+        return 1;
+      }
+    }
+    else if (argv[i][0] == '-')
+    {
+      usage( argv[0]);
+      return 1;
+    }
+    else
+      collectRoms( argv[i], roms);
+  }
+
+  if (roms.empty())
+  {
+    usage( argv[0]);
+    return 1;
+  }
+
+  size_t failed = 0;
+  for (size_t i = 0; i < roms.size(); ++i)
+  {
+    unsigned int quirks;
+    if (quirk_list != NULL ? !parseQuirks( quirk_list, quirks) : !romQuirks( roms[i].c_str(), quirks))
+    {
+      printf( "Unknown quirk in %s\n", quirk_list != NULL ? quirk_list : (roms[i] + ".quirks").c_str());
+      return 1;
+    }
+    if (!lockstep( roms[i].c_str(), mode, quirks, cycles))
+      ++failed;
+  }
+
+  printf( "\n%zu ROMs checked, %zu failed\n", roms.size(), failed);
+  return failed == 0 ? 0 : 1;
+
+}
@@ -7,22 +7,322 @@
  */
 
 #include <SDL2/SDL.h>
-#include <SDL2/SDL_mixer.h>
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+#include <string>
+#include <atomic>
+#include <thread>
 #include "Chip8.h"
 #include "EmuGfx.h"
+#include "Scheduler.h"
+#include "Rewind.h"
+#include "InputLog.h"
+#include "Beeper.h"
+#include "RomFiles.h"
+#include "FrameHandoff.h"
+#include "Chip8Fork.h"
+#include "Debugger.h"
+#include "GdbStub.h"
+#include "Trace.h"
+#ifdef CHIP8_PROFILE
+#include "Profiler.h"
+#endif
 
 using namespace std;
 
 
+// quick save slot next to the ROM, ROM.state
+static bool saveStateFile( const Chip8 &chip8, const char *rom)
+{
+  unsigned char state[Chip8::STATE_SIZE];
+  string path = string( rom) + ".state";
+  FILE *file = fopen( path.c_str(), "wb");
+  if (file == NULL)
+    return false;
+
+  chip8.saveState( state);
+  bool ok = fwrite( state, 1, sizeof(state), file) == sizeof(state);
+  fclose( file);
+  return ok;
+}
+
+
+static bool loadStateFile( Chip8 &chip8, const char *rom)
+{
+  unsigned char state[Chip8::STATE_SIZE + 1];
+  string path = string( rom) + ".state";
+  FILE *file = fopen( path.c_str(), "rb");
+  if (file == NULL)
+    return false;
+
+  size_t size = fread( state, 1, sizeof(state), file);
+  fclose( file);
+  return chip8.loadState( state, size);
+}
+
+
+// Everything the emulation thread owns, plus the few atomics through
+// which the main thread steers it. The main thread only pumps events and
+// presents what the handoff gives it, so a slow present or a busy event
+// queue never holds up emulated time.
+struct Session
+{
+  Chip8 chip8;
+  Scheduler scheduler;
+  Rewind history;
+  InputLog input_log;
+  Beeper beeper;
+  Debugger debugger;
+  GdbStub gdb;             // only listens with --gdb
+  TraceRecorder trace;     // only open with --trace
+  FrameHandoff handoff;
+  Chip8Fork present_state; // the real machine while run-ahead frames are shown, the first capture takes every page
+  unsigned int run_ahead;  // frames emulated ahead for display only, 0 is off
+  const char *rom;
+  const char *record;
+  unsigned int frame;
+  unsigned long long emulated_frames; // every frame, rewound ones included, the beeper's clock
+  uint64_t frame_hash;
+
+  // written by the main thread, read by the emulation thread
+  std::atomic<unsigned int> keys;  // keypad, bit k = key k held
+  std::atomic<bool> rewinding;
+  std::atomic<unsigned int> speed; // 0 is turbo
+  std::atomic<int> request;        // quick save or load, REQUEST_*
+  std::atomic<bool> quit;
+
+  enum { REQUEST_NONE, REQUEST_SAVE, REQUEST_LOAD };
+
+  Session()
+    : debugger(chip8), gdb(debugger), run_ahead(0), rom(NULL), record(NULL), frame(0), emulated_frames(0), frame_hash(0),
+      keys(0), rewinding(false), speed(1), request(REQUEST_NONE), quit(false)
+  {
+  }
+};
+
+
+// the keypad follows the held keys; a restored snapshot carries the
+// keypad of its time, this puts the real one back
+static void applyKeys( Session &session)
+{
+  unsigned int keys = session.keys.load( memory_order_relaxed);
+  for (size_t i = 0; i < 16; ++i)
+    session.chip8.key[i] = (keys >> i) & 1;
+}
+
+
+// Emulation thread: runs every frame that is due, hands finished frames
+// to the main thread and sleeps until the next one.
+static void emulate( Session &session)
+{
+  Chip8 &chip8_emu = session.chip8;
+  Scheduler &scheduler = session.scheduler;
+
+  while (!session.quit.load( memory_order_relaxed))
+  {
+    // a debugger client attaching or interrupting; while it has the core
+    // stopped this thread waits in the stub, the window stays live
+    session.gdb.poll();
+
+    unsigned int speed = session.speed.load( memory_order_relaxed);
+    if (speed != scheduler.speed())
+      scheduler.setSpeed( speed );
+
+    // F5 quick save, F9 quick load (not while recording)
+    int request = session.request.exchange( Session::REQUEST_NONE );
+    if (request == Session::REQUEST_SAVE)
+    {
+      if ( !saveStateFile( chip8_emu, session.rom ) )
+        printf( "\nFailed to save state!\n" );
+    }
+    else if (request == Session::REQUEST_LOAD && session.record == NULL)
+    {
+      if ( loadStateFile( chip8_emu, session.rom ) )
+      {
+        session.history.clear();
+        session.history.push( chip8_emu );
+      }
+      else
+        printf( "\nFailed to load state!\n" );
+    }
+
+    // emulate every 60 Hz frame that is due (CPU budget + timer tick),
+    // while backspace is held play the history backwards instead
+    unsigned int frames = scheduler.framesDue();
+    for (unsigned int f = 0; f < frames; ++f)
+    {
+      if (session.rewinding.load( memory_order_relaxed) && session.record == NULL)
+      {
+        session.history.rewind( chip8_emu );
+        session.beeper.update( ++session.emulated_frames, false );
+        continue;
+      }
+
+      applyKeys( session );
+      if (session.record != NULL)
+        session.input_log.record( session.frame, chip8_emu.key );
+      chip8_emu.runFrame( scheduler.cyclesPerFrame() );
+      if (session.record != NULL)
+        session.frame_hash = chip8_emu.hashState( session.frame_hash );
+      session.history.push( chip8_emu );
+      ++session.frame;
+      // sped up there is no sensible pitch or timing, stay quiet
+      session.beeper.update( ++session.emulated_frames, scheduler.speed() == 1 && chip8_emu.soundActive() );
+    }
+
+    // run-ahead: show where the game will be a few frames from now with
+    // the keys held now, then put the real machine back. The game reacts
+    // to a press that many frames sooner on screen. Only pages written
+    // since the last frame are saved, so this costs the frames themselves.
+    // present_state keeps its own track of the pages it saw, so a debug
+    // session or a rewind in between cannot leave it with stale ones.
+    // A trace holds what really ran, so it is off while tracing.
+    if (session.run_ahead > 0 && frames > 0 && !session.rewinding.load( memory_order_relaxed) &&
+        !session.gdb.connected() && !session.trace.isOpen())
+    {
+      session.present_state.capture( chip8_emu );
+      for (unsigned int f = 0; f < session.run_ahead; ++f)
+        chip8_emu.runFrame( scheduler.cyclesPerFrame() );
+      memcpy( session.handoff.back(), chip8_emu.gfxRows(), 32 * sizeof(uint64_t) );
+      session.handoff.publish();
+      session.present_state.restore( chip8_emu );
+
+      // the frame ahead stands in for this one, which restore() flagged
+      // for drawing as the display changed back
+      chip8_emu.draw_flag = false;
+    }
+
+    // only the latest framebuffer of the batch is handed over, the main
+    // thread presents whichever one is newest when the display is due
+    if (chip8_emu.draw_flag)
+    {
+      memcpy( session.handoff.back(), chip8_emu.gfxRows(), 32 * sizeof(uint64_t) );
+      session.handoff.publish();
+      chip8_emu.draw_flag = false;
+    }
+
+    // nothing left to do until the next frame, give the core back
+    scheduler.sleepUntilNextFrame();
+  }
+
+}
+
+
+static void handleEvent( const SDL_Event &e, Session &session, EmuGfx &gfx, unsigned int speed)
+{
+  //User requests quit
+  if ( e.type == SDL_QUIT )
+  {
+    session.quit = true;
+  }
+
+  // the window was uncovered: only changed rows get presented, so redraw
+  // the whole frame on screen, it may not change again for a while
+  else if ( e.type == SDL_WINDOWEVENT && e.window.event == SDL_WINDOWEVENT_EXPOSED )
+  {
+    gfx.invalidate();
+    gfx.drawGfx( session.handoff.front() );
+  }
+
+  else if ( e.type == SDL_KEYDOWN )
+  {
+    // F5 quick save, F9 quick load, backspace rewinds, tab is turbo
+    if ( e.key.keysym.sym == SDLK_F5 )
+      session.request = Session::REQUEST_SAVE;
+    else if ( e.key.keysym.sym == SDLK_F9 )
+      session.request = Session::REQUEST_LOAD;
+    else if ( e.key.keysym.sym == SDLK_BACKSPACE )
+      session.rewinding = true;
+    else if ( e.key.keysym.sym == SDLK_TAB && e.key.repeat == 0 )
+      session.speed = 0;
+
+    for (size_t i = 0; i < 16; ++i)
+    {
+      if ( e.key.keysym.sym == gfx.keymap[i] )
+        session.keys.fetch_or( 1u << i, memory_order_relaxed );
+    }
+  }
+
+  else if ( e.type == SDL_KEYUP )
+  {
+    if ( e.key.keysym.sym == SDLK_BACKSPACE )
+      session.rewinding = false;
+    else if ( e.key.keysym.sym == SDLK_TAB )
+      session.speed = speed;
+
+    for (size_t i = 0; i < 16; ++i)
+    {
+      if ( e.key.keysym.sym == gfx.keymap[i] )
+        session.keys.fetch_and( ~(1u << i), memory_order_relaxed );
+    }
+  }
+
+}
+
+
 int main( int argc, char *argv[] )
 {
 
-  Chip8 chip8_emu;
+  Session session;
+  Chip8 &chip8_emu = session.chip8;
   EmuGfx chip8_Gfx;  
+  Scheduler display; // presents, at the display rate whatever the emulation speed
 
+  // usage: testing_Chip8 [--ipf cycles-per-frame] [--speed N] [--vsync] [--no-audio] [--quirks LIST]
+  //                     [--run-ahead N] [--gdb PORT|PATH] [--trace FILE] [--seed N] [--record LOG] ROM
+  const char *rom = NULL;
+  const char *quirk_list = NULL;
+  const char *record = NULL;
+  const char *gdb = NULL;
+  const char *trace = NULL;
+  uint32_t seed = time(NULL);
+  bool vsync = false;
+  bool audio = true;
+  unsigned int speed = 1; // 0 is turbo, Tab switches to it while held
+  for (int i = 1; i < argc; ++i)
+  {
+    if (strcmp( argv[i], "--ipf") == 0 && i + 1 < argc)
+      session.scheduler.setCyclesPerFrame( strtoul( argv[++i], NULL, 10));
+    else if (strcmp( argv[i], "--speed") == 0 && i + 1 < argc)
+      speed = strtoul( argv[++i], NULL, 10);
+    else if (strcmp( argv[i], "--vsync") == 0)
+      vsync = true;
+    else if (strcmp( argv[i], "--no-audio") == 0)
+      audio = false;
+    else if (strcmp( argv[i], "--quirks") == 0 && i + 1 < argc)
+      quirk_list = argv[++i];
+    else if (strcmp( argv[i], "--run-ahead") == 0 && i + 1 < argc)
+      session.run_ahead = strtoul( argv[++i], NULL, 10);
+    else if (strcmp( argv[i], "--gdb") == 0 && i + 1 < argc)
+      gdb = argv[++i];
+    else if (strcmp( argv[i], "--trace") == 0 && i + 1 < argc)
+      trace = argv[++i];
+    else if (strcmp( argv[i], "--seed") == 0 && i + 1 < argc)
+      seed = strtoul( argv[++i], NULL, 10);
+    else if (strcmp( argv[i], "--record") == 0 && i + 1 < argc)
+      record = argv[++i];
+    else
+      rom = argv[i];
+  }
+
+  if (rom == NULL || (gdb != NULL && trace != NULL))
+  {
+    printf( "usage: %s [--ipf cycles-per-frame] [--speed N] [--vsync] [--no-audio] [--quirks LIST]\n"
+            "       [--run-ahead N] [--gdb PORT|PATH] [--trace FILE] [--seed N] [--record LOG] ROM\n", argv[0]);
+    return 1;
+  }
+
+  // the quirks asked for, otherwise the ones in ROM.quirks
+  unsigned int quirks;
+  if (quirk_list != NULL ? !parseQuirks( quirk_list, quirks) : !romQuirks( rom, quirks))
+  {
+    printf( "Unknown quirk in %s\n", quirk_list != NULL ? quirk_list : (string( rom) + ".quirks").c_str());
+    return 1;
+  }
 
   // start up SDL and create window
-  if( !chip8_Gfx.init() )
+  if( !chip8_Gfx.init( vsync) )
   {
 	printf( "\nFailed to initialize render system!\n" );
   }
@@ -31,75 +331,115 @@ int main( int argc, char *argv[] )
   {
     // initialize Chip8 system 
     chip8_emu.initialize();
+    chip8_emu.setQuirks( quirks );
  
     // load game into memory
-    if ( !chip8_emu.loadGame( argv[1] )  )
+    if ( !chip8_emu.loadGame( rom )  )
     {
       printf( "\nFailed to load media!\n" );
     }
 
     else
     {		
-      // main loop flag
-	  bool quit = false;
-
 	  // event handler
 	  SDL_Event e;
 
-      // start background music
-      Mix_PlayMusic( chip8_Gfx.bgMusic, -1);
+      // the buzzer follows the sound timer, without audio the emulator
+      // runs silent
+      if (audio)
+        session.beeper.open();
+
+      // a recorded run has to be replayable: fixed seed, no jumps in time
+      session.rom = rom;
+      session.record = record;
+      chip8_emu.seedRandom( seed );
+      session.frame_hash = chip8_emu.hashState();
+      session.input_log.begin( seed, session.scheduler.cyclesPerFrame(), session.frame_hash, quirks );
+
+#ifdef CHIP8_PROFILE
+      // profiling build: the report goes next to the ROM on exit
+      Profiler profiler;
+      chip8_emu.setProfiler( &profiler );
+      chip8_Gfx.setProfiler( &profiler );
+#endif
+
+      // a number is a TCP port on localhost, anything else a socket path
+      if (gdb != NULL)
+      {
+        char *end;
+        unsigned long port = strtoul( gdb, &end, 10);
+        if (*end == 0 ? session.gdb.listenTcp( port) : session.gdb.listenUnix( gdb))
+          printf( "Waiting for gdb on %s\n", gdb);
+      }
+
+      // every instruction from here on, until the window closes
+      if (trace != NULL)
+        session.trace.open( trace, chip8_emu );
+
+      // emulated time starts now, on its own thread
+      session.speed = speed;
+      session.scheduler.setSpeed( speed );
+      session.history.push( chip8_emu );
+      thread emulation( emulate, ref( session ) );
 
 	  //While application is running
-	  while( !quit )
+	  while( !session.quit )
       {
-          // emulate one cycle
-          chip8_emu.emulateCycle();
-
-          // if draw flag is set, update screen
-          if (chip8_emu.draw_flag)
-            chip8_Gfx.drawGfx( chip8_emu );
-
-		  //printf( "\nBefore handle events in queue...\n" );
-          // handle events in queue
-		  while( SDL_PollEvent( &e ) != 0 )
-		  {
-			  //User requests quit
-			  if ( e.type == SDL_QUIT )
-			  {
-				  quit = true;
-			  }
- 
-              else if ( e.type == SDL_KEYDOWN )
-              {
-                for (size_t i = 0; i < 16; ++i) 
-                {
-                  if ( e.key.keysym.sym == chip8_Gfx.keymap[i] )
-                  {
-                    chip8_emu.key[i] = 1;
-                    //printf( "\nAfter handle SDL_KEYDOWN...\n" );
-                  }
-                }
-              }
-
-              else if ( e.type == SDL_KEYUP )
-              {
-                for (size_t i = 0; i < 16; ++i) 
-                {
-                  if ( e.key.keysym.sym == chip8_Gfx.keymap[i] )
-                    chip8_emu.key[i] = 0;
-                  //printf( "\nAfter handle SDL_KEYUP...\n" );
-                }
-              }               
-          //printf( "\nAfter handle events in queue...\n" );
-		  }
+          // sleep in the event queue until the next present is due, then
+          // handle everything that arrived
+          long long wait = display.untilNextFrame().count();
+          if ( SDL_WaitEventTimeout( &e, (int)((wait + 999999) / 1000000) ) != 0 )
+          {
+            handleEvent( e, session, chip8_Gfx, speed );
+            while( SDL_PollEvent( &e ) != 0 )
+              handleEvent( e, session, chip8_Gfx, speed );
+          }
 
+          // present the newest frame the emulation handed over, at most
+          // once per display frame
+          if ( display.framesDue() > 0 && session.handoff.take() )
+            chip8_Gfx.drawGfx( session.handoff.front() );
    	  }
 
+      // a stopped core would never see the quit flag
+      session.gdb.cancel();
+      emulation.join();
+      session.gdb.close();
+      if (session.trace.isOpen() && !session.trace.close())
+        printf( "Failed to write trace %s\n", trace );
+
+#ifdef CHIP8_PROFILE
+      chip8_Gfx.setProfiler( NULL );
+      string report_path = string( rom ) + ".profile";
+      string folded_path = string( rom ) + ".folded";
+      FILE *report = fopen( report_path.c_str(), "w" );
+      FILE *folded = fopen( folded_path.c_str(), "w" );
+      if (report != NULL)
+      {
+        profiler.report( report, chip8_emu );
+        fclose( report );
+      }
+      if (folded != NULL)
+      {
+        profiler.writeCollapsed( folded, chip8_emu );
+        fclose( folded );
+      }
+      chip8_emu.setProfiler( NULL );
+#endif
+
+      if (record != NULL)
+      {
+        session.input_log.finish( session.frame_hash );
+        if ( !session.input_log.save( record ) )
+          printf( "\nFailed to write the input log!\n" );
+      }
+
     }
 
   }
 
   // free resources and close SDL
+  session.beeper.close();
   chip8_Gfx.close();
 
   return 0;
@@ -0,0 +1,145 @@
+/**
+ * @brief  CHIP8 EMULATOR PROJECT
+ * @Author esantiago
+ * @date   October, 2026
+ *
+ * @description: Headless profiler driver
+ *
+ * Runs one ROM with the execution profiler attached, either with
+ * scripted key presses or with the input of a recorded log (so the
+ * profile covers a real play session), then prints the hotspot report
+ * and optionally writes the collapsed call stacks for a flame graph.
+ * Built with -DCHIP8_PROFILE by 'make profile'.
+ *
+ * usage: profile_Chip8 [-m switch|table] [-f frames] [-i cycles-per-frame]
+ *                      [-r input.log] [-t top] [-o stacks.folded] ROM
+ */
+
+#include <cstddef>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Chip8.h"
+#include "InputLog.h"
+#include "Profiler.h"
+
+using namespace std;
+
+
+static void usage( const char *prog)
+{
+  printf( "usage: %s [-m switch|table] [-f frames] [-i cycles-per-frame]\n"
+          "       [-r input.log] [-t top] [-o stacks.folded] ROM\n", prog);
+}
+
+
+int main( int argc, char *argv[] )
+{
+  Chip8::ExecMode mode = Chip8::EXEC_SWITCH;
+  unsigned int frames = 36000; // ten minutes of play
+  unsigned int cycles_per_frame = 10;
+  size_t top = 20;
+  const char *log_path = NULL;
+  const char *folded_path = NULL;
+  const char *rom = NULL;
+
+  for (int i = 1; i < argc; ++i)
+  {
+    if (strcmp( argv[i], "-f") == 0 && i + 1 < argc)
+      frames = strtoul( argv[++i], NULL, 10);
+    else if (strcmp( argv[i], "-i") == 0 && i + 1 < argc)
+      cycles_per_frame = strtoul( argv[++i], NULL, 10);
+    else if (strcmp( argv[i], "-t") == 0 && i + 1 < argc)
+      top = strtoul( argv[++i], NULL, 10);
+    else if (strcmp( argv[i], "-r") == 0 && i + 1 < argc)
+      log_path = argv[++i];
+    else if (strcmp( argv[i], "-o") == 0 && i + 1 < argc)
+      folded_path = argv[++i];
+    else if (strcmp( argv[i], "-m") == 0 && i + 1 < argc)
+    {
+      ++i;
+      if (strcmp( argv[i], "switch") == 0)
+        mode = Chip8::EXEC_SWITCH;
+      else if (strcmp( argv[i], "table") == 0)
+        mode = Chip8::EXEC_TABLE;
+      else
+      {
+        usage( argv[0]);
+        return 1;
+      }
+    }
+    else if (argv[i][0] == '-' || rom != NULL)
+    {
+      usage( argv[0]);
+      return 1;
+    }
+    else
+      rom = argv[i];
+  }
+
+  if (rom == NULL)
+  {
+    usage( argv[0]);
+    return 1;
+  }
+
+  InputLog log;
+  if (log_path != NULL)
+  {
+    if (!log.load( log_path))
+    {
+      printf( "Unable to read %s\n", log_path);
+      return 1;
+    }
+    frames = log.frames();
+    cycles_per_frame = log.cyclesPerFrame();
+  }
+
+  Chip8 *chip8_emu = new Chip8;
+  Profiler *profiler = new Profiler;
+
+  chip8_emu->initialize();
+  chip8_emu->setExecMode( mode);
+  chip8_emu->setQuirks( log.quirks());
+  if (!chip8_emu->loadGame( rom))
+    return 1;
+  chip8_emu->seedRandom( log_path != NULL ? log.seed() : 1);
+  chip8_emu->setProfiler( profiler);
+
+  for (unsigned int frame = 0; frame < frames; ++frame)
+  {
+    if (log_path != NULL)
+      log.keysAt( frame, chip8_emu->key);
+    else if (frame % 30 == 0)
+    {
+      for (size_t k = 0; k < 16; ++k)
+        chip8_emu->key[k] = ((frame / 30) * 7 + k) % 5 == 0;
+    }
+    chip8_emu->runFrame( cycles_per_frame);
+  }
+
+  printf( "%s: %u frames of %u instructions\n", rom, frames, cycles_per_frame);
+  profiler->report( stdout, *chip8_emu, top);
+
+  int status = 0;
+  if (folded_path != NULL)
+  {
+    FILE *folded = fopen( folded_path, "w");
+    if (folded == NULL)
+    {
+      printf( "Unable to open %s\n", folded_path);
+      status = 1;
+    }
+    else
+    {
+      profiler->writeCollapsed( folded, *chip8_emu);
+      fclose( folded);
+    }
+  }
+
+  chip8_emu->setProfiler( NULL);
+  delete profiler;
+  delete chip8_emu;
+  return status;
+
+}
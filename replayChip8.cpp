@@ -0,0 +1,188 @@
+/**
+ * @brief  CHIP8 EMULATOR PROJECT
+ * @Author esantiago
+ * @date   October, 2026
+ *
+ * @description: Headless replay of recorded input logs
+ *
+ * Replays input logs (recorded with testing_Chip8 --record) against a ROM
+ * as fast as the core runs, hashing the machine state after every frame
+ * into a rolling hash. A replay passes when it starts from the recorded
+ * state hash and ends on the recorded rolling hash. Many logs replay in
+ * parallel on the thread pool; -o writes the hash of every frame of a
+ * single log so two runs can be diffed down to the first bad frame.
+ *
+ * usage: replay_Chip8 [-j threads] [-m switch|table|block|jit|aot] [-o hashes.txt] ROM LOG ...
+ */
+
+#include <cstddef>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <chrono>
+#include "Chip8.h"
+#include "InputLog.h"
+#include "ThreadPool.h"
+
+using namespace std;
+
+
+struct ReplayResult
+{
+  string log;
+  const char *status; // NULL when the replay matched
+  unsigned int frames;
+  uint64_t hash;
+};
+
+
+static void usage( const char *prog)
+{
+  printf( "usage: %s [-j threads] [-m switch|table|block|jit|aot] [-o hashes.txt] ROM LOG ...\n", prog);
+}
+
+
+static void replay( ReplayResult &result, const char *rom, Chip8::ExecMode mode, FILE *hashes)
+{
+  InputLog log;
+  Chip8 chip8_emu;
+
+  result.frames = 0;
+  result.hash = 0;
+
+  if (!log.load( result.log.c_str()))
+  {
+    result.status = "BAD LOG";
+    return;
+  }
+
+  chip8_emu.initialize();
+  chip8_emu.setExecMode( mode);
+  chip8_emu.setQuirks( log.quirks());
+  if (!chip8_emu.loadGame( rom))
+  {
+    result.status = "FAILED TO LOAD";
+    return;
+  }
+  chip8_emu.seedRandom( log.seed());
+
+  uint64_t hash = chip8_emu.hashState();
+  if (hash != log.startHash())
+  {
+    result.status = "WRONG ROM";
+    return;
+  }
+
+  for (unsigned int frame = 0; frame < log.frames(); ++frame)
+  {
+    log.keysAt( frame, chip8_emu.key);
+    chip8_emu.runFrame( log.cyclesPerFrame());
+    hash = chip8_emu.hashState( hash);
+    if (hashes != NULL)
+      fprintf( hashes, "%u %016llx\n", frame, (unsigned long long)hash);
+  }
+
+  result.frames = log.frames();
+  result.hash = hash;
+  result.status = hash == log.endHash() ? NULL : "MISMATCH";
+}
+
+
+int main( int argc, char *argv[] )
+{
+  size_t threads = 0;
+  Chip8::ExecMode mode = Chip8::EXEC_JIT;
+  const char *hash_path = NULL;
+  const char *rom = NULL;
+  vector<ReplayResult> results;
+
+  for (int i = 1; i < argc; ++i)
+  {
+    if (strcmp( argv[i], "-j") == 0 && i + 1 < argc)
+      threads = strtoul( argv[++i], NULL, 10);
+    else if (strcmp( argv[i], "-o") == 0 && i + 1 < argc)
+      hash_path = argv[++i];
+    else if (strcmp( argv[i], "-m") == 0 && i + 1 < argc)
+    {
+      ++i;
+      if (strcmp( argv[i], "switch") == 0)
+        mode = Chip8::EXEC_SWITCH;
+      else if (strcmp( argv[i], "table") == 0)
+        mode = Chip8::EXEC_TABLE;
+      else if (strcmp( argv[i], "block") == 0)
+        mode = Chip8::EXEC_BLOCK;
+      else if (strcmp( argv[i], "jit") == 0)
+        mode = Chip8::EXEC_JIT;
+      else if (strcmp( argv[i], "aot") == 0)
+        mode = Chip8::EXEC_AOT;
+      else
+      {
+        usage( argv[0]);
+        return 1;
+      }
+    }
+    else if (argv[i][0] == '-')
+    {
+      usage( argv[0]);
+      return 1;
+    }
+    else if (rom == NULL)
+      rom = argv[i];
+    else
+    {
+      results.push_back( ReplayResult());
+      results.back().log = argv[i];
+    }
+  }
+
+  if (rom == NULL || results.empty() || (hash_path != NULL && results.size() != 1))
+  {
+    usage( argv[0]);
+    return 1;
+  }
+
+  FILE *hashes = NULL;
+  if (hash_path != NULL && (hashes = fopen( hash_path, "w")) == NULL)
+  {
+    printf( "Unable to open %s\n", hash_path);
+    return 1;
+  }
+
+  chrono::steady_clock::time_point start = chrono::steady_clock::now();
+  {
+    ThreadPool pool( threads);
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+      ReplayResult *slot = &results[i];
+      pool.submit( [slot, rom, mode, hashes]() { replay( *slot, rom, mode, hashes); });
+    }
+    pool.wait();
+  }
+  chrono::duration<double> wall = chrono::steady_clock::now() - start;
+
+  if (hashes != NULL)
+    fclose( hashes);
+
+  unsigned long long frames = 0;
+  size_t failed = 0;
+  for (size_t i = 0; i < results.size(); ++i)
+  {
+    const ReplayResult &r = results[i];
+    if (r.status != NULL)
+      ++failed;
+    if (r.status == NULL || r.frames > 0)
+      printf( "%-24s %-8s %8u frames %016llx\n", r.log.c_str(), r.status != NULL ? r.status : "OK",
+              r.frames, (unsigned long long)r.hash);
+    else
+      printf( "%-24s %s\n", r.log.c_str(), r.status);
+    frames += r.frames;
+  }
+
+  printf( "\n%zu replays, %zu failed, %llu frames in %.3f s: %.0f frames/s\n", results.size(), failed,
+          frames, wall.count(), wall.count() > 0 ? frames / wall.count() : 0.0);
+
+  return failed == 0 ? 0 : 1;
+
+}
@@ -0,0 +1,181 @@
+/**
+ * @brief  CHIP8 EMULATOR PROJECT
+ * @Author esantiago
+ * @date   October, 2026
+ *
+ * @description: Driver for the structure-of-arrays batch engine
+ *
+ * Runs many lanes of each ROM through BatchEngine on one thread, with
+ * lane i seeded with i + 1 and a key pattern of its own so the lanes
+ * drift apart, and reports the aggregate instructions per second and
+ * how many of them ran in SSE2 passes. With -v the same lanes also run
+ * as separate Chip8 instances through the reference switch, and every
+ * lane is compared with its instance after every frame.
+ *
+ * usage: soa_Chip8 [-n lanes] [-c cycles] [-f cycles-per-frame] [-v] ROM|DIR ...
+ */
+
+#include <cstddef>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <chrono>
+#include "BatchEngine.h"
+#include "Chip8.h"
+#include "RomCache.h"
+#include "RomFiles.h"
+
+using namespace std;
+
+
+static void usage( const char *prog)
+{
+  printf( "usage: %s [-n lanes] [-c cycles] [-f cycles-per-frame] [-v] ROM|DIR ...\n", prog);
+}
+
+
+// a different key pattern per lane, changing every 30 frames
+static bool keyHeld( size_t lane, unsigned long long frame, size_t k)
+{
+  return ((frame / 30) * 7 + lane * 3 + k) % 5 == 0;
+}
+
+
+// returns false when the ROM does not load or a lane diverged
+static bool runRom( const char *rom, size_t lanes, unsigned long long cycles, unsigned int per_frame,
+                    bool verify)
+{
+  const RomImage *image = RomCache::instance().load( rom);
+  BatchEngine engine( lanes);
+  if (image == NULL || !engine.loadProgram( image->data, image->size))
+  {
+    printf( "%-24s FAILED TO LOAD\n", rom);
+    return false;
+  }
+
+  vector<Chip8 *> reference;
+  Chip8 *exported = NULL;
+  if (verify)
+  {
+    exported = new Chip8;
+    for (size_t l = 0; l < lanes; ++l)
+    {
+      reference.push_back( new Chip8);
+      reference[l]->initialize();
+      reference[l]->loadProgram( image->data, image->size);
+      reference[l]->seedRandom( l + 1);
+    }
+  }
+
+  chrono::duration<double> engine_time( 0), reference_time( 0);
+  const char *diverged = NULL;
+  size_t diverged_lane = 0;
+  unsigned long long done = 0;
+
+  for (unsigned long long frame = 0; done < cycles && diverged == NULL; ++frame)
+  {
+    unsigned int length = cycles - done < per_frame ? cycles - done : per_frame;
+
+    for (size_t l = 0; l < lanes; ++l)
+    {
+      unsigned char *keys = engine.keys( l);
+      for (size_t k = 0; k < 16; ++k)
+        keys[k] = keyHeld( l, frame, k);
+    }
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    engine.runFrame( length);
+    engine_time += chrono::steady_clock::now() - start;
+    done += length;
+
+    if (!verify)
+      continue;
+
+    start = chrono::steady_clock::now();
+    for (size_t l = 0; l < lanes; ++l)
+    {
+      for (size_t k = 0; k < 16; ++k)
+        reference[l]->key[k] = keyHeld( l, frame, k);
+      reference[l]->runFrame( length);
+    }
+    reference_time += chrono::steady_clock::now() - start;
+
+    for (size_t l = 0; l < lanes && diverged == NULL; ++l)
+    {
+      engine.exportLane( l, *exported);
+      diverged = exported->diffState( *reference[l]);
+      diverged_lane = l;
+    }
+  }
+
+  unsigned long long total = done * lanes;
+  unsigned long long vector = engine.vectorInstructions();
+  printf( "%-24s %6zu lanes %12llu instructions %8.3f s %12.0f IPS, %5.1f%% in SSE2 passes\n", rom, lanes,
+          total, engine_time.count(), engine_time.count() > 0 ? total / engine_time.count() : 0.0,
+          total > 0 ? 100.0 * vector / total : 0.0);
+
+  if (verify)
+  {
+    if (diverged != NULL)
+      printf( "%-24s lane %zu diverged from its Chip8 (%s) by instruction %llu\n", rom, diverged_lane,
+              diverged, done);
+    else
+      printf( "%-24s %6zu Chip8s %12llu instructions %8.3f s %12.0f IPS, identical\n", rom, lanes, total,
+              reference_time.count(), reference_time.count() > 0 ? total / reference_time.count() : 0.0);
+
+    for (size_t l = 0; l < reference.size(); ++l)
+      delete reference[l];
+    delete exported;
+  }
+
+  return diverged == NULL;
+
+}
+
+
+int main( int argc, char *argv[] )
+{
+  size_t lanes = 1024;
+  unsigned long long cycles = 100000;
+  unsigned int per_frame = 10;
+  bool verify = false;
+  vector<string> roms;
+
+  for (int i = 1; i < argc; ++i)
+  {
+    if (strcmp( argv[i], "-n") == 0 && i + 1 < argc)
+      lanes = strtoul( argv[++i], NULL, 10);
+    else if (strcmp( argv[i], "-c") == 0 && i + 1 < argc)
+      cycles = strtoull( argv[++i], NULL, 10);
+    else if (strcmp( argv[i], "-f") == 0 && i + 1 < argc)
+      per_frame = strtoul( argv[++i], NULL, 10);
+    else if (strcmp( argv[i], "-v") == 0)
+      verify = true;
+    else if (argv[i][0] == '-')
+    {
+      usage( argv[0]);
+      return 1;
+    }
+    else
+      collectRoms( argv[i], roms);
+  }
+
+  if (roms.empty() || lanes == 0 || per_frame == 0)
+  {
+    usage( argv[0]);
+    return 1;
+  }
+
+  size_t failed = 0;
+  for (size_t i = 0; i < roms.size(); ++i)
+  {
+    if (!runRom( roms[i].c_str(), lanes, cycles, per_frame, verify))
+      ++failed;
+  }
+
+  printf( "\n%zu ROMs, %zu failed\n", roms.size(), failed);
+  return failed == 0 ? 0 : 1;
+
+}
@@ -8,7 +8,9 @@
 
 
 #include <cstddef>
-#include "Chip8.h"
+#include <stdio.h>
+#include <vector>
+#include "Disassembler.h"
 
 using namespace std;
 
@@ -16,9 +18,21 @@ using namespace std;
 int main( int argc, char *argv[] )
 {  
 
-  Chip8 chip8_emu;
+  if (argc < 2)
+    return 1;
 
-  chip8_emu.disassembler( argv[1] );
+  FILE *file = fopen( argv[1], "rb");
+  if (file == NULL)
+    return 1;
+
+  vector<unsigned char> program( 4096 - 512);
+  program.resize( fread( &program[0], 1, program.size(), file));
+  fclose( file);
+  if (program.empty())
+    return 1;
+
+  Disassembler disassembler;
+  fputs( disassembler.run( &program[0], program.size()).c_str(), stdout);
 
   return 0;  
   
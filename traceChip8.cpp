@@ -0,0 +1,356 @@
+/**
+ * @brief  CHIP8 EMULATOR PROJECT
+ * @Author esantiago
+ * @date   October, 2026
+ *
+ * @description: Execution trace recorder, filter and diff tool
+ *
+ * -w records a trace of a ROM run headless for a number of frames, with
+ * no keys held. The recorder steps the core one instruction at a time,
+ * so -m only chooses between the switch and table interpreters. Given
+ * one trace, prints its instructions as text, one per line, optionally
+ * only the ones in a pc range (-p), in a frame range (-F) or matching an
+ * opcode pattern (-x, hex digits with ? for any, e.g. D??? or F?55). -d compares two traces and prints the first
+ * instruction where they part, after the few (-c) leading up to it.
+ *
+ * usage: trace_Chip8 -w OUT [-n frames] [-f cycles-per-frame] [-m switch|table] [-s seed] ROM
+ *        trace_Chip8 [-p lo-hi] [-F first-last] [-x pattern] TRACE
+ *        trace_Chip8 -d [-c context] TRACE TRACE
+ */
+
+#include <cstddef>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <deque>
+#include <chrono>
+#include "Chip8.h"
+#include "Disasm.h"
+#include "Trace.h"
+
+using namespace std;
+
+
+static void usage( const char *prog)
+{
+  printf( "usage: %s -w OUT [-n frames] [-f cycles-per-frame] [-m switch|table] [-s seed] ROM\n"
+          "       %s [-p lo-hi] [-F first-last] [-x pattern] TRACE\n"
+          "       %s -d [-c context] TRACE TRACE\n", prog, prog, prog);
+}
+
+
+static const char *REGISTER_NAMES[TraceState::REGISTERS] =
+{
+  "V0", "V1", "V2", "V3", "V4", "V5", "V6", "V7",
+  "V8", "V9", "VA", "VB", "VC", "VD", "VE", "VF",
+  "I", "SP", "DT", "ST", "KEYS"
+};
+
+
+// "lo-hi" or a single value, in 'base'
+static bool parseRange( const char *text, int base, unsigned long long &lo, unsigned long long &hi)
+{
+  char *end;
+  lo = strtoull( text, &end, base);
+  if (end == text)
+    return false;
+  hi = lo;
+  if (*end == '-')
+  {
+    const char *from = end + 1;
+    hi = strtoull( from, &end, base);
+    if (end == from)
+      return false;
+  }
+  return *end == 0 && lo <= hi;
+}
+
+
+// four hex digits or ?, into a mask and the value under it
+static bool parsePattern( const char *text, unsigned short &mask, unsigned short &value)
+{
+  if (strlen( text) != 4)
+    return false;
+  mask = 0;
+  value = 0;
+  for (int i = 0; i < 4; ++i)
+  {
+    char c = text[i];
+    unsigned int digit;
+    mask <<= 4;
+    value <<= 4;
+    if (c == '?')
+      continue;
+    if (c >= '0' && c <= '9')
+      digit = c - '0';
+    else if (c >= 'a' && c <= 'f')
+      digit = c - 'a' + 10;
+    else if (c >= 'A' && c <= 'F')
+      digit = c - 'A' + 10;
+    else
+      return false;
+    mask |= 0xF;
+    value |= digit;
+  }
+  return true;
+}
+
+
+static void printRecord( const char *prefix, const TraceRecord &record)
+{
+  char text[32];
+  printf( "%s%6llu %9llu  %03X  %04X  %-16s", prefix, record.frame, record.index, record.pc,
+          record.opcode, disassemble( record.opcode, text, sizeof(text)));
+
+  for (unsigned int r = 0; r < TraceState::REGISTERS; ++r)
+  {
+    if (record.changed & (1u << r))
+      printf( " %s=%0*X", REGISTER_NAMES[r], (int)TraceState::size( r) * 2, record.after.regs[r]);
+  }
+  if (record.write_count != 0)
+  {
+    printf( " [%03X]=", record.write_address);
+    for (unsigned int b = 0; b < record.write_count; ++b)
+      printf( "%02X", record.written[b]);
+  }
+  if (record.collision)
+    printf( " collision");
+  printf( "\n");
+}
+
+
+static bool sameRecord( const TraceRecord &a, const TraceRecord &b)
+{
+  return a.pc == b.pc && a.opcode == b.opcode && a.changed == b.changed &&
+         memcmp( a.after.regs, b.after.regs, sizeof(a.after.regs)) == 0 &&
+         a.write_address == b.write_address && a.write_count == b.write_count &&
+         memcmp( a.written, b.written, a.write_count) == 0 && a.collision == b.collision;
+}
+
+
+static int record( const char *out, const char *rom, unsigned long long frames, unsigned int per_frame,
+                   Chip8::ExecMode mode, uint32_t seed)
+{
+  Chip8 chip8;
+  chip8.initialize();
+  chip8.seedRandom( seed);
+  chip8.setExecMode( mode);
+  if (!chip8.loadGame( rom))
+  {
+    printf( "%s FAILED TO LOAD\n", rom);
+    return 1;
+  }
+
+  TraceRecorder trace;
+  if (!trace.open( out, chip8))
+    return 1;
+
+  chrono::steady_clock::time_point start = chrono::steady_clock::now();
+  for (unsigned long long f = 0; f < frames; ++f)
+    chip8.runFrame( per_frame);
+  bool written = trace.close();
+  double seconds = chrono::duration<double>( chrono::steady_clock::now() - start).count();
+
+  if (!written)
+  {
+    printf( "%s: failed writing %s\n", rom, out);
+    return 1;
+  }
+
+  FILE *file = fopen( out, "rb");
+  long size = 0;
+  if (file != NULL)
+  {
+    fseek( file, 0, SEEK_END);
+    size = ftell( file);
+    fclose( file);
+  }
+
+  printf( "%s: %llu instructions, %llu bytes raw, %ld compressed (%.2f per instruction), %.1fM instr/s\n",
+          rom, trace.records(), trace.rawBytes(), size,
+          trace.records() > 0 ? (double)size / trace.records() : 0.0,
+          seconds > 0 ? trace.records() / seconds / 1e6 : 0.0);
+  return 0;
+
+}
+
+
+static int print( const char *path, unsigned long long pc_lo, unsigned long long pc_hi,
+                  unsigned long long frame_lo, unsigned long long frame_hi,
+                  unsigned short mask, unsigned short value)
+{
+  TraceReader reader;
+  if (!reader.open( path))
+  {
+    printf( "%s: %s\n", path, reader.error());
+    return 1;
+  }
+
+  TraceRecord record;
+  while (reader.next( record))
+  {
+    if (record.frame > frame_hi)
+      break;
+    if (record.frame < frame_lo || record.pc < pc_lo || record.pc > pc_hi ||
+        (record.opcode & mask) != value)
+      continue;
+    printRecord( "", record);
+  }
+
+  if (reader.error() != NULL)
+  {
+    printf( "%s: %s\n", path, reader.error());
+    return 1;
+  }
+  return 0;
+
+}
+
+
+static int diff( const char *path_a, const char *path_b, size_t context)
+{
+  TraceReader a, b;
+  if (!a.open( path_a))
+  {
+    printf( "%s: %s\n", path_a, a.error());
+    return 1;
+  }
+  if (!b.open( path_b))
+  {
+    printf( "%s: %s\n", path_b, b.error());
+    return 1;
+  }
+
+  // the instructions both ran, the last few kept to show the way in
+  deque<TraceRecord> before;
+  TraceRecord ra, rb;
+  unsigned long long compared = 0;
+  for (;;)
+  {
+    bool more_a = a.next( ra);
+    bool more_b = b.next( rb);
+    if (a.error() != NULL || b.error() != NULL)
+    {
+      printf( "%s: %s\n", a.error() != NULL ? path_a : path_b,
+              a.error() != NULL ? a.error() : b.error());
+      return 1;
+    }
+
+    if (!more_a && !more_b)
+    {
+      printf( "identical, %llu instructions\n", compared);
+      return 0;
+    }
+
+    if (more_a && more_b && ra.frame == rb.frame && sameRecord( ra, rb))
+    {
+      before.push_back( ra);
+      if (before.size() > context)
+        before.pop_front();
+      ++compared;
+      continue;
+    }
+
+    printf( "traces part after %llu instructions\n", compared);
+    for (size_t i = 0; i < before.size(); ++i)
+      printRecord( "  ", before[i]);
+    if (more_a)
+      printRecord( "< ", ra);
+    else
+      printf( "< end of %s\n", path_a);
+    if (more_b)
+      printRecord( "> ", rb);
+    else
+      printf( "> end of %s\n", path_b);
+    return 2;
+  }
+
+}
+
+
+int main( int argc, char *argv[] )
+{
+  const char *out = NULL;
+  unsigned long long frames = 600;
+  unsigned int per_frame = 10;
+  Chip8::ExecMode mode = Chip8::EXEC_SWITCH;
+  uint32_t seed = 1;
+  bool compare = false;
+  size_t context = 5;
+  unsigned long long pc_lo = 0, pc_hi = 0xFFFF;
+  unsigned long long frame_lo = 0, frame_hi = ~0ULL;
+  unsigned short mask = 0, value = 0;
+  const char *files[2] = { NULL, NULL };
+  int file_count = 0;
+
+  for (int i = 1; i < argc; ++i)
+  {
+    if (strcmp( argv[i], "-w") == 0 && i + 1 < argc)
+      out = argv[++i];
+    else if (strcmp( argv[i], "-n") == 0 && i + 1 < argc)
+      frames = strtoull( argv[++i], NULL, 10);
+    else if (strcmp( argv[i], "-f") == 0 && i + 1 < argc)
+      per_frame = strtoul( argv[++i], NULL, 10);
+    else if (strcmp( argv[i], "-s") == 0 && i + 1 < argc)
+      seed = strtoul( argv[++i], NULL, 10);
+    else if (strcmp( argv[i], "-d") == 0)
+      compare = true;
+    else if (strcmp( argv[i], "-c") == 0 && i + 1 < argc)
+      context = strtoul( argv[++i], NULL, 10);
+    else if (strcmp( argv[i], "-m") == 0 && i + 1 < argc)
+    {
+      const char *name = argv[++i];
+      if (strcmp( name, "switch") == 0)
+        mode = Chip8::EXEC_SWITCH;
+      else if (strcmp( name, "table") == 0)
+        mode = Chip8::EXEC_TABLE;
+      else
+      {
+        usage( argv[0]);
+        return 1;
+      }
+    }
+    else if (strcmp( argv[i], "-p") == 0 && i + 1 < argc)
+    {
+      if (!parseRange( argv[++i], 16, pc_lo, pc_hi))
+      {
+        usage( argv[0]);
+        return 1;
+      }
+    }
+    else if (strcmp( argv[i], "-F") == 0 && i + 1 < argc)
+    {
+      if (!parseRange( argv[++i], 10, frame_lo, frame_hi))
+      {
+        usage( argv[0]);
+        return 1;
+      }
+    }
+    else if (strcmp( argv[i], "-x") == 0 && i + 1 < argc)
+    {
+      if (!parsePattern( argv[++i], mask, value))
+      {
+        usage( argv[0]);
+        return 1;
+      }
+    }
+    else if (argv[i][0] == '-' || file_count == 2)
+    {
+      usage( argv[0]);
+      return 1;
+    }
+    else
+      files[file_count++] = argv[i];
+  }
+
+  if (out != NULL && file_count == 1 && !compare)
+    return record( out, files[0], frames, per_frame, mode, seed);
+  if (compare && out == NULL && file_count == 2)
+    return diff( files[0], files[1], context);
+  if (!compare && out == NULL && file_count == 1)
+    return print( files[0], pc_lo, pc_hi, frame_lo, frame_hi, mask, value);
+
+  usage( argv[0]);
+  return 1;
+
+}